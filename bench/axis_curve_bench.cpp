@@ -0,0 +1,101 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_curve_bench.cpp                                                       *
+ *                                                                            *
+ * Benchmarks lookup table axis curves against direct evaluation              *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "axis_curve.h"
+#include "bench.h"
+
+// samples timed per curve
+static const uint64_t SAMPLES = 10000000;
+// distinct axis positions cycled through, a power of two
+static const size_t POSITIONS = 4096;
+// points compared when measuring accuracy
+static const int ACCURACY_POINTS = 1000000;
+
+// reports the accuracy and cost of one configured curve
+static void runCurve(const std::string &name, AxisCurve::Range range,
+                     const std::string &settings)
+{
+    AxisCurve curve(range);
+    Profile profile;
+    std::string error;
+    if (!Profile::parse(settings, profile, error) ||
+        !curve.configure(profile, "test", error))
+    {
+        std::cerr << "axis curve " << name << ": " << error << std::endl;
+        return;
+    }
+
+    // largest difference between the table and direct evaluation
+    double low = range == AxisCurve::Range::Bipolar ? -1.0 : 0.0;
+    double maxError = 0.0;
+    for (int i = 0; i <= ACCURACY_POINTS; i++)
+    {
+        double x = low + (1.0 - low) * i / ACCURACY_POINTS;
+        double difference = std::fabs(curve.apply(x) - curve.evaluate(x));
+        maxError = difference > maxError ? difference : maxError;
+    }
+
+    std::vector<double> positions(POSITIONS);
+    uint32_t seed = 7;
+    for (double &position : positions)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        position = low + (1.0 - low) * ((seed >> 8) & 0xffff) / 65535.0;
+    }
+    double sink = 0.0;
+    double directNs = Bench::measure(
+        SAMPLES,
+        [&](uint64_t i)
+        { sink += curve.evaluate(positions[i & (POSITIONS - 1)]); });
+    double tableNs = Bench::measure(
+        SAMPLES,
+        [&](uint64_t i)
+        { sink += curve.apply(positions[i & (POSITIONS - 1)]); });
+    keep(sink);
+
+    std::string prefix = "axis_curve/" + name;
+    Bench::report(prefix + "/direct", directNs, "ns");
+    Bench::report(prefix + "/table", tableNs, "ns");
+    Bench::report(prefix + "/max_error", maxError * 1e6, "ppm");
+}
+
+// benchmarks lookup table axis curves against direct evaluation
+void benchAxisCurve()
+{
+    runCurve("identity", AxisCurve::Range::Bipolar, "");
+    runCurve("steering_gamma", AxisCurve::Range::Bipolar,
+             "axis.test.inner_deadzone = 0.02\n"
+             "axis.test.outer_deadzone = 0.01\n"
+             "axis.test.gamma = 1.7\n");
+    runCurve("pedal_spline", AxisCurve::Range::Unipolar,
+             "axis.test.inner_deadzone = 0.05\n"
+             "axis.test.curve = 0:0 0.3:0.1 0.7:0.6 1:1\n"
+             "axis.test.invert = true\n"
+             "axis.test.max = 0.9\n");
+}
@@ -0,0 +1,105 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_filter_bench.cpp                                                      *
+ *                                                                            *
+ * Benchmarks the cost of filtering each axis of a reading                     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+
+#include <string>
+#include <vector>
+
+#include "axis_filter.h"
+#include "bench.h"
+
+// samples timed per filter
+static const uint64_t SAMPLES = 10000000;
+// distinct readings cycled through, a power of two
+static const size_t READINGS = 4096;
+// wheels filtered one after another, as a shared poll thread would
+static const int WHEELS = 8;
+
+// reports the cost of filtering every axis of one reading through filter
+static void runFilter(const std::string &name, const AxisFilter &filter)
+{
+    const int lanes = AxisFilterBank::LANES;
+    std::vector<double> readings(READINGS * lanes);
+    uint32_t seed = 7;
+    for (size_t i = 0; i < READINGS * lanes; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        readings[i] = ((seed >> 8) & 0xffff) / 65535.0;
+    }
+    const AxisFilter *const configured[lanes] = {&filter, &filter, &filter,
+                                                 nullptr};
+    std::vector<AxisFilterBank> banks(WHEELS);
+    for (AxisFilterBank &bank : banks)
+    {
+        bank.configure(configured, 1000);
+    }
+    double sink = 0.0;
+    double ns = Bench::measure(
+        SAMPLES,
+        [&](uint64_t i)
+        {
+            double values[lanes];
+            const double *reading =
+                &readings[(i & (READINGS - 1)) * lanes];
+            for (int lane = 0; lane < lanes; lane++)
+            {
+                values[lane] = reading[lane];
+            }
+            AxisFilterBank &bank = banks[i % WHEELS];
+            if (bank.enabled())
+            {
+                bank.process(values);
+            }
+            sink += values[0];
+        });
+    keep(sink);
+    Bench::report("axis_filter/" + name, ns, "ns");
+}
+
+// benchmarks the cost of filtering each axis of a reading
+void benchAxisFilter()
+{
+    AxisFilter none;
+    AxisFilter euro;
+    euro.minCutoff = 1.0;
+    euro.beta = 0.5;
+    AxisFilter lowPass;
+    lowPass.lowPassHz = 60.0;
+    AxisFilter slew;
+    slew.slewRate = 20.0;
+    AxisFilter quantise;
+    quantise.quantise = 0.005;
+    quantise.hysteresis = 0.002;
+    AxisFilter chain = euro;
+    chain.lowPassHz = lowPass.lowPassHz;
+    chain.slewRate = slew.slewRate;
+    chain.quantise = quantise.quantise;
+    chain.hysteresis = quantise.hysteresis;
+    runFilter("none", none);
+    runFilter("one_euro", euro);
+    runFilter("low_pass", lowPass);
+    runFilter("slew_limit", slew);
+    runFilter("quantise", quantise);
+    runFilter("chain", chain);
+}
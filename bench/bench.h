@@ -0,0 +1,128 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * bench.h                                                                    *
+ *                                                                            *
+ * Timing and reporting helpers for the benchmark suite                       *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class Bench
+{
+  private:
+    // one reported value
+    struct Result
+    {
+        std::string name;
+        double value;
+        std::string unit;
+    };
+
+    static std::vector<Result> results;
+    static int failures;
+
+  public:
+    // returns the mean time in nanoseconds of each call to fn
+    template <typename Fn> static double measure(uint64_t iterations, Fn fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; i++)
+        {
+            fn(i);
+        }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() /
+               iterations;
+    }
+    // returns the cpu time used by the process in seconds
+    static double cpuSeconds();
+    // prints a single result
+    static void report(const std::string &name, double value,
+                       const std::string &unit);
+    // prints a result which missed its target, so the run fails
+    static void fail(const std::string &message);
+    // returns the number of results which missed their target
+    static int failed();
+    // writes every reported result to path as JSON, returns false on failure
+    static bool writeJson(const std::string &path);
+};
+
+// prevents the compiler discarding a value
+template <typename T> void keep(const T &value)
+{
+    static const volatile T *sink;
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+// benchmarks change detecting injection
+void benchInjection();
+// benchmarks deadline based pacing
+void benchPacer();
+// compares thread per wheel polling against a shared poll thread
+void benchExecutor();
+// benchmarks seqlock snapshot reads and writes under contention
+void benchSnapshot();
+// benchmarks button mapping against the previous chain of if statements
+void benchButtonMap();
+// benchmarks lookup table axis curves against direct evaluation
+void benchAxisCurve();
+// benchmarks the cost of filtering each axis of a reading
+void benchAxisFilter();
+// benchmarks the cost of recording a session
+void benchRecorder();
+// benchmarks the cost of timing each stage of a tick
+void benchLatency();
+// benchmarks drawing telemetry for several wheels
+void benchTelemetry();
+// benchmarks logging from many threads at once
+void benchLog();
+// benchmarks discovering wheels as they are connected
+void benchDiscovery();
+// benchmarks initialising several wheels at once
+void benchInit();
+// benchmarks starting wheels with injectors initialised in advance
+void benchInjectorPool();
+// benchmarks the cost of collecting and serving metrics
+void benchMetrics();
+// benchmarks computing and sending force feedback on each poll
+void benchForceFeedback();
+// benchmarks the time from a wheel's evdev event to the uinput gamepad
+// reporting it
+void benchEvdev();
+// benchmarks polling wheels at a lower rate while their input is unchanged
+void benchIdle();
+// benchmarks polling jitter under cpu load at each thread priority
+void benchPriority();
+// benchmarks how quickly polling and telemetry stop once asked
+void benchStop();
+// benchmarks merging several devices into one virtual gamepad
+void benchMerge();
+// benchmarks finding and applying cached device profiles
+void benchProfile();
+
+#endif
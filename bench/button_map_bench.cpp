@@ -0,0 +1,157 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * button_map_bench.cpp                                                       *
+ *                                                                            *
+ * Benchmarks button mapping against the previous chain of if statements      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "button_map.h"
+
+// mappings timed per implementation
+static const uint64_t MAPPINGS = 10000000;
+// distinct button states cycled through, a power of two
+static const size_t PATTERNS = 4096;
+
+// the mapping previously done in Wheel::run
+static uint32_t mapIfChain(uint32_t buttons)
+{
+    uint32_t mapped = PadButtons::None;
+    if (buttons & WheelButtons::DPadDown)
+    {
+        mapped |= PadButtons::DPadDown;
+    }
+    if (buttons & WheelButtons::DPadUp)
+    {
+        mapped |= PadButtons::DPadUp;
+    }
+    if (buttons & WheelButtons::DPadLeft)
+    {
+        mapped |= PadButtons::DPadLeft;
+    }
+    if (buttons & WheelButtons::DPadRight)
+    {
+        mapped |= PadButtons::DPadRight;
+    }
+    if (buttons & WheelButtons::NextGear)
+    {
+        mapped |= PadButtons::RightShoulder;
+    }
+    if (buttons & WheelButtons::PreviousGear)
+    {
+        mapped |= PadButtons::LeftShoulder;
+    }
+    if (buttons & WheelButtons::Button1)
+    {
+        mapped |= PadButtons::Menu;
+    }
+    if (buttons & WheelButtons::Button2)
+    {
+        mapped |= PadButtons::View;
+    }
+    if (buttons & WheelButtons::Button3)
+    {
+        mapped |= PadButtons::A;
+    }
+    if (buttons & WheelButtons::Button4)
+    {
+        mapped |= PadButtons::B;
+    }
+    if (buttons & WheelButtons::Button5)
+    {
+        mapped |= PadButtons::X;
+    }
+    if (buttons & WheelButtons::Button6)
+    {
+        mapped |= PadButtons::Y;
+    }
+    return mapped;
+}
+
+// benchmarks button mapping against the previous chain of if statements
+void benchButtonMap()
+{
+    // random presses defeat branch prediction as real input would
+    std::vector<uint32_t> patterns(PATTERNS);
+    uint32_t seed = 1;
+    for (uint32_t &pattern : patterns)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        pattern = (seed >> 8) & 0x3fffff;
+    }
+
+    ButtonMap defaultMap;
+    ButtonMap remapped;
+    Profile profile;
+    std::string error;
+    profile.set("button.Button3", "B");
+    profile.set("button.Button4", "A");
+    profile.set("button.Button7", "LB+RB");
+    remapped.configure(profile, error);
+
+    // check the table driven maps agree with the original
+    uint64_t mismatches = 0;
+    for (uint32_t pattern : patterns)
+    {
+        mismatches += ButtonMap::mapDefault(pattern) != mapIfChain(pattern);
+        mismatches += defaultMap.map(pattern) != mapIfChain(pattern);
+    }
+    if (mismatches != 0)
+    {
+        std::cerr << "button map: default layout differs from if chain"
+                  << std::endl;
+    }
+
+    uint32_t sink = 0;
+    double ns = Bench::measure(
+        MAPPINGS,
+        [&](uint64_t i) { sink ^= mapIfChain(patterns[i & (PATTERNS - 1)]); });
+    Bench::report("button_map/if_chain", ns, "ns");
+    ns = Bench::measure(MAPPINGS,
+                        [&](uint64_t i) {
+                            sink ^= ButtonMap::mapDefault(
+                                patterns[i & (PATTERNS - 1)]);
+                        });
+    Bench::report("button_map/default_mask_shift", ns, "ns");
+    ns = Bench::measure(
+        MAPPINGS,
+        [&](uint64_t i)
+        { sink ^= defaultMap.map(patterns[i & (PATTERNS - 1)]); });
+    Bench::report("button_map/default_map", ns, "ns");
+    ns = Bench::measure(
+        MAPPINGS,
+        [&](uint64_t i)
+        { sink ^= remapped.map(patterns[i & (PATTERNS - 1)]); });
+    Bench::report("button_map/profile_lookup_table", ns, "ns");
+    keep(sink);
+
+    std::string names;
+    ns = Bench::measure(100000,
+                        [&](uint64_t i) {
+                            names = ButtonMap::describe(
+                                defaultMap.map(patterns[i & (PATTERNS - 1)]));
+                        });
+    keep(names);
+    Bench::report("button_map/describe", ns, "ns");
+}
@@ -0,0 +1,279 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * discovery_bench.cpp                                                        *
+ *                                                                            *
+ * Benchmarks discovering wheels as they are connected                        *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "replay_backend.h"
+#include "wheel_manager.h"
+
+// the interval wheels were scanned for before connections were reported
+static const std::chrono::milliseconds SCAN_INTERVAL{1000};
+// wheels connected one at a time, at varying points between scans
+static const int TRIALS = 6;
+static const std::chrono::milliseconds TRIAL_SPACING{170};
+// wheels repeatedly disconnected and reconnected
+static const int CHURN_WHEELS = 8;
+static const int CHURN_CONNECTS = 200;
+static const std::chrono::milliseconds CHURN_PERIOD{10};
+// time allowed for a wheel to be found before it is counted as missed
+static const std::chrono::milliseconds FIND_TIMEOUT{3000};
+// time to count the scans of idle wheels
+static const std::chrono::milliseconds IDLE_TIME{1000};
+static const std::chrono::milliseconds IDLE_SCAN_INTERVAL{1};
+// reconciliations of an unchanged scan timed for each number of wheels, up
+// to the most wheels discovered
+static const uint64_t RECONCILE_ITERATIONS = 100000;
+static const int MAX_RECONCILE_WHEELS = 8;
+
+// forwards to a replay backend, reporting connections only if events is set
+class BenchBackend : public DeviceBackend
+{
+  private:
+    ReplayBackend &bus;
+    bool events;
+    std::atomic<uint64_t> scanCount;
+
+  public:
+    BenchBackend(ReplayBackend &bus, bool events)
+        : bus(bus), events{events}, scanCount{0}
+    {
+    }
+    std::vector<std::shared_ptr<WheelDevice>> scan() override
+    {
+        scanCount.fetch_add(1);
+        return bus.scan();
+    }
+    bool subscribe(DeviceListener *listener) override
+    {
+        return events && bus.subscribe(listener);
+    }
+    void unsubscribe() override
+    {
+        bus.unsubscribe();
+    }
+    // returns the number of scans
+    uint64_t scans() const
+    {
+        return scanCount.load();
+    }
+};
+
+// connects a wheel and returns the ns until its first injection, or 0 if
+// it was not found in time
+static uint64_t connectWheel(ReplayBackend &bus,
+                             std::shared_ptr<ReplayDevice> &device)
+{
+    auto start = std::chrono::steady_clock::now();
+    device = bus.connect(std::vector<WheelState>(1), true, 0);
+    while (device->injected() == 0)
+    {
+        if (std::chrono::steady_clock::now() - start > FIND_TIMEOUT)
+        {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// reports the time from connecting a wheel to its first injection
+static void benchConnect(bool events)
+{
+    const char *mode = events ? "events" : "scan_1s";
+    ReplayBackend bus;
+    BenchBackend backend(bus, events);
+    WheelSettings settings;
+    settings.scanInterval = SCAN_INTERVAL;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    Histogram latency;
+    int missed = 0;
+    for (int i = 0; i < TRIALS; i++)
+    {
+        // connect at a different point between scans each time
+        std::this_thread::sleep_for(TRIAL_SPACING * i % SCAN_INTERVAL);
+        std::shared_ptr<ReplayDevice> device;
+        uint64_t ns = connectWheel(bus, device);
+        if (ns)
+        {
+            latency.record(ns);
+        }
+        else
+        {
+            missed++;
+        }
+        bus.disconnect(device);
+    }
+    manager.stop();
+    std::string name = std::string("discovery/connect_to_inject/") + mode;
+    Bench::report(name + "/p50", latency.percentile(0.5) / 1e6, "ms");
+    Bench::report(name + "/max", latency.max() / 1e6, "ms");
+    Bench::report(name + "/missed", missed, "wheels");
+}
+
+// reports discovery while wheels are repeatedly reconnected
+static void benchChurn()
+{
+    ReplayBackend bus;
+    BenchBackend backend(bus, true);
+    WheelSettings settings;
+    settings.scanInterval = SCAN_INTERVAL;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    std::vector<std::shared_ptr<ReplayDevice>> connected(CHURN_WHEELS);
+    std::vector<std::shared_ptr<ReplayDevice>> disconnected;
+    Histogram latency;
+    int missed = 0;
+    auto next = std::chrono::steady_clock::now();
+    for (int i = 0; i < CHURN_CONNECTS; i++)
+    {
+        // replace one wheel each period
+        std::shared_ptr<ReplayDevice> &slot = connected[i % CHURN_WHEELS];
+        if (slot)
+        {
+            bus.disconnect(slot);
+            disconnected.push_back(slot);
+        }
+        uint64_t ns = connectWheel(bus, slot);
+        if (ns)
+        {
+            latency.record(ns);
+        }
+        else
+        {
+            missed++;
+        }
+        next += CHURN_PERIOD;
+        std::this_thread::sleep_until(next);
+    }
+    // disconnected wheels should no longer be read
+    std::vector<uint64_t> reads;
+    for (auto &device : disconnected)
+    {
+        reads.push_back(device->reads());
+    }
+    std::this_thread::sleep_for(CHURN_PERIOD * 10);
+    int stale = 0;
+    for (size_t i = 0; i < disconnected.size(); i++)
+    {
+        stale += disconnected[i]->reads() != reads[i];
+    }
+    manager.stop();
+    Bench::report("discovery/churn_8_wheels/connect_to_inject/p50",
+                  latency.percentile(0.5) / 1e6, "ms");
+    Bench::report("discovery/churn_8_wheels/connect_to_inject/max",
+                  latency.max() / 1e6, "ms");
+    Bench::report("discovery/churn_8_wheels/missed", missed, "wheels");
+    Bench::report("discovery/churn_8_wheels/stale", stale, "wheels");
+    Bench::report("discovery/churn_8_wheels/scans", backend.scans(), "");
+}
+
+// returns the number of scans while running numWheels idle wheels, scanning
+// every interval unless connections are reported
+static uint64_t idleScans(bool events, int numWheels)
+{
+    ReplayBackend bus;
+    BenchBackend backend(bus, events);
+    WheelSettings settings;
+    settings.scanInterval = IDLE_SCAN_INTERVAL;
+    // poll slowly so scanning dominates
+    settings.pollRateHz = 10;
+    std::vector<std::shared_ptr<ReplayDevice>> devices;
+    for (int i = 0; i < numWheels; i++)
+    {
+        devices.push_back(bus.connect(std::vector<WheelState>(1), true, 0));
+    }
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    uint64_t startScans = backend.scans();
+    std::this_thread::sleep_for(IDLE_TIME);
+    uint64_t scans = backend.scans() - startScans;
+    manager.stop();
+    return scans;
+}
+
+// returns the ns taken to diff a scan of numWheels devices against their
+// running wheels
+static double reconcileCost(int numWheels)
+{
+    ReplayBackend bus;
+    WheelSettings settings;
+    // initialise each wheel on its own thread, as the manager is not started
+    settings.initThreads = 0;
+    // poll slowly so the wheels' threads barely compete with the diff
+    settings.pollRateHz = 125;
+    for (int i = 0; i < numWheels; i++)
+    {
+        bus.connect(std::vector<WheelState>(1), true, 0);
+    }
+    std::vector<std::shared_ptr<WheelDevice>> devices = bus.scan();
+    WheelManager manager(bus, settings, nullptr, nullptr);
+    // the first pass starts every wheel, later passes find each running
+    manager.reconcile(devices);
+    double ns = Bench::measure(RECONCILE_ITERATIONS,
+                               [&](uint64_t) { manager.reconcile(devices); });
+    // an empty scan stops every wheel
+    manager.reconcile({});
+    return ns;
+}
+
+// benchmarks discovering wheels as they are connected
+void benchDiscovery()
+{
+    OutputManager::getInstance().mute(true);
+    benchConnect(true);
+    benchConnect(false);
+    benchChurn();
+
+    // scans avoided by reported connections
+    for (int numWheels : {1, 2, 4, 8})
+    {
+        std::string prefix =
+            "discovery/reconcile_" + std::to_string(numWheels) + "_wheels";
+        Bench::report(prefix + "/scans_per_s/events",
+                      idleScans(true, numWheels) * 1000.0 / IDLE_TIME.count(),
+                      "");
+        Bench::report(prefix + "/scans_per_s/scan_1ms",
+                      idleScans(false, numWheels) * 1000.0 / IDLE_TIME.count(),
+                      "");
+    }
+    // the cost of each scan's diff against the running wheels
+    for (int numWheels = 1; numWheels <= MAX_RECONCILE_WHEELS; numWheels++)
+    {
+        Bench::report("discovery/reconcile_" + std::to_string(numWheels) +
+                          "_wheels/cost",
+                      reconcileCost(numWheels), "ns");
+    }
+    OutputManager::getInstance().mute(false);
+}
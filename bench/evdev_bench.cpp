@@ -0,0 +1,171 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * evdev_bench.cpp                                                            *
+ *                                                                            *
+ * Benchmarks the time from a wheel's evdev event to the uinput gamepad       *
+ * reporting it                                                               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "bench.h"
+
+#ifdef __linux__
+#include <memory>
+#include <thread>
+
+#include "evdev_backend.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "virtual_wheel.h"
+#include "wheel_manager.h"
+
+// frames sent per measurement, spaced so each is handled before the next
+static const int FRAMES = 2000;
+static const std::chrono::microseconds FRAME_SPACING{1500};
+static const std::chrono::milliseconds FIND_TIMEOUT{2000};
+static const std::chrono::milliseconds FRAME_TIMEOUT{100};
+
+// returns frame i, turning the wheel every frame
+static WheelState frame(int i)
+{
+    WheelState state;
+    state.wheel = (i % 2000) / 1000.0 - 1.0;
+    state.throttle = (i % 100) / 100.0;
+    return state;
+}
+
+// reports the time from sending a frame to the backend's reader thread
+// publishing it
+static void benchRead(VirtualWheel &wheel)
+{
+    EvdevBackend backend;
+    std::shared_ptr<EvdevDevice> device;
+    auto deadline = std::chrono::steady_clock::now() + FIND_TIMEOUT;
+    while (!device && std::chrono::steady_clock::now() < deadline)
+    {
+        for (auto &found : backend.scan())
+        {
+            device = std::dynamic_pointer_cast<EvdevDevice>(found);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    if (!device)
+    {
+        Bench::report("evdev/event_to_read/missed", FRAMES, "frames");
+        return;
+    }
+    Histogram latency;
+    int missed = 0;
+    for (int i = 1; i <= FRAMES; i++)
+    {
+        uint64_t previous = device->read().timestamp;
+        auto sent = std::chrono::steady_clock::now();
+        wheel.send(frame(i));
+        // spin, as the poll loop would see the frame no sooner
+        while (device->read().timestamp == previous &&
+               std::chrono::steady_clock::now() - sent < FRAME_TIMEOUT)
+        {
+        }
+        if (device->read().timestamp == previous)
+        {
+            missed++;
+            continue;
+        }
+        latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - sent)
+                           .count());
+        std::this_thread::sleep_for(FRAME_SPACING);
+    }
+    Bench::report("evdev/event_to_read/p50", latency.percentile(0.5) / 1e3,
+                  "us");
+    Bench::report("evdev/event_to_read/p99", latency.percentile(0.99) / 1e3,
+                  "us");
+    Bench::report("evdev/event_to_read/missed", missed, "frames");
+}
+
+// reports the time from sending a frame to the virtual gamepad reporting it,
+// polling at rateHz
+static void benchEmit(VirtualWheel &wheel, int rateHz)
+{
+    EvdevBackend backend;
+    WheelSettings settings;
+    settings.pollRateHz = rateHz;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    std::string name = "evdev/event_to_emit/" + std::to_string(rateHz) + "hz";
+    GamepadReader gamepad;
+    if (!gamepad.open(UinputGamepadInjector::GAMEPAD_NAME, FIND_TIMEOUT))
+    {
+        manager.stop();
+        Bench::report(name + "/missed", FRAMES, "frames");
+        return;
+    }
+    Histogram latency;
+    int missed = 0;
+    for (int i = 1; i <= FRAMES; i++)
+    {
+        auto sent = std::chrono::steady_clock::now();
+        wheel.send(frame(i));
+        GamepadState output;
+        if (!gamepad.next(output, FRAME_TIMEOUT))
+        {
+            missed++;
+            continue;
+        }
+        latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - sent)
+                           .count());
+        std::this_thread::sleep_for(FRAME_SPACING);
+    }
+    manager.stop();
+    Bench::report(name + "/p50", latency.percentile(0.5) / 1e3, "us");
+    Bench::report(name + "/p99", latency.percentile(0.99) / 1e3, "us");
+    Bench::report(name + "/max", latency.max() / 1e3, "us");
+    Bench::report(name + "/missed", missed, "frames");
+}
+#endif
+
+// benchmarks the time from a wheel's evdev event to the uinput gamepad
+// reporting it
+void benchEvdev()
+{
+#ifdef __linux__
+    std::string error;
+    VirtualWheel wheel;
+    if (!wheel.create(error))
+    {
+        std::cout << "evdev skipped, " << error << std::endl;
+        return;
+    }
+    OutputManager::getInstance().mute(true);
+    benchRead(wheel);
+    for (int rateHz : {250, 1000})
+    {
+        benchEmit(wheel, rateHz);
+    }
+    OutputManager::getInstance().mute(false);
+#else
+    std::cout << "evdev skipped, evdev is only available on Linux"
+              << std::endl;
+#endif
+}
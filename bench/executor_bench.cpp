@@ -0,0 +1,109 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * executor_bench.cpp                                                         *
+ *                                                                            *
+ * Compares one thread per wheel against a shared poll thread                 *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "input_pipeline.h"
+#include "poll_executor.h"
+
+// real time spent measuring each configuration
+static const std::chrono::milliseconds DURATION{300};
+
+// simulated wheel polled by an executor
+class SimWheel : public Pollable
+{
+  private:
+    FakeSource source;
+    FakeInjector injector;
+    InputPipeline pipeline;
+
+  public:
+    SimWheel(const WheelSettings &settings)
+        : source(1), injector{}, pipeline(source, injector, settings)
+    {
+    }
+    void poll(Clock::time_point now) override
+    {
+        pipeline.tick(now);
+    }
+};
+
+// runs wheels on the given executors and reports cpu use and jitter
+static void runMode(const std::string &name, int numWheels, bool shared)
+{
+    WheelSettings settings;
+    Clock &clock = SteadyClock::getInstance();
+    std::vector<std::unique_ptr<SimWheel>> wheels;
+    std::vector<std::unique_ptr<PollExecutor>> executors;
+    std::vector<const Pacer *> pacers;
+    for (int i = 0; i < numWheels; i++)
+    {
+        wheels.push_back(std::make_unique<SimWheel>(settings));
+        if (!shared || executors.empty())
+        {
+            executors.push_back(
+                std::make_unique<PollExecutor>(clock, settings, 1));
+        }
+        pacers.push_back(executors.back()->add(wheels.back().get()));
+    }
+
+    double cpuStart = Bench::cpuSeconds();
+    for (std::unique_ptr<PollExecutor> &executor : executors)
+    {
+        executor->start();
+    }
+    std::this_thread::sleep_for(DURATION);
+    uint64_t jitter = 0;
+    for (const Pacer *pacer : pacers)
+    {
+        uint64_t p99 = pacer->getJitter().percentile(0.99);
+        jitter = p99 > jitter ? p99 : jitter;
+    }
+    for (std::unique_ptr<PollExecutor> &executor : executors)
+    {
+        executor->stop();
+    }
+    double cpu = Bench::cpuSeconds() - cpuStart;
+
+    double seconds = std::chrono::duration<double>(DURATION).count();
+    std::string prefix =
+        "executor/" + name + "/" + std::to_string(numWheels) + "_wheels";
+    Bench::report(prefix + "/cpu", 100.0 * cpu / seconds, "%");
+    Bench::report(prefix + "/jitter_p99", jitter / 1000.0, "us");
+}
+
+// compares thread per wheel polling against a shared poll thread
+void benchExecutor()
+{
+    for (int numWheels : {1, 2, 4, 8})
+    {
+        runMode("thread_per_wheel", numWheels, false);
+        runMode("shared_thread", numWheels, true);
+    }
+}
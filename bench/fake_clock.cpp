@@ -0,0 +1,68 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * fake_clock.cpp                                                             *
+ *                                                                            *
+ * Simulated clock which models scheduler oversleep without waiting           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "fake_clock.h"
+
+FakeClock::FakeClock(std::chrono::nanoseconds maxOversleep)
+    : current{}, maxOversleep(maxOversleep), seed{12345}
+{
+}
+
+// returns the simulated time
+Clock::time_point FakeClock::now()
+{
+    return current;
+}
+
+// jumps to the deadline plus a pseudo-random oversleep
+void FakeClock::sleepUntil(time_point deadline)
+{
+    seed = seed * 1664525u + 1013904223u;
+    std::chrono::nanoseconds oversleep{0};
+    if (maxOversleep.count() > 0)
+    {
+        oversleep = std::chrono::nanoseconds((seed >> 8) %
+                                             maxOversleep.count());
+    }
+    if (deadline > current)
+    {
+        current = deadline;
+    }
+    current += oversleep;
+}
+
+// jumps to the deadline
+void FakeClock::spinUntil(time_point deadline)
+{
+    if (deadline > current)
+    {
+        current = deadline;
+    }
+}
+
+// moves simulated time forward, modelling work
+void FakeClock::advance(std::chrono::nanoseconds duration)
+{
+    current += duration;
+}
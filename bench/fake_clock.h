@@ -0,0 +1,52 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * fake_clock.h                                                               *
+ *                                                                            *
+ * Simulated clock which models scheduler oversleep without waiting           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef FAKE_CLOCK_H
+#define FAKE_CLOCK_H
+
+#include <cstdint>
+
+#include "clock.h"
+
+class FakeClock : public Clock
+{
+  private:
+    time_point current;
+    std::chrono::nanoseconds maxOversleep;
+    uint32_t seed;
+
+  public:
+    // creates a clock whose sleeps overrun by up to maxOversleep
+    FakeClock(std::chrono::nanoseconds maxOversleep);
+    // returns the simulated time
+    time_point now() override;
+    // jumps to the deadline plus a pseudo-random oversleep
+    void sleepUntil(time_point deadline) override;
+    // jumps to the deadline
+    void spinUntil(time_point deadline) override;
+    // moves simulated time forward, modelling work
+    void advance(std::chrono::nanoseconds duration);
+};
+
+#endif
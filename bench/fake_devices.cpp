@@ -0,0 +1,110 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * fake_devices.cpp                                                           *
+ *                                                                            *
+ * In-memory wheel source and gamepad injector for benchmarking               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "fake_devices.h"
+
+FakeSource::FakeSource(uint64_t changeInterval)
+    : changeInterval(changeInterval), reads{0}, state{}
+{
+}
+
+// returns the next generated reading
+bool FakeSource::read(WheelState &state)
+{
+    if (changeInterval != 0 && reads % changeInterval == 0)
+    {
+        // sweep the wheel and cycle through the buttons
+        uint64_t step = reads / changeInterval;
+        this->state.wheel = static_cast<double>(step % 201) / 100.0 - 1.0;
+        this->state.throttle = static_cast<double>(step % 101) / 100.0;
+        this->state.buttons = static_cast<uint32_t>(1u << (step % 22));
+    }
+    this->state.timestamp = reads++;
+    state = this->state;
+    return true;
+}
+
+FakeInjector::FakeInjector() : count{0}, last{}
+{
+}
+
+bool FakeInjector::initialise()
+{
+    return true;
+}
+
+// records an injected reading
+void FakeInjector::inject(const GamepadState &state)
+{
+    last = state;
+    count++;
+}
+
+void FakeInjector::release()
+{
+}
+
+// returns the number of readings injected
+uint64_t FakeInjector::injected()
+{
+    return count;
+}
+
+// returns the most recently injected reading
+GamepadState FakeInjector::lastInjected()
+{
+    return last;
+}
+
+FakeMotor::FakeMotor() : count{0}, last{0.0}
+{
+}
+
+bool FakeMotor::initialise()
+{
+    return true;
+}
+
+// records a force
+void FakeMotor::setForce(double force)
+{
+    last = force;
+    count++;
+}
+
+void FakeMotor::release()
+{
+}
+
+// returns the number of forces set
+uint64_t FakeMotor::forces()
+{
+    return count;
+}
+
+// returns the most recently set force
+double FakeMotor::lastForce()
+{
+    return last;
+}
@@ -0,0 +1,85 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * fake_devices.h                                                             *
+ *                                                                            *
+ * In-memory wheel source and gamepad injector for benchmarking               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef FAKE_DEVICES_H
+#define FAKE_DEVICES_H
+
+#include <cstdint>
+
+#include "gamepad_injector.h"
+#include "reading_source.h"
+#include "wheel_motor.h"
+
+class FakeSource : public ReadingSource
+{
+  private:
+    uint64_t changeInterval;
+    uint64_t reads;
+    WheelState state;
+
+  public:
+    // creates a source whose reading changes every changeInterval reads,
+    // or never if changeInterval is zero
+    FakeSource(uint64_t changeInterval);
+    // returns the next generated reading
+    bool read(WheelState &state) override;
+};
+
+class FakeInjector : public GamepadInjector
+{
+  private:
+    uint64_t count;
+    GamepadState last;
+
+  public:
+    FakeInjector();
+    bool initialise() override;
+    // records an injected reading
+    void inject(const GamepadState &state) override;
+    void release() override;
+    // returns the number of readings injected
+    uint64_t injected();
+    // returns the most recently injected reading
+    GamepadState lastInjected();
+};
+
+class FakeMotor : public WheelMotor
+{
+  private:
+    uint64_t count;
+    double last;
+
+  public:
+    FakeMotor();
+    bool initialise() override;
+    // records a force
+    void setForce(double force) override;
+    void release() override;
+    // returns the number of forces set
+    uint64_t forces();
+    // returns the most recently set force
+    double lastForce();
+};
+
+#endif
@@ -0,0 +1,125 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * force_feedback_bench.cpp                                                   *
+ *                                                                            *
+ * Benchmarks computing and sending force feedback on each poll               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "force_feedback.h"
+#include "input_pipeline.h"
+
+// samples timed per scenario
+static const uint64_t SAMPLES = 10000000;
+// distinct steering positions cycled through, a power of two
+static const size_t POSITIONS = 4096;
+// number of 1 ms ticks simulated per pipeline scenario
+static const uint64_t TICKS = 60000;
+
+// returns a slow sweep of the wheel with potentiometer noise added
+static std::vector<double> sweep()
+{
+    const double pi = std::acos(-1.0);
+    std::vector<double> positions(POSITIONS);
+    uint32_t seed = 7;
+    for (size_t i = 0; i < POSITIONS; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double noise = 0.002 * (((seed >> 8) & 0xffff) / 32767.5 - 1.0);
+        positions[i] = 0.5 * std::sin(2 * pi * i / POSITIONS) + noise;
+    }
+    return positions;
+}
+
+// reports the cost of computing forces, and how many are sent, for effects
+static void runEffects(const std::string &name,
+                       const ForceFeedbackSettings &settings)
+{
+    std::vector<double> positions = sweep();
+    ForceFeedback forceFeedback(settings, 1000);
+    double sink = 0.0;
+    double computeNs = Bench::measure(
+        SAMPLES, [&](uint64_t i)
+        { sink += forceFeedback.compute(positions[i & (POSITIONS - 1)]); });
+    keep(sink);
+
+    FakeMotor motor;
+    forceFeedback.setMotor(&motor);
+    double updateNs = Bench::measure(
+        SAMPLES, [&](uint64_t i)
+        { forceFeedback.update(positions[i & (POSITIONS - 1)]); });
+    keep(motor.lastForce());
+
+    std::string prefix = "force_feedback/" + name;
+    Bench::report(prefix + "/compute", computeNs, "ns");
+    Bench::report(prefix + "/update", updateNs, "ns");
+    Bench::report(prefix + "/sent_per_1000_polls",
+                  motor.forces() * 1000.0 / SAMPLES, "");
+}
+
+// reports the cost of a whole poll with and without force feedback
+static void runPipeline(bool driving)
+{
+    FakeSource source(1);
+    FakeInjector injector;
+    FakeMotor motor;
+    WheelSettings settings;
+    settings.forceFeedback.spring = 1.0;
+    settings.forceFeedback.damper = 0.05;
+    settings.forceFeedback.friction = 0.1;
+    InputPipeline pipeline(source, injector, settings);
+    if (driving)
+    {
+        pipeline.setMotor(&motor);
+    }
+    std::chrono::steady_clock::time_point now{};
+    double ns = Bench::measure(TICKS,
+                               [&](uint64_t)
+                               {
+                                   pipeline.tick(now);
+                                   now += std::chrono::milliseconds(1);
+                               });
+    keep(injector.lastInjected());
+    Bench::report(std::string("force_feedback/tick/") +
+                      (driving ? "driving" : "off"),
+                  ns, "ns");
+}
+
+// benchmarks computing and sending force feedback on each poll
+void benchForceFeedback()
+{
+    ForceFeedbackSettings spring;
+    spring.spring = 1.0;
+    ForceFeedbackSettings all = spring;
+    all.damper = 0.05;
+    all.friction = 0.1;
+    ForceFeedbackSettings everyChange = all;
+    everyChange.minChange = 0.0;
+    runEffects("spring", spring);
+    runEffects("all_effects", all);
+    runEffects("all_effects_every_change", everyChange);
+    runPipeline(false);
+    runPipeline(true);
+}
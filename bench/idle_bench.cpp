@@ -0,0 +1,252 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * idle_bench.cpp                                                             *
+ *                                                                            *
+ * Benchmarks polling wheels at a lower rate while their input is unchanged   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "wheel.h"
+
+// wheels polled at once when measuring cpu use
+static const int NUM_WHEELS = 4;
+// time to measure each phase over
+static const std::chrono::milliseconds PHASE_TIME{1000};
+// time without changes before polling slows down
+static const std::chrono::milliseconds IDLE_TIMEOUT{100};
+// wheel movements timed after idling, spaced so each starts idle
+static const int TRIALS = 25;
+static const std::chrono::milliseconds TRIAL_SPACING{IDLE_TIMEOUT * 2};
+// time allowed for a movement to be injected before it is counted as missed
+static const std::chrono::milliseconds INJECT_TIMEOUT{100};
+
+// a wheel which is either turned slightly on every read or held still, and
+// times each movement from being made to being injected
+class TouchDevice : public WheelDevice
+{
+  private:
+    class Source : public ReadingSource
+    {
+      private:
+        TouchDevice &device;
+        uint64_t reads;
+
+      public:
+        Source(TouchDevice &device) : device(device), reads{0}
+        {
+        }
+        bool read(WheelState &state) override
+        {
+            state = WheelState{};
+            state.wheel = device.moving.load(std::memory_order_relaxed)
+                              ? (++reads % 100) / 100.0
+                              : device.position.load();
+            return true;
+        }
+    };
+    class Injector : public GamepadInjector
+    {
+      private:
+        TouchDevice &device;
+
+      public:
+        Injector(TouchDevice &device) : device(device)
+        {
+        }
+        bool initialise() override
+        {
+            return true;
+        }
+        void inject(const GamepadState &state) override
+        {
+            // times the first injection which differs from the last
+            if (state.leftThumbstickX != device.last)
+            {
+                device.last = state.leftThumbstickX;
+                auto now = std::chrono::steady_clock::now();
+                int64_t touched = device.touchNs.exchange(0);
+                if (touched)
+                {
+                    device.latency.record(static_cast<uint64_t>(
+                        now.time_since_epoch().count() - touched));
+                }
+            }
+        }
+        void release() override
+        {
+        }
+    };
+
+    std::atomic<bool> moving;
+    std::atomic<double> position;
+    // when the position was moved, or 0 once the move has been injected
+    std::atomic<int64_t> touchNs;
+    // only used by the poll thread
+    double last;
+    Histogram latency;
+
+  public:
+    TouchDevice()
+        : moving{false}, position{0.0}, touchNs{0}, last{-2.0}, latency{}
+    {
+    }
+    bool matches(const WheelDevice &other) const override
+    {
+        return &other == this;
+    }
+    std::unique_ptr<ReadingSource> createSource() override
+    {
+        return std::make_unique<Source>(*this);
+    }
+    std::unique_ptr<GamepadInjector> createInjector() override
+    {
+        return std::make_unique<Injector>(*this);
+    }
+    // turns the wheel slightly on every read, or holds it still
+    void setMoving(bool moving)
+    {
+        this->moving.store(moving);
+    }
+    // moves the held wheel to position, returns false if the previous move
+    // was not injected in time
+    bool move(double position)
+    {
+        auto start = std::chrono::steady_clock::now();
+        while (touchNs.load())
+        {
+            if (std::chrono::steady_clock::now() - start > INJECT_TIMEOUT)
+            {
+                touchNs.store(0);
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+        touchNs.store(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        this->position.store(position);
+        return true;
+    }
+    // returns the time from moving the wheel to injecting the move, in ns
+    const Histogram &getLatency() const
+    {
+        return latency;
+    }
+};
+
+// starts a wheel on its own thread and waits until it is polled
+static std::unique_ptr<Wheel>
+startWheel(const std::shared_ptr<TouchDevice> &device,
+           const WheelSettings &settings)
+{
+    auto wheel = std::make_unique<Wheel>(device, settings, nullptr, nullptr,
+                                         nullptr, nullptr, nullptr, nullptr);
+    wheel->start();
+    while (!wheel->running())
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return wheel;
+}
+
+// returns the cpu ms used per second by each of NUM_WHEELS wheels, which are
+// moving or held still, slowing down when idle if adaptive is set
+static double cpuPerWheel(bool moving, bool adaptive)
+{
+    WheelSettings settings;
+    settings.idleTimeout =
+        adaptive ? IDLE_TIMEOUT : std::chrono::milliseconds(0);
+    std::vector<std::shared_ptr<TouchDevice>> devices;
+    std::vector<std::unique_ptr<Wheel>> wheels;
+    for (int i = 0; i < NUM_WHEELS; i++)
+    {
+        devices.push_back(std::make_shared<TouchDevice>());
+        devices.back()->setMoving(moving);
+        wheels.push_back(startWheel(devices.back(), settings));
+    }
+    // let still wheels go idle
+    std::this_thread::sleep_for(IDLE_TIMEOUT * 2);
+    double start = Bench::cpuSeconds();
+    std::this_thread::sleep_for(PHASE_TIME);
+    double cpu = Bench::cpuSeconds() - start;
+    for (std::unique_ptr<Wheel> &wheel : wheels)
+    {
+        wheel->stop();
+    }
+    return cpu * 1000.0 / NUM_WHEELS /
+           std::chrono::duration<double>(PHASE_TIME).count();
+}
+
+// reports the time from moving a still wheel to injecting the move
+static void benchWake(bool adaptive)
+{
+    const char *mode = adaptive ? "adaptive" : "full_rate";
+    WheelSettings settings;
+    settings.idleTimeout =
+        adaptive ? IDLE_TIMEOUT : std::chrono::milliseconds(0);
+    auto device = std::make_shared<TouchDevice>();
+    std::unique_ptr<Wheel> wheel = startWheel(device, settings);
+    int missed = 0;
+    for (int i = 0; i < TRIALS; i++)
+    {
+        // move at a different point of the idle period each time
+        std::this_thread::sleep_for(TRIAL_SPACING +
+                                    std::chrono::microseconds(i * 317));
+        missed += !device->move(i % 2 ? -0.5 : 0.5);
+    }
+    std::this_thread::sleep_for(INJECT_TIMEOUT);
+    uint64_t wakeups = wheel->wakeups();
+    wheel->stop();
+    const Histogram &latency = device->getLatency();
+    std::string name = std::string("idle/move_to_inject/") + mode;
+    Bench::report(name + "/p50", latency.percentile(0.5) / 1e6, "ms");
+    Bench::report(name + "/p99", latency.percentile(0.99) / 1e6, "ms");
+    Bench::report(name + "/max", latency.max() / 1e6, "ms");
+    Bench::report(name + "/missed", missed, "moves");
+    if (adaptive)
+    {
+        Bench::report(name + "/bound", 1000.0 / settings.idleRateHz, "ms");
+        Bench::report(name + "/wakeups", wakeups, "");
+    }
+}
+
+// benchmarks polling wheels at a lower rate while their input is unchanged
+void benchIdle()
+{
+    OutputManager::getInstance().mute(true);
+    std::string prefix =
+        "idle/cpu_per_wheel_" + std::to_string(NUM_WHEELS) + "_wheels";
+    Bench::report(prefix + "/moving", cpuPerWheel(true, true), "ms/s");
+    Bench::report(prefix + "/still/full_rate", cpuPerWheel(false, false),
+                  "ms/s");
+    Bench::report(prefix + "/still/adaptive", cpuPerWheel(false, true),
+                  "ms/s");
+    benchWake(false);
+    benchWake(true);
+    OutputManager::getInstance().mute(false);
+}
@@ -0,0 +1,106 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * init_bench.cpp                                                             *
+ *                                                                            *
+ * Benchmarks initialising several wheels at once                             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "output_manager.h"
+#include "replay_backend.h"
+#include "wheel_manager.h"
+
+// the time the system's injector needs between creation and initialisation
+static const std::chrono::milliseconds SETTLE_TIME{500};
+// time allowed for wheels to start before they are counted as missed
+static const std::chrono::milliseconds START_TIMEOUT{10000};
+static const int MAX_WHEELS = 8;
+
+// returns the ms from connecting numWheels wheels at once until every one
+// has injected, and sets disconnectMs to the time taken to stop polling a
+// wheel disconnected while they initialise
+static double startup(int numWheels, double &disconnectMs)
+{
+    ReplayBackend backend;
+    WheelSettings settings;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    auto running = backend.connect(std::vector<WheelState>(1), true, 0);
+    while (running->injected() == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    backend.setSettleTime(SETTLE_TIME);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::shared_ptr<ReplayDevice>> devices;
+    for (int i = 0; i < numWheels; i++)
+    {
+        devices.push_back(
+            backend.connect(std::vector<WheelState>(1), true, 0));
+    }
+    // the scanner should stop the wheel without waiting for the others,
+    // releasing the last reference to it besides this one
+    auto disconnected = std::chrono::steady_clock::now();
+    backend.disconnect(running);
+    while (running.use_count() > 1)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    disconnectMs = std::chrono::duration<double, std::milli>(
+                       std::chrono::steady_clock::now() - disconnected)
+                       .count();
+
+    for (auto &device : devices)
+    {
+        while (device->injected() == 0 &&
+               std::chrono::steady_clock::now() - start < START_TIMEOUT)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    double ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start)
+                    .count();
+    manager.stop();
+    return ms;
+}
+
+// benchmarks initialising several wheels at once
+void benchInit()
+{
+    OutputManager::getInstance().mute(true);
+    for (int wheels = 1; wheels <= MAX_WHEELS; wheels *= 2)
+    {
+        double disconnectMs;
+        double ms = startup(wheels, disconnectMs);
+        std::string name = "init/" + std::to_string(wheels) + "_wheels";
+        Bench::report(name + "/all_injecting", ms, "ms");
+        Bench::report(name + "/disconnect_handled", disconnectMs, "ms");
+    }
+    OutputManager::getInstance().mute(false);
+}
@@ -0,0 +1,72 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * injection_bench.cpp                                                        *
+ *                                                                            *
+ * Benchmarks change detecting injection                                      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <string>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "input_pipeline.h"
+
+// number of 1 ms ticks simulated per scenario
+static const uint64_t TICKS = 60000;
+
+// runs one scenario and reports its cost and injection rate
+static void runScenario(const std::string &name, uint64_t changeInterval,
+                        bool skipUnchanged)
+{
+    FakeSource source(changeInterval);
+    FakeInjector injector;
+    WheelSettings settings;
+    settings.skipUnchanged = skipUnchanged;
+    InputPipeline pipeline(source, injector, settings);
+
+    std::chrono::steady_clock::time_point now{};
+    double ns = Bench::measure(TICKS,
+                               [&](uint64_t)
+                               {
+                                   pipeline.tick(now);
+                                   now += std::chrono::milliseconds(1);
+                               });
+    keep(injector.lastInjected());
+
+    std::string prefix = "injection/" + name +
+                         (skipUnchanged ? "/skip_unchanged" : "/always");
+    double seconds = TICKS / 1000.0;
+    Bench::report(prefix + "/tick", ns, "ns");
+    Bench::report(prefix + "/injected_per_s", pipeline.injected() / seconds,
+                  "/s");
+    Bench::report(prefix + "/skipped_per_s", pipeline.skipped() / seconds,
+                  "/s");
+}
+
+// benchmarks change detecting injection
+void benchInjection()
+{
+    for (bool skipUnchanged : {false, true})
+    {
+        runScenario("idle", 0, skipUnchanged);
+        runScenario("change_every_20ms", 20, skipUnchanged);
+        runScenario("change_every_tick", 1, skipUnchanged);
+    }
+}
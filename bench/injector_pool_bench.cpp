@@ -0,0 +1,129 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * injector_pool_bench.cpp                                                    *
+ *                                                                            *
+ * Benchmarks starting wheels with injectors initialised in advance           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "replay_backend.h"
+#include "wheel_manager.h"
+
+// the time the system's injector needs between creation and initialisation
+static const std::chrono::milliseconds SETTLE_TIME{500};
+// wheels connected one after another
+static const int CONNECTS = 6;
+static const int POOL_SIZE = 2;
+
+// an injector which any wheel can use, needing time to settle
+class SettlingInjector : public GamepadInjector
+{
+  public:
+    std::chrono::milliseconds settleTime() const override
+    {
+        return SETTLE_TIME;
+    }
+    bool initialise() override
+    {
+        return true;
+    }
+    void inject(const GamepadState &state) override
+    {
+        keep(state);
+    }
+    void release() override
+    {
+    }
+};
+
+// replays wheels whose injectors can be pooled, like the system's
+class PoolingBackend : public ReplayBackend
+{
+  public:
+    std::unique_ptr<GamepadInjector> createInjector() override
+    {
+        return std::make_unique<SettlingInjector>();
+    }
+};
+
+// reports the time from connecting each wheel until it is first polled,
+// with poolSize injectors initialised in advance
+static void connectWheels(int poolSize)
+{
+    PoolingBackend backend;
+    backend.setSettleTime(SETTLE_TIME);
+    WheelSettings settings;
+    settings.pooledInjectors = poolSize;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    // let the pool fill as it would while the service waits for wheels
+    std::this_thread::sleep_for(SETTLE_TIME * 2);
+
+    Histogram latency;
+    for (int i = 0; i < CONNECTS; i++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto device = backend.connect(std::vector<WheelState>(1), true, 0);
+        while (device->reads() == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count());
+        // wait for the wheel to be destroyed, recycling its injector
+        backend.disconnect(device);
+        while (device.use_count() > 1)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    std::string name = "injector_pool/" +
+                       (poolSize ? "pool_" + std::to_string(poolSize)
+                                 : std::string("no_pool"));
+    Bench::report(name + "/first_poll/p50", latency.percentile(0.5) / 1e6,
+                  "ms");
+    Bench::report(name + "/first_poll/max", latency.max() / 1e6, "ms");
+    if (const InjectorPool *pool = manager.getInjectorPool())
+    {
+        double total = pool->hits() + pool->misses();
+        Bench::report(name + "/hit_rate", 100.0 * pool->hits() / total, "%");
+    }
+    manager.stop();
+}
+
+// benchmarks starting wheels with injectors initialised in advance
+void benchInjectorPool()
+{
+    OutputManager::getInstance().mute(true);
+    connectWheels(0);
+    connectWheels(POOL_SIZE);
+    OutputManager::getInstance().mute(false);
+}
@@ -0,0 +1,77 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * latency_bench.cpp                                                          *
+ *                                                                            *
+ * Benchmarks the cost of timing each stage of a tick                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "input_pipeline.h"
+
+// ticks timed per configuration
+static const uint64_t TICKS = 1000000;
+// the most stage timing may add to each tick
+static const double BUDGET_NS = 100.0;
+
+// returns the mean cost of a tick with stage timing on or off
+static double timeTicks(bool timeStages)
+{
+    FakeSource source(1);
+    FakeInjector injector;
+    WheelSettings settings;
+    settings.timeStages = timeStages;
+    InputPipeline pipeline(source, injector, settings);
+    std::chrono::steady_clock::time_point now{};
+    double ns = Bench::measure(TICKS,
+                               [&](uint64_t)
+                               {
+                                   pipeline.tick(now);
+                                   now += std::chrono::milliseconds(1);
+                               });
+    keep(injector.lastInjected());
+    return ns;
+}
+
+// benchmarks the cost of timing each stage of a tick
+void benchLatency()
+{
+    // warm up so the first configuration is not penalised
+    timeTicks(false);
+    double untimed = timeTicks(false);
+    double timed = timeTicks(true);
+    double overhead = timed - untimed;
+    Bench::report("latency/tick/untimed", untimed, "ns");
+    Bench::report("latency/tick/timed", timed, "ns");
+    Bench::report("latency/overhead", overhead, "ns");
+    Bench::report("latency/budget", BUDGET_NS, "ns");
+    Bench::report("latency/within_budget", overhead <= BUDGET_NS, "");
+    if (overhead > BUDGET_NS)
+    {
+        char message[96];
+        std::snprintf(message, sizeof(message),
+                      "latency/overhead of %.2f ns is over the %.0f ns budget",
+                      overhead, BUDGET_NS);
+        Bench::fail(message);
+    }
+}
@@ -0,0 +1,164 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * log_bench.cpp                                                              *
+ *                                                                            *
+ * Benchmarks logging from many threads at once                               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "histogram.h"
+#include "log_record.h"
+#include "mpsc_ring.h"
+
+static const int THREADS = 8;
+static const int MESSAGES = 50000;
+static const size_t QUEUE_CAPACITY = 1024;
+
+// discards everything written to it
+class DiscardBuffer : public std::streambuf
+{
+  protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+// logs from every thread at once, returning the latency of each call
+template <typename Log>
+static void runProducers(const std::string &name, Log log)
+{
+    std::vector<std::unique_ptr<Histogram>> latencies;
+    std::vector<std::thread> threads;
+    std::atomic<bool> go{false};
+    for (int i = 0; i < THREADS; i++)
+    {
+        latencies.push_back(std::make_unique<Histogram>());
+    }
+    for (int i = 0; i < THREADS; i++)
+    {
+        Histogram *latency = latencies[i].get();
+        threads.emplace_back(
+            [&, latency]()
+            {
+                const std::string message =
+                    "Injection error: The parameter is incorrect.";
+                while (!go.load())
+                {
+                }
+                for (int m = 0; m < MESSAGES; m++)
+                {
+                    auto start = std::chrono::steady_clock::now();
+                    log(message);
+                    auto end = std::chrono::steady_clock::now();
+                    latency->record(
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            end - start)
+                            .count());
+                }
+            });
+    }
+    go.store(true);
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    // report the worst thread
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t maximum = 0;
+    for (const std::unique_ptr<Histogram> &latency : latencies)
+    {
+        p50 = std::max(p50, latency->percentile(0.5));
+        p99 = std::max(p99, latency->percentile(0.99));
+        maximum = std::max(maximum, latency->max());
+    }
+    Bench::report("log/8_threads/" + name + "/p50", p50, "ns");
+    Bench::report("log/8_threads/" + name + "/p99", p99, "ns");
+    Bench::report("log/8_threads/" + name + "/max", maximum, "ns");
+}
+
+// benchmarks logging from many threads at once
+void benchLog()
+{
+    // a lock held while writing to the console, as OutputManager used to
+    DiscardBuffer discard;
+    std::ostream console(&discard);
+    std::mutex outputMutex;
+    runProducers("locked_write",
+                 [&](const std::string &message)
+                 {
+                     std::lock_guard<std::mutex> lock(outputMutex);
+                     console << std::left << std::setw(80) << message
+                             << std::endl;
+                 });
+
+    // a queue drained by one writer thread
+    MpscRing<LogRecord> queue(QUEUE_CAPACITY);
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> draining{true};
+    std::thread writer(
+        [&]()
+        {
+            LogRecord record;
+            while (true)
+            {
+                if (queue.pop(record))
+                {
+                    console.write(record.text, record.length) << '\n';
+                }
+                else if (!draining.load())
+                {
+                    break;
+                }
+                else
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    runProducers("queued",
+                 [&](const std::string &message)
+                 {
+                     if (!queue.push([&](LogRecord &record)
+                                     { record.set(message, false); }))
+                     {
+                         dropped.fetch_add(1, std::memory_order_relaxed);
+                     }
+                 });
+    draining.store(false);
+    writer.join();
+    Bench::report("log/8_threads/queued/dropped", dropped.load(), "messages");
+}
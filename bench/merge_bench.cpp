@@ -0,0 +1,343 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * merge_bench.cpp                                                            *
+ *                                                                            *
+ * Benchmarks merging several devices into one virtual gamepad                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "gamepad_merger.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "wheel_manager.h"
+
+// merges timed for each number of sources
+static const uint64_t MERGE_ITERATIONS = 1000000;
+// moves timed from a device to the gamepad, spread across the devices
+static const int TRIALS = 150;
+static const std::chrono::milliseconds TRIAL_SPACING{7};
+// time allowed for a move to be injected before it is counted as missed
+static const std::chrono::milliseconds INJECT_TIMEOUT{100};
+// time allowed for every device to be found
+static const std::chrono::milliseconds FIND_TIMEOUT{3000};
+
+// the part of a wheel set each device provides
+enum class Part
+{
+    Steering,
+    Pedals,
+    Shifter
+};
+
+// returns the value of part in a gamepad reading
+static double partOf(Part part, const GamepadState &state)
+{
+    switch (part)
+    {
+    case Part::Steering:
+        return state.leftThumbstickX;
+    case Part::Pedals:
+        return state.rightTrigger;
+    default:
+        return state.buttons != PadButtons::None ? 1.0 : 0.0;
+    }
+}
+
+// a wheel base, pedals or shifter which reports one part of a wheel, and
+// times each move from being made to being injected, one move at a time
+class PartDevice : public WheelDevice
+{
+  private:
+    class Source : public ReadingSource
+    {
+      private:
+        PartDevice &device;
+
+      public:
+        Source(PartDevice &device) : device(device)
+        {
+        }
+        bool read(WheelState &state) override
+        {
+            device.readCount.fetch_add(1, std::memory_order_relaxed);
+            double position = device.position.load();
+            state = WheelState{};
+            switch (device.part)
+            {
+            case Part::Steering:
+                state.wheel = position;
+                break;
+            case Part::Pedals:
+                state.throttle = position;
+                break;
+            default:
+                // shift up while past half way
+                state.buttons = position > 0.5 ? WheelButtons::NextGear : 0;
+            }
+            return true;
+        }
+    };
+    class Injector : public GamepadInjector
+    {
+      private:
+        PartDevice &device;
+
+      public:
+        Injector(PartDevice &device) : device(device)
+        {
+        }
+        bool initialise() override
+        {
+            return true;
+        }
+        void inject(const GamepadState &state) override
+        {
+            device.observe(state);
+        }
+        void release() override
+        {
+        }
+    };
+
+    Part part;
+    std::atomic<double> position;
+    std::atomic<uint64_t> readCount;
+    // when the device was moved, or 0 once the move has been injected
+    std::atomic<int64_t> touchNs;
+    // only used by the thread injecting the device
+    double last;
+    Histogram &latency;
+
+  public:
+    PartDevice(Part part, Histogram &latency)
+        : part{part}, position{0.0}, readCount{0}, touchNs{0}, last{-2.0},
+          latency(latency)
+    {
+    }
+    bool matches(const WheelDevice &other) const override
+    {
+        return &other == this;
+    }
+    std::unique_ptr<ReadingSource> createSource() override
+    {
+        return std::make_unique<Source>(*this);
+    }
+    std::unique_ptr<GamepadInjector> createInjector() override
+    {
+        return std::make_unique<Injector>(*this);
+    }
+    // times the first injection in which the device's part has moved
+    void observe(const GamepadState &state)
+    {
+        double value = partOf(part, state);
+        if (value != last)
+        {
+            last = value;
+            auto now = std::chrono::steady_clock::now();
+            int64_t touched = touchNs.exchange(0);
+            if (touched)
+            {
+                latency.record(static_cast<uint64_t>(
+                    now.time_since_epoch().count() - touched));
+            }
+        }
+    }
+    // moves the device to position, returns false if the move was not
+    // injected in time
+    bool move(double position)
+    {
+        touchNs.store(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        this->position.store(position);
+        auto start = std::chrono::steady_clock::now();
+        while (touchNs.load())
+        {
+            if (std::chrono::steady_clock::now() - start > INJECT_TIMEOUT)
+            {
+                touchNs.store(0);
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    }
+    // returns the number of times the device was read
+    uint64_t reads() const
+    {
+        return readCount.load(std::memory_order_relaxed);
+    }
+};
+
+// offers devices for scanning, and a shared gamepad which reports every
+// device's moves
+class PartBackend : public DeviceBackend
+{
+  private:
+    class Injector : public GamepadInjector
+    {
+      private:
+        std::vector<std::shared_ptr<PartDevice>> devices;
+
+      public:
+        Injector(const std::vector<std::shared_ptr<PartDevice>> &devices)
+            : devices(devices)
+        {
+        }
+        bool initialise() override
+        {
+            return true;
+        }
+        void inject(const GamepadState &state) override
+        {
+            for (auto &device : devices)
+            {
+                device->observe(state);
+            }
+        }
+        void release() override
+        {
+        }
+    };
+
+    std::vector<std::shared_ptr<PartDevice>> devices;
+
+  public:
+    PartBackend(const std::vector<std::shared_ptr<PartDevice>> &devices)
+        : devices(devices)
+    {
+    }
+    std::vector<std::shared_ptr<WheelDevice>> scan() override
+    {
+        return std::vector<std::shared_ptr<WheelDevice>>(devices.begin(),
+                                                         devices.end());
+    }
+    std::unique_ptr<GamepadInjector> createInjector() override
+    {
+        return std::make_unique<Injector>(devices);
+    }
+};
+
+// reports the cost of combining the latest reading of each source
+static void benchMergeCost(int numSources)
+{
+    PartBackend backend({});
+    WheelSettings settings;
+    // keep the merger's own thread from competing with the measurement
+    settings.waitMode = WaitMode::Sleep;
+    GamepadMerger merger(backend, settings);
+    std::string error;
+    merger.start(error);
+    std::vector<std::unique_ptr<GamepadInjector>> sources;
+    for (int i = 0; i < numSources; i++)
+    {
+        sources.push_back(merger.attach(DeviceId{}));
+        GamepadState state;
+        state.leftThumbstickX = (i % 3 - 1) * 0.25;
+        state.rightTrigger = i / 8.0;
+        state.buttons = 1u << i;
+        sources.back()->inject(state);
+    }
+    double ns = Bench::measure(MERGE_ITERATIONS, [&](uint64_t)
+                               { keep(merger.merge()); });
+    std::string name = "merge/merge_" + std::to_string(numSources) + "_sources";
+    Bench::report(name, ns, "ns");
+    if (numSources == 1)
+    {
+        GamepadState state;
+        double writeNs = Bench::measure(
+            MERGE_ITERATIONS, [&](uint64_t i)
+            {
+                state.leftThumbstickX = (i & 255) / 256.0;
+                sources[0]->inject(state);
+            });
+        Bench::report("merge/source_write", writeNs, "ns");
+    }
+    sources.clear();
+    merger.stop();
+}
+
+// reports the time from moving a wheel base, pedals or shifter to the move
+// being injected, through one merged gamepad or a gamepad per device
+static void benchFanIn(bool merged)
+{
+    const char *mode = merged ? "merged" : "separate";
+    Histogram latency;
+    std::vector<std::shared_ptr<PartDevice>> devices = {
+        std::make_shared<PartDevice>(Part::Steering, latency),
+        std::make_shared<PartDevice>(Part::Pedals, latency),
+        std::make_shared<PartDevice>(Part::Shifter, latency)};
+    PartBackend backend(devices);
+    WheelSettings settings;
+    settings.scanInterval = std::chrono::milliseconds(10);
+    settings.mergeWheels = merged;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    auto start = std::chrono::steady_clock::now();
+    for (auto &device : devices)
+    {
+        while (device->reads() == 0 &&
+               std::chrono::steady_clock::now() - start < FIND_TIMEOUT)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    int missed = 0;
+    for (int i = 0; i < TRIALS; i++)
+    {
+        // move at a different point of the poll period each time
+        std::this_thread::sleep_for(TRIAL_SPACING +
+                                    std::chrono::microseconds(i * 37 % 1000));
+        std::shared_ptr<PartDevice> &device = devices[i % devices.size()];
+        missed += !device->move((i / devices.size()) % 2 ? 0.25 : 0.75);
+    }
+    const GamepadMerger *merger = manager.getMerger();
+    int sources = merger ? merger->sources() : 0;
+    manager.stop();
+    std::string name =
+        std::string("merge/fan_in_3_devices/move_to_inject/") + mode;
+    Bench::report(name + "/p50", latency.percentile(0.5) / 1e6, "ms");
+    Bench::report(name + "/p99", latency.percentile(0.99) / 1e6, "ms");
+    Bench::report(name + "/max", latency.max() / 1e6, "ms");
+    Bench::report(name + "/missed", missed, "moves");
+    if (merged)
+    {
+        Bench::report("merge/fan_in_3_devices/sources", sources, "");
+    }
+}
+
+// benchmarks merging several devices into one virtual gamepad
+void benchMerge()
+{
+    OutputManager::getInstance().mute(true);
+    for (int numSources : {1, 2, 4, 8})
+    {
+        benchMergeCost(numSources);
+    }
+    benchFanIn(false);
+    benchFanIn(true);
+    OutputManager::getInstance().mute(false);
+}
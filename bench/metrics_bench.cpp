@@ -0,0 +1,107 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * metrics_bench.cpp                                                          *
+ *                                                                            *
+ * Benchmarks the cost of collecting and serving metrics                      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "metrics_writer.h"
+#include "output_manager.h"
+#include "poll_executor.h"
+#include "replay_backend.h"
+#include "wheel_manager.h"
+
+static const uint64_t ITERATIONS = 1000000;
+static const uint64_t SCRAPES = 1000;
+static const int WHEELS = 8;
+// the poll rate at which each thread's cpu time is sampled once a second
+static const int POLL_RATE_HZ = 1000;
+
+// benchmarks the cost of collecting and serving metrics
+void benchMetrics()
+{
+    // the only addition to each poll is counting it, which a single writer
+    // can do without a locked increment
+    std::atomic<uint64_t> polls{0};
+    Bench::report("metrics/hot_path/count_poll/fetch_add",
+                  Bench::measure(ITERATIONS,
+                                 [&](uint64_t)
+                                 {
+                                     polls.fetch_add(
+                                         1, std::memory_order_relaxed);
+                                 }),
+                  "ns");
+    Bench::report(
+        "metrics/hot_path/count_poll/single_writer",
+        Bench::measure(ITERATIONS,
+                       [&](uint64_t)
+                       {
+                           polls.store(
+                               polls.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+                       }),
+        "ns");
+    keep(polls.load());
+
+    // each poll thread samples its cpu time once per second of ticks
+    uint64_t cpuNs = 0;
+    double sampleNs =
+        Bench::measure(SCRAPES, [&](uint64_t)
+                       { cpuNs += PollExecutor::threadCpuNs(); });
+    keep(cpuNs);
+    Bench::report("metrics/hot_path/sample_thread_cpu", sampleNs, "ns");
+    Bench::report("metrics/hot_path/sample_thread_cpu_per_tick",
+                  sampleNs / POLL_RATE_HZ, "ns");
+
+    // collecting and serving happen off the hot path, once per scrape
+    OutputManager::getInstance().mute(true);
+    ReplayBackend backend;
+    for (int i = 0; i < WHEELS; i++)
+    {
+        backend.connect(std::vector<WheelState>(1), true, 0);
+    }
+    WheelSettings settings;
+    settings.pollRateHz = POLL_RATE_HZ;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    MetricsWriter writer;
+    Bench::report("metrics/collect_8_wheels",
+                  Bench::measure(SCRAPES,
+                                 [&](uint64_t)
+                                 {
+                                     writer.clear();
+                                     manager.writeMetrics(writer);
+                                 }) /
+                      1000,
+                  "us");
+    keep(writer.text().size());
+    manager.stop();
+    OutputManager::getInstance().mute(false);
+}
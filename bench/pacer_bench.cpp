@@ -0,0 +1,129 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pacer_bench.cpp                                                            *
+ *                                                                            *
+ * Benchmarks deadline based pacing against sleeping after each tick          *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <string>
+
+#include "bench.h"
+#include "fake_clock.h"
+#include "pacer.h"
+
+// simulated seconds per scenario
+static const int SIMULATED_SECONDS = 10;
+// simulated work done on each tick
+static const std::chrono::microseconds WORK{150};
+// worst case scheduler oversleep
+static const std::chrono::microseconds OVERSLEEP{900};
+// real time spent measuring each wait mode
+static const std::chrono::milliseconds REAL_DURATION{250};
+
+// returns a printable name for a wait mode
+static std::string modeName(WaitMode mode)
+{
+    switch (mode)
+    {
+    case WaitMode::Sleep:
+        return "sleep";
+    case WaitMode::Spin:
+        return "spin";
+    default:
+        return "hybrid";
+    }
+}
+
+// reports the rate achieved by the previous sleep-after-work loop
+static void runLegacy(int rateHz)
+{
+    FakeClock clock(OVERSLEEP);
+    auto period = std::chrono::nanoseconds(1000000000 / rateHz);
+    auto end = clock.now() + std::chrono::seconds(SIMULATED_SECONDS);
+    uint64_t ticks = 0;
+    while (clock.now() < end)
+    {
+        clock.advance(WORK);
+        clock.sleepUntil(clock.now() + period);
+        ticks++;
+    }
+    Bench::report("pacer/simulated/" + std::to_string(rateHz) +
+                      "/legacy_sleep/rate",
+                  static_cast<double>(ticks) / SIMULATED_SECONDS, "Hz");
+}
+
+// reports the rate and jitter achieved by the pacer on a simulated clock
+static void runSimulated(int rateHz, WaitMode mode)
+{
+    FakeClock clock(OVERSLEEP);
+    Pacer pacer(clock, rateHz, mode, std::chrono::microseconds(1000));
+    auto end = clock.now() + std::chrono::seconds(SIMULATED_SECONDS);
+    while (clock.now() < end)
+    {
+        pacer.wait();
+        clock.advance(WORK);
+    }
+    std::string prefix = "pacer/simulated/" + std::to_string(rateHz) + "/" +
+                         modeName(mode);
+    Bench::report(prefix + "/rate",
+                  static_cast<double>(pacer.ticks()) / SIMULATED_SECONDS,
+                  "Hz");
+    Bench::report(prefix + "/jitter_p99",
+                  pacer.getJitter().percentile(0.99) / 1000.0, "us");
+    Bench::report(prefix + "/missed", static_cast<double>(pacer.missed()),
+                  "ticks");
+}
+
+// reports the jitter achieved by the pacer on the real clock
+static void runReal(WaitMode mode)
+{
+    Clock &clock = SteadyClock::getInstance();
+    Pacer pacer(clock, 1000, mode, std::chrono::microseconds(200));
+    auto start = clock.now();
+    while (clock.now() - start < REAL_DURATION)
+    {
+        pacer.wait();
+    }
+    double seconds = std::chrono::duration<double>(clock.now() - start).count();
+    std::string prefix = "pacer/real/1000/" + modeName(mode);
+    Bench::report(prefix + "/rate", pacer.ticks() / seconds, "Hz");
+    Bench::report(prefix + "/jitter_p50",
+                  pacer.getJitter().percentile(0.5) / 1000.0, "us");
+    Bench::report(prefix + "/jitter_p99",
+                  pacer.getJitter().percentile(0.99) / 1000.0, "us");
+}
+
+// benchmarks deadline based pacing
+void benchPacer()
+{
+    for (int rateHz : {125, 250, 500, 1000})
+    {
+        runLegacy(rateHz);
+        for (WaitMode mode :
+             {WaitMode::Sleep, WaitMode::Spin, WaitMode::Hybrid})
+        {
+            runSimulated(rateHz, mode);
+        }
+    }
+    for (WaitMode mode : {WaitMode::Sleep, WaitMode::Spin, WaitMode::Hybrid})
+    {
+        runReal(mode);
+    }
+}
@@ -0,0 +1,164 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * priority_bench.cpp                                                         *
+ *                                                                            *
+ * Benchmarks polling jitter under cpu load at each thread priority           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "input_pipeline.h"
+#include "output_manager.h"
+#include "poll_executor.h"
+#include "thread_tuning.h"
+
+// real time spent measuring each configuration
+static const std::chrono::milliseconds DURATION{1000};
+
+// simulated wheel polled at a given priority
+class TunedWheel : public Pollable
+{
+  private:
+    FakeSource source;
+    FakeInjector injector;
+    InputPipeline pipeline;
+
+  public:
+    TunedWheel(const WheelSettings &settings)
+        : source(1), injector{}, pipeline(source, injector, settings)
+    {
+    }
+    void poll(Clock::time_point now) override
+    {
+        pipeline.tick(now);
+    }
+};
+
+// keeps every core busy at normal priority, like a game limited by the cpu
+class CpuLoad
+{
+  private:
+    std::atomic<bool> active;
+    std::vector<std::thread> threads;
+
+  public:
+    CpuLoad() : active{false}, threads{}
+    {
+    }
+    ~CpuLoad()
+    {
+        stop();
+    }
+    // starts a busy thread on each core
+    void start()
+    {
+        active.store(true);
+        for (int i = 0; i < ThreadTuning::numCores(); i++)
+        {
+            threads.push_back(std::thread(
+                [this]()
+                {
+                    volatile uint64_t spins = 0;
+                    while (active.load(std::memory_order_relaxed))
+                    {
+                        spins = spins + 1;
+                    }
+                }));
+        }
+    }
+    // stops every busy thread
+    void stop()
+    {
+        active.store(false);
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        threads.clear();
+    }
+};
+
+// returns if this process may raise a thread to real time priority
+static bool realTimeAvailable()
+{
+    bool available = false;
+    std::thread probe(
+        [&available]()
+        {
+            ThreadTuning tuning;
+            std::string error;
+            available = tuning.setPriority(ThreadPriority::RealTime, error);
+        });
+    probe.join();
+    return available;
+}
+
+// polls a wheel on a thread tuned by priority and cores, and reports its
+// jitter
+static void runTuned(const std::string &name, ThreadPriority priority,
+                     const std::vector<int> &cores)
+{
+    WheelSettings settings;
+    settings.pollPriority = priority;
+    settings.pollCores = cores;
+    TunedWheel wheel(settings);
+    PollExecutor executor(SteadyClock::getInstance(), settings, 1);
+    const Pacer *pacer = executor.add(&wheel);
+    executor.start();
+    std::this_thread::sleep_for(DURATION);
+    const Histogram &jitter = pacer->getJitter();
+    uint64_t p99 = jitter.percentile(0.99);
+    uint64_t max = jitter.max();
+    executor.stop();
+    Bench::report("priority/" + name + "/jitter_p99", p99 / 1000.0, "us");
+    Bench::report("priority/" + name + "/jitter_max", max / 1000.0, "us");
+    Bench::report("priority/" + name + "/overruns", executor.missed(), "");
+}
+
+// benchmarks polling jitter under cpu load at each thread priority
+void benchPriority()
+{
+    // failures to raise priority are reported below rather than logged
+    OutputManager::getInstance().mute(true);
+    bool realTime = realTimeAvailable();
+    Bench::report("priority/real_time_available", realTime, "");
+    std::vector<int> lastCore{ThreadTuning::numCores() - 1};
+
+    runTuned("unloaded/normal", ThreadPriority::Normal, {});
+    CpuLoad load;
+    load.start();
+    runTuned("loaded/normal", ThreadPriority::Normal, {});
+    runTuned("loaded/normal_pinned", ThreadPriority::Normal, lastCore);
+    if (realTime)
+    {
+        runTuned("loaded/real_time", ThreadPriority::RealTime, {});
+        runTuned("loaded/real_time_pinned", ThreadPriority::RealTime,
+                 lastCore);
+    }
+    load.stop();
+    OutputManager::getInstance().mute(false);
+}
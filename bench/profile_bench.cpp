@@ -0,0 +1,178 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * profile_bench.cpp                                                          *
+ *                                                                            *
+ * Benchmarks finding and applying cached device profiles                     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "output_manager.h"
+#include "profile_cache.h"
+#include "wheel_settings.h"
+
+// profiles written to the cache
+static const int NUM_PROFILES = 1000;
+// times the warm cache is loaded
+static const int LOADS = 20;
+static const uint64_t LOOKUPS = 1000000;
+static const uint64_t APPLIES = 10000;
+
+// returns the model of the index'th profile
+static DeviceId modelOf(int index)
+{
+    return DeviceId{static_cast<uint16_t>(0x0400 + index / 256),
+                    static_cast<uint16_t>(index % 256 + 1)};
+}
+
+// writes a profile for each model, each with its own mapping, curves,
+// filters and force feedback, and returns their paths
+static std::vector<std::string> writeProfiles(const std::string &directory)
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i < NUM_PROFILES; i++)
+    {
+        DeviceId model = modelOf(i);
+        char device[16];
+        std::snprintf(device, sizeof(device), "%04x:%04x", model.vendor,
+                      model.product);
+        std::string path = directory + "/wheel_" + std::to_string(i) +
+                           ProfileCache::PROFILE_EXTENSION;
+        std::ofstream out(path);
+        out << "device = " << device << "\n"
+            << "button.Button3 = B\n"
+            << "button.Button4 = A\n"
+            << "button.Button" << i % 16 + 1 << " = LB+RB\n"
+            << "axis.steering.inner_deadzone = 0.0" << i % 5 << "\n"
+            << "axis.steering.gamma = 1." << i % 9 << "\n"
+            << "axis.throttle.curve = 0:0 0.2:0.1 0.4:0.25 0.6:0.45 "
+               "0.8:0.7 1:1\n"
+            << "axis.brake.curve = 0:0 0.3:0.1 0.7:0.6 1:1\n"
+            << "axis.brake.invert = " << (i % 2 ? "true" : "false") << "\n"
+            << "filter.steering.min_cutoff = 1\n"
+            << "filter.steering.beta = 0.5\n"
+            << "filter.brake.quantise = 0.005\n"
+            << "filter.brake.hysteresis = 0.002\n"
+            << "ffb.spring = 0." << i % 10 << "\n"
+            << "ffb.damper = 0.05\n";
+        paths.push_back(path);
+    }
+    return paths;
+}
+
+// benchmarks finding and applying cached device profiles
+void benchProfile()
+{
+    OutputManager::getInstance().mute(true);
+    namespace fs = std::filesystem;
+    std::string directory =
+        (fs::temp_directory_path() / "xwcs_profile_bench").string();
+    fs::remove_all(directory);
+    fs::create_directories(directory);
+    std::vector<std::string> paths = writeProfiles(directory);
+    std::string prefix =
+        "profile/" + std::to_string(NUM_PROFILES) + "_profiles";
+
+    // the first load compiles the cache, later loads only map it
+    std::string error;
+    auto start = std::chrono::steady_clock::now();
+    ProfileCache cold;
+    bool loaded = cold.load(directory, error) && cold.rebuilt();
+    double coldMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count();
+    Bench::report(prefix + "/load/compile", loaded ? coldMs : -1, "ms");
+    start = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<ProfileCache>> warm;
+    for (int i = 0; i < LOADS; i++)
+    {
+        warm.push_back(std::make_unique<ProfileCache>());
+        loaded = warm.back()->load(directory, error) &&
+                 !warm.back()->rebuilt() && loaded;
+    }
+    double warmMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - start)
+                        .count() /
+                    LOADS;
+    Bench::report(prefix + "/load/mapped", loaded ? warmMs : -1, "ms");
+    warm.clear();
+    ProfileCache &cache = cold;
+
+    // models looked up in a random order, so each lookup misses the cache
+    // of the one before
+    std::mt19937 random(42);
+    std::vector<DeviceId> hits;
+    std::vector<DeviceId> misses;
+    for (int i = 0; i < 4096; i++)
+    {
+        hits.push_back(modelOf(random() % NUM_PROFILES));
+        misses.push_back(DeviceId{0x9999, static_cast<uint16_t>(i)});
+    }
+    int found = 0;
+    double hitNs = Bench::measure(LOOKUPS, [&](uint64_t i)
+                                  { found += cache.find(hits[i & 4095]) !=
+                                             nullptr; });
+    double missNs = Bench::measure(LOOKUPS, [&](uint64_t i)
+                                   { found += cache.find(misses[i & 4095]) !=
+                                              nullptr; });
+    Bench::report(prefix + "/lookup/hit", hitNs, "ns");
+    Bench::report(prefix + "/lookup/miss", missNs, "ns");
+    Bench::report(prefix + "/lookup/found",
+                  static_cast<double>(found) / LOOKUPS, "");
+
+    // applying a profile as a wheel connects, against parsing its text
+    WheelSettings settings;
+    double applyUs = Bench::measure(
+                         APPLIES,
+                         [&](uint64_t i)
+                         {
+                             WheelSettings tuned(settings);
+                             ProfileCache::apply(*cache.find(hits[i & 4095]),
+                                                 tuned);
+                             keep(tuned.forceFeedback.spring);
+                         }) /
+                     1000.0;
+    double parseUs =
+        Bench::measure(NUM_PROFILES,
+                       [&](uint64_t i)
+                       {
+                           Profile profile;
+                           CachedProfile record;
+                           WheelSettings tuned(settings);
+                           Profile::load(paths[i], profile, error);
+                           ProfileCache::record(profile, record, error);
+                           ProfileCache::apply(record, tuned);
+                           keep(tuned.forceFeedback.spring);
+                       }) /
+        1000.0;
+    Bench::report(prefix + "/apply/cached", applyUs, "us");
+    Bench::report(prefix + "/apply/parsed", parseUs, "us");
+
+    fs::remove_all(directory);
+    OutputManager::getInstance().mute(false);
+}
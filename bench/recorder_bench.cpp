@@ -0,0 +1,117 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * recorder_bench.cpp                                                         *
+ *                                                                            *
+ * Benchmarks the cost of recording a session                                 *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "fake_devices.h"
+#include "input_pipeline.h"
+#include "session_recorder.h"
+
+// written to the working directory and removed afterwards
+static const char *RECORDING_PATH = "wheel_bench_recording.bin";
+// ticks timed with and without recording
+static const uint64_t TICKS = 60000;
+// wheels recorded at 1000 Hz for the sustained scenario
+static const int WHEELS = 8;
+static const int SUSTAINED_MS = 1000;
+
+// times pipeline ticks with the given recorder, or none if null
+static double timeTicks(SessionRecorder *recorder)
+{
+    FakeSource source(1);
+    FakeInjector injector;
+    WheelSettings settings;
+    InputPipeline pipeline(source, injector, settings);
+    std::shared_ptr<RecordChannel> channel;
+    if (recorder)
+    {
+        channel = recorder->attach();
+        pipeline.setRecorder(channel.get());
+    }
+    std::chrono::steady_clock::time_point now{};
+    double ns = Bench::measure(TICKS,
+                               [&](uint64_t)
+                               {
+                                   pipeline.tick(now);
+                                   now += std::chrono::milliseconds(1);
+                               });
+    keep(injector.lastInjected());
+    if (recorder)
+    {
+        recorder->detach(channel);
+    }
+    return ns;
+}
+
+// benchmarks the cost of recording a session
+void benchRecorder()
+{
+    SessionRecorder recorder;
+    std::string error;
+    if (!recorder.open(RECORDING_PATH, error))
+    {
+        Bench::report("recorder/unavailable", 0, error);
+        return;
+    }
+
+    Bench::report("recorder/tick/not_recording", timeTicks(nullptr), "ns");
+    // ticks back to back fill the ring faster than the writer drains it
+    Bench::report("recorder/tick/recording", timeTicks(&recorder), "ns");
+    uint64_t burstDropped = recorder.dropped();
+    Bench::report("recorder/unpaced_burst/dropped", burstDropped, "records");
+
+    // several wheels recorded at their real rate
+    std::vector<std::shared_ptr<RecordChannel>> channels;
+    for (int i = 0; i < WHEELS; i++)
+    {
+        channels.push_back(recorder.attach());
+    }
+    WheelSample sample{};
+    auto next = std::chrono::steady_clock::now();
+    for (int ms = 0; ms < SUSTAINED_MS; ms++)
+    {
+        next += std::chrono::milliseconds(1);
+        std::this_thread::sleep_until(next);
+        for (const std::shared_ptr<RecordChannel> &channel : channels)
+        {
+            sample.input.timestamp = ms;
+            channel->record(sample, next);
+        }
+    }
+    for (const std::shared_ptr<RecordChannel> &channel : channels)
+    {
+        recorder.detach(channel);
+    }
+    recorder.close();
+    Bench::report("recorder/8_wheels_1000hz/dropped",
+                  recorder.dropped() - burstDropped, "records");
+    Bench::report("recorder/written", recorder.written(), "records");
+    Bench::report("recorder/write_failed", recorder.failed(), "");
+    std::remove(RECORDING_PATH);
+}
@@ -0,0 +1,121 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * snapshot_bench.cpp                                                         *
+ *                                                                            *
+ * Benchmarks seqlock snapshot writes under concurrent readers                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "input_types.h"
+#include "snapshot.h"
+
+// writes timed per configuration
+static const uint64_t WRITES = 2000000;
+
+// times writes while the given number of threads read continuously
+static void runWriters(int numReaders)
+{
+    Snapshot<WheelSample> snapshot;
+    std::atomic<bool> reading{true};
+    std::atomic<uint64_t> reads{0};
+    std::atomic<uint64_t> torn{0};
+    std::vector<std::thread> readers;
+    for (int i = 0; i < numReaders; i++)
+    {
+        readers.emplace_back(
+            [&]()
+            {
+                uint64_t count = 0;
+                while (reading.load(std::memory_order_relaxed))
+                {
+                    // every field of a sample is written with the same value
+                    WheelSample sample = snapshot.read();
+                    if (sample.output.leftThumbstickX != sample.input.wheel ||
+                        sample.output.timestamp != sample.input.timestamp)
+                    {
+                        torn.fetch_add(1);
+                    }
+                    count++;
+                }
+                reads.fetch_add(count);
+            });
+    }
+
+    WheelSample sample{};
+    double ns = Bench::measure(WRITES,
+                               [&](uint64_t i)
+                               {
+                                   sample.input.timestamp = i;
+                                   sample.input.wheel = static_cast<double>(i);
+                                   sample.output.timestamp = i;
+                                   sample.output.leftThumbstickX =
+                                       static_cast<double>(i);
+                                   snapshot.write(sample);
+                               });
+    reading.store(false);
+    for (std::thread &reader : readers)
+    {
+        reader.join();
+    }
+
+    std::string prefix = "snapshot/" + std::to_string(numReaders) + "_readers";
+    Bench::report(prefix + "/write", ns, "ns");
+    if (numReaders > 0)
+    {
+        Bench::report(prefix + "/reads", static_cast<double>(reads.load()),
+                      "reads");
+        Bench::report(prefix + "/torn_reads", static_cast<double>(torn.load()),
+                      "reads");
+    }
+}
+
+// benchmarks seqlock snapshot reads and writes under contention
+void benchSnapshot()
+{
+    Snapshot<WheelSample> snapshot;
+    double ns = Bench::measure(WRITES,
+                               [&](uint64_t) { keep(snapshot.read()); });
+    Bench::report("snapshot/uncontended/read", ns, "ns");
+
+    // reads while a wheel publishes at full speed, retrying torn reads
+    std::atomic<bool> writing{true};
+    std::thread writer(
+        [&]()
+        {
+            WheelSample sample{};
+            while (writing.load(std::memory_order_relaxed))
+            {
+                sample.input.timestamp++;
+                snapshot.write(sample);
+            }
+        });
+    ns = Bench::measure(WRITES, [&](uint64_t) { keep(snapshot.read()); });
+    writing.store(false);
+    writer.join();
+    Bench::report("snapshot/1_writer/read", ns, "ns");
+    for (int numReaders : {0, 1, 4})
+    {
+        runWriters(numReaders);
+    }
+}
@@ -0,0 +1,147 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * stop_bench.cpp                                                             *
+ *                                                                            *
+ * Benchmarks how quickly polling and telemetry stop once asked               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "histogram.h"
+#include "output_manager.h"
+#include "replay_backend.h"
+#include "wheel_manager.h"
+
+// wheels polled when stopping
+static const int NUM_WHEELS = 8;
+// times the service is started and stopped for each configuration
+static const int TRIALS = 10;
+// time allowed for every wheel to be polled before a trial is abandoned
+static const std::chrono::milliseconds START_TIMEOUT{3000};
+// time without changes before still wheels are polled at the idle rate
+static const std::chrono::milliseconds IDLE_TIMEOUT{20};
+
+// returns the ns taken by fn
+template <typename Fn> static uint64_t timeCall(Fn fn)
+{
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// starts NUM_WHEELS wheels, returns false if any was not polled in time
+static bool startWheels(ReplayBackend &bus, WheelManager &manager,
+                        std::vector<std::shared_ptr<ReplayDevice>> &devices)
+{
+    for (int i = 0; i < NUM_WHEELS; i++)
+    {
+        devices.push_back(bus.connect(std::vector<WheelState>(1), true, 0));
+    }
+    manager.start();
+    auto start = std::chrono::steady_clock::now();
+    for (auto &device : devices)
+    {
+        while (device->injected() == 0)
+        {
+            if (std::chrono::steady_clock::now() - start > START_TIMEOUT)
+            {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    return true;
+}
+
+// reports the time to stop the service while polling NUM_WHEELS wheels
+// waiting in mode, which have gone idle if idle is set
+static void benchStop(bool idle, WaitMode mode)
+{
+    Histogram latency;
+    int failed = 0;
+    for (int i = 0; i < TRIALS; i++)
+    {
+        ReplayBackend bus;
+        WheelSettings settings;
+        settings.waitMode = mode;
+        if (idle)
+        {
+            settings.idleTimeout = IDLE_TIMEOUT;
+        }
+        WheelManager manager(bus, settings, nullptr, nullptr);
+        std::vector<std::shared_ptr<ReplayDevice>> devices;
+        if (!startWheels(bus, manager, devices))
+        {
+            failed++;
+            manager.stop();
+            continue;
+        }
+        // let the wheels go idle, and stop at a different point of the
+        // poll period each time
+        std::this_thread::sleep_for(IDLE_TIMEOUT * 3 +
+                                    std::chrono::microseconds(i * 731));
+        latency.record(timeCall([&] { manager.stop(); }));
+    }
+    std::string name = "stop/" + std::to_string(NUM_WHEELS) + "_wheels/" +
+                       (idle ? "idle" : "full_rate") +
+                       (mode == WaitMode::Hybrid ? "_hybrid" : "");
+    Bench::report(name + "/p50", latency.percentile(0.5) / 1e6, "ms");
+    Bench::report(name + "/max", latency.max() / 1e6, "ms");
+    Bench::report(name + "/failed", failed, "trials");
+}
+
+// reports the time to stop telemetry while it waits for its next frame,
+// without wheels, as telemetry is drawn even while output is muted
+static void benchTelemetryToggle()
+{
+    ReplayBackend bus;
+    WheelSettings settings;
+    WheelManager manager(bus, settings, nullptr, nullptr);
+    manager.start();
+    Histogram latency;
+    for (int i = 0; i < TRIALS; i++)
+    {
+        manager.startTelemetry();
+        // stop at a different point between frames each time
+        std::this_thread::sleep_for(std::chrono::milliseconds(10 + i * 17));
+        latency.record(timeCall([&] { manager.stopTelemetry(); }));
+    }
+    manager.stop();
+    Bench::report("stop/telemetry/p50", latency.percentile(0.5) / 1e6, "ms");
+    Bench::report("stop/telemetry/max", latency.max() / 1e6, "ms");
+}
+
+// benchmarks how quickly polling and telemetry stop once asked
+void benchStop()
+{
+    OutputManager::getInstance().mute(true);
+    benchStop(false, WaitMode::Sleep);
+    benchStop(false, WaitMode::Hybrid);
+    benchStop(true, WaitMode::Sleep);
+    benchTelemetryToggle();
+    OutputManager::getInstance().mute(false);
+}
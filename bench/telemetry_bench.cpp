@@ -0,0 +1,210 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_bench.cpp                                                        *
+ *                                                                            *
+ * Benchmarks drawing telemetry for several wheels                            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <cmath>
+#include <iomanip>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "button_map.h"
+#include "fake_clock.h"
+#include "telemetry_renderer.h"
+#include "telemetry_view.h"
+
+static const int WHEELS = 8;
+// frames drawn per scenario
+static const uint64_t FRAMES = 2000;
+static const int OUTPUT_WIDTH = 80;
+
+// discards everything written to it
+class NullBuffer : public std::streambuf
+{
+  protected:
+    int overflow(int c) override
+    {
+        return c;
+    }
+    std::streamsize xsputn(const char *, std::streamsize count) override
+    {
+        return count;
+    }
+};
+
+// a wheel whose values move with time, as they would while driving
+struct SimulatedWheel
+{
+    std::unique_ptr<Pacer> pacer;
+    std::unique_ptr<Histogram> latency[InputPipeline::NUM_STAGES];
+    WheelTelemetry telemetry;
+};
+
+// moves every wheel forward by one frame
+static void advance(std::vector<SimulatedWheel> &wheels, uint64_t frame,
+                    int rateHz)
+{
+    double seconds = static_cast<double>(frame) / rateHz;
+    for (size_t i = 0; i < wheels.size(); i++)
+    {
+        WheelTelemetry &telemetry = wheels[i].telemetry;
+        telemetry.output.leftThumbstickX = std::sin(seconds + i);
+        telemetry.output.rightTrigger = (1 + std::sin(seconds * 3 + i)) / 2;
+        telemetry.output.leftTrigger = seconds - std::floor(seconds);
+        telemetry.output.buttons = 1u << (frame / rateHz % 14);
+        telemetry.injected += 1000 / rateHz;
+        for (std::unique_ptr<Histogram> &latency : wheels[i].latency)
+        {
+            latency->record(1000 + frame % 500);
+        }
+    }
+}
+
+// formats the wheels as telemetry did before frames were diffed
+static std::vector<std::string>
+legacyLines(const std::vector<SimulatedWheel> &wheels)
+{
+    std::stringstream ss;
+    std::vector<std::string> output;
+    output.push_back("");
+    for (size_t i = 0; i < wheels.size(); i++)
+    {
+        const GamepadState &reading = wheels[i].telemetry.output;
+        ss << "Wheel " << i + 1;
+        output.push_back(ss.str());
+        ss.str("");
+        ss << "Steering: " << std::fixed << std::setw(7) << std::showpoint
+           << std::setprecision(2) << reading.leftThumbstickX * 100 << "%";
+        output.push_back(ss.str());
+        ss.str("");
+        ss << "Throttle: " << std::fixed << std::setw(7) << std::showpoint
+           << std::setprecision(2) << reading.rightTrigger * 100 << "%";
+        output.push_back(ss.str());
+        ss.str("");
+        ss << "Brake: " << std::fixed << std::setw(10) << std::showpoint
+           << std::setprecision(2) << reading.leftTrigger * 100 << "%";
+        output.push_back(ss.str());
+        ss.str("");
+        ss << "Buttons: " << ButtonMap::describe(reading.buttons);
+        output.push_back(ss.str());
+        ss.str("");
+        ss << "Injected: " << wheels[i].telemetry.injected
+           << "  Skipped: " << wheels[i].telemetry.skipped;
+        output.push_back(ss.str());
+        ss.str("");
+        for (int stage = 0; stage < InputPipeline::NUM_STAGES; stage++)
+        {
+            auto timed = static_cast<InputPipeline::Stage>(stage);
+            ss << InputPipeline::stageName(timed) << " p50/p99/p99.9/max: "
+               << wheels[i].latency[stage]->describe();
+            output.push_back(ss.str());
+            ss.str("");
+        }
+        const Pacer *pacer = wheels[i].telemetry.pacer;
+        const Histogram &jitter = pacer->getJitter();
+        ss << "Rate: " << pacer->rate() << " Hz  Missed: " << pacer->missed()
+           << "  Jitter p50/p99/max: " << std::setprecision(1)
+           << jitter.percentile(0.5) / 1000.0 << "/"
+           << jitter.percentile(0.99) / 1000.0 << "/" << jitter.max() / 1000.0
+           << " us";
+        output.push_back(ss.str());
+        ss.str("");
+        output.push_back("");
+    }
+    return output;
+}
+
+// prints lines as telemetry did before frames were diffed
+static void legacyPrint(std::ostream &stream, std::vector<std::string> lines)
+{
+    for (std::string line : lines)
+    {
+        stream << std::left << std::setw(OUTPUT_WIDTH) << line << std::endl;
+    }
+}
+
+// times drawing frames at a rate, both ways
+static void runScenario(int rateHz)
+{
+    FakeClock clock(std::chrono::nanoseconds(0));
+    std::vector<SimulatedWheel> wheels(WHEELS);
+    for (SimulatedWheel &wheel : wheels)
+    {
+        wheel.pacer = std::make_unique<Pacer>(
+            clock, 1000, WaitMode::Sleep, std::chrono::microseconds(0));
+        wheel.telemetry.pacer = wheel.pacer.get();
+        for (int i = 0; i < InputPipeline::NUM_STAGES; i++)
+        {
+            wheel.latency[i] = std::make_unique<Histogram>();
+            wheel.telemetry.latency[i] = wheel.latency[i].get();
+        }
+    }
+
+    TelemetryFrame frame;
+    TelemetryRenderer renderer;
+    uint64_t bytes = 0;
+    double diffNs = Bench::measure(
+        FRAMES,
+        [&](uint64_t i)
+        {
+            advance(wheels, i, rateHz);
+            frame.clear();
+            frame.print("%s", "");
+            for (size_t w = 0; w < wheels.size(); w++)
+            {
+                TelemetryView::addWheel(frame, static_cast<int>(w + 1),
+                                        wheels[w].telemetry);
+            }
+            bytes += renderer.render(frame).size();
+        });
+
+    NullBuffer nullBuffer;
+    std::ostream nullStream(&nullBuffer);
+    double legacyNs = Bench::measure(FRAMES,
+                                     [&](uint64_t i)
+                                     {
+                                         advance(wheels, i, rateHz);
+                                         legacyPrint(nullStream,
+                                                     legacyLines(wheels));
+                                     });
+
+    std::string prefix = "telemetry/8_wheels_" + std::to_string(rateHz) + "hz";
+    Bench::report(prefix + "/legacy_frame", legacyNs, "ns");
+    Bench::report(prefix + "/diff_frame", diffNs, "ns");
+    Bench::report(prefix + "/diff_cpu_per_s", diffNs * rateHz / 1000.0,
+                  "us/s");
+    Bench::report(prefix + "/diff_bytes_per_frame",
+                  static_cast<double>(bytes) / FRAMES, "B");
+    Bench::report(prefix + "/full_frame_bytes",
+                  static_cast<double>(frame.rows()) * TelemetryFrame::WIDTH,
+                  "B");
+}
+
+// benchmarks drawing telemetry for several wheels
+void benchTelemetry()
+{
+    runScenario(10);
+    runScenario(60);
+}
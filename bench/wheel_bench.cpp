@@ -0,0 +1,239 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wheel_bench.cpp                                                            *
+ *                                                                            *
+ * The entry point of the benchmark suite                                     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "bench.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// a group of benchmarks which can be run on its own
+struct Suite
+{
+    const char *name;
+    void (*run)();
+};
+
+static const Suite SUITES[] = {
+    {"injection", benchInjection},
+    {"pacer", benchPacer},
+    {"executor", benchExecutor},
+    {"snapshot", benchSnapshot},
+    {"button_map", benchButtonMap},
+    {"axis_curve", benchAxisCurve},
+    {"axis_filter", benchAxisFilter},
+    {"recorder", benchRecorder},
+    {"latency", benchLatency},
+    {"telemetry", benchTelemetry},
+    {"log", benchLog},
+    {"discovery", benchDiscovery},
+    {"init", benchInit},
+    {"injector_pool", benchInjectorPool},
+    {"metrics", benchMetrics},
+    {"force_feedback", benchForceFeedback},
+    {"evdev", benchEvdev},
+    {"idle", benchIdle},
+    {"priority", benchPriority},
+    {"stop", benchStop},
+    {"merge", benchMerge},
+    {"profile", benchProfile},
+};
+
+std::vector<Bench::Result> Bench::results;
+int Bench::failures = 0;
+
+// returns text quoted as a JSON string
+static std::string quote(const std::string &text)
+{
+    std::string quoted = "\"";
+    for (char c : text)
+    {
+        if (c == '"' || c == '\\')
+        {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// returns the cpu time used by the process in seconds
+double Bench::cpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+    // FILETIME counts 100 ns intervals
+    auto toSeconds = [](const FILETIME &time)
+    {
+        return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) |
+                time.dwLowDateTime) /
+               1e7;
+    };
+    return toSeconds(kernel) + toSeconds(user);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+// prints a single result
+void Bench::report(const std::string &name, double value,
+                   const std::string &unit)
+{
+    std::cout << std::left << std::setw(56) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(2) << value
+              << " " << unit << std::endl;
+    results.push_back(Result{name, value, unit});
+}
+
+// prints a result which missed its target, so the run fails
+void Bench::fail(const std::string &message)
+{
+    std::cout << "FAIL " << message << std::endl;
+    failures++;
+}
+
+// returns the number of results which missed their target
+int Bench::failed()
+{
+    return failures;
+}
+
+// writes every reported result to path as JSON, returns false on failure
+bool Bench::writeJson(const std::string &path)
+{
+    std::ofstream file(path);
+    if (!file)
+    {
+        return false;
+    }
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ",
+                  std::gmtime(&now));
+    file << "{\n  \"context\": {\"date\": " << quote(date)
+         << ", \"cpus\": " << std::thread::hardware_concurrency()
+         << "},\n  \"results\": [";
+    file << std::setprecision(10);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        // JSON has no representation of infinity or NaN
+        double value = std::isfinite(results[i].value) ? results[i].value : 0;
+        file << (i == 0 ? "\n" : ",\n") << "    {\"name\": "
+             << quote(results[i].name) << ", \"value\": " << value
+             << ", \"unit\": " << quote(results[i].unit) << "}";
+    }
+    file << "\n  ]\n}\n";
+    return static_cast<bool>(file);
+}
+
+int main(int argc, char **argv)
+{
+    std::string jsonPath;
+    std::vector<std::string> selected;
+    // parse command line arguments
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc)
+        {
+            jsonPath = argv[++i];
+        }
+        else if (arg == "-s" && i + 1 < argc)
+        {
+            selected.push_back(argv[++i]);
+        }
+        else
+        {
+            // print help message
+            std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl
+                      << std::endl
+                      << "Options:" << std::endl
+                      << "-h Show this help message and exit" << std::endl
+                      << "-j <file> Write results to a JSON file" << std::endl
+                      << "-s <suite> Only run a suite, may be repeated"
+                      << std::endl
+                      << std::endl
+                      << "Suites:";
+            for (const Suite &suite : SUITES)
+            {
+                std::cout << " " << suite.name;
+            }
+            std::cout << std::endl;
+            return arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    for (const std::string &name : selected)
+    {
+        bool found = false;
+        for (const Suite &suite : SUITES)
+        {
+            found = found || name == suite.name;
+        }
+        if (!found)
+        {
+            std::cerr << "Unknown suite " << name << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (const Suite &suite : SUITES)
+    {
+        bool run = selected.empty();
+        for (const std::string &name : selected)
+        {
+            run = run || name == suite.name;
+        }
+        if (run)
+        {
+            suite.run();
+        }
+    }
+    if (!jsonPath.empty() && !Bench::writeJson(jsonPath))
+    {
+        std::cerr << "Unable to write " << jsonPath << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (Bench::failed() > 0)
+    {
+        std::cerr << "Results missing their target: " << Bench::failed()
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,180 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * evdev_check.cpp                                                            *
+ *                                                                            *
+ * Checks the evdev backend end to end, from a virtual wheel to the virtual   *
+ * gamepad                                                                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "evdev_check.h"
+
+#ifdef __linux__
+#include <chrono>
+#include <cmath>
+
+#include "evdev_backend.h"
+#include "histogram.h"
+#include "virtual_wheel.h"
+#include "wheel_manager.h"
+
+static const std::chrono::milliseconds DISCOVERY_TIMEOUT{2000};
+static const std::chrono::milliseconds FRAME_TIMEOUT{200};
+// frames sent, stepping through the script so the wheel turns every frame
+static const size_t NUM_FRAMES = 200;
+static const size_t SCRIPT_STEP = 7;
+// error allowed from the wheel and the gamepad each rounding an axis
+static const double STICK_ERROR = 1.5 / 32767;
+static const double TRIGGER_ERROR = 1.5 / 1023;
+
+// the default layout of the buttons an evdev wheel can report
+static const struct
+{
+    uint32_t wheel;
+    uint32_t pad;
+} DEFAULT_BUTTONS[] = {
+    {WheelButtons::DPadUp, PadButtons::DPadUp},
+    {WheelButtons::DPadDown, PadButtons::DPadDown},
+    {WheelButtons::DPadLeft, PadButtons::DPadLeft},
+    {WheelButtons::DPadRight, PadButtons::DPadRight},
+    {WheelButtons::Button1, PadButtons::Menu},
+    {WheelButtons::Button2, PadButtons::View},
+    {WheelButtons::Button3, PadButtons::A},
+    {WheelButtons::Button4, PadButtons::B},
+    {WheelButtons::Button5, PadButtons::X},
+    {WheelButtons::Button6, PadButtons::Y},
+};
+
+// returns if a reading was mapped to the output of the default layout, to
+// within the resolution of the devices
+static bool expectedFrame(const WheelState &input, const GamepadState &output)
+{
+    uint32_t buttons = PadButtons::None;
+    for (const auto &route : DEFAULT_BUTTONS)
+    {
+        if (input.buttons & route.wheel)
+        {
+            buttons |= route.pad;
+        }
+    }
+    return output.buttons == buttons &&
+           std::fabs(output.leftThumbstickX - input.wheel) <= STICK_ERROR &&
+           std::fabs(output.leftTrigger - input.brake) <= TRIGGER_ERROR &&
+           std::fabs(output.rightTrigger - input.throttle) <= TRIGGER_ERROR &&
+           output.leftThumbstickY == 0.0 && output.rightThumbstickX == 0.0 &&
+           output.rightThumbstickY == 0.0;
+}
+
+// plugs a wheel created through uinput into a running wheel manager using the
+// evdev backend, sends it readings of script, and returns why the gamepad it
+// creates misreported them or outlived the wheel, or an empty string if it
+// did not, sets skipped and returns why if uinput is unavailable
+std::string checkEvdev(const std::vector<WheelState> &script,
+                       const WheelSettings &settings,
+                       EvdevCheckResult &result)
+{
+    if (script.empty())
+    {
+        result.skipped = true;
+        return "there is no script to send";
+    }
+    EvdevBackend backend;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    // plug the wheel in once the manager is running, so it is found through
+    // inotify and read through epoll rather than found by the first scan
+    std::string error;
+    VirtualWheel wheel;
+    if (!wheel.create(error))
+    {
+        manager.stop();
+        result.skipped = true;
+        return error;
+    }
+    GamepadReader gamepad;
+    if (!gamepad.open(UinputGamepadInjector::GAMEPAD_NAME, DISCOVERY_TIMEOUT))
+    {
+        manager.stop();
+        return "the wheel was not discovered";
+    }
+
+    Histogram latency;
+    for (size_t i = 0; i < NUM_FRAMES; i++)
+    {
+        WheelState state = script[i * SCRIPT_STEP % script.size()];
+        // evdev wheels have no gear buttons
+        state.buttons &= ~(WheelButtons::PreviousGear | WheelButtons::NextGear);
+        auto sent = std::chrono::steady_clock::now();
+        if (!wheel.send(state))
+        {
+            manager.stop();
+            return "the wheel could not send a frame";
+        }
+        result.checked++;
+        // earlier frames may still be arriving
+        GamepadState output;
+        bool matched = false;
+        while (!matched && gamepad.next(output, FRAME_TIMEOUT))
+        {
+            matched = expectedFrame(state, output);
+        }
+        if (!matched)
+        {
+            result.mismatches++;
+            continue;
+        }
+        latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - sent)
+                           .count());
+    }
+    result.latencyP50 = latency.percentile(0.5);
+    result.latencyMax = latency.max();
+
+    // unplugging the wheel removes its gamepad
+    wheel.destroy();
+    GamepadState output;
+    auto deadline = std::chrono::steady_clock::now() + DISCOVERY_TIMEOUT;
+    while (!gamepad.disconnected() &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        gamepad.next(output, FRAME_TIMEOUT);
+    }
+    manager.stop();
+    if (!gamepad.disconnected())
+    {
+        return "the gamepad outlived its wheel";
+    }
+    if (result.mismatches > 0)
+    {
+        return std::to_string(result.mismatches) + " of " +
+               std::to_string(result.checked) + " frames were misreported";
+    }
+    return "";
+}
+#else
+// sends readings of script from a wheel created through uinput, which only
+// Linux has
+std::string checkEvdev(const std::vector<WheelState> &script,
+                       const WheelSettings &settings,
+                       EvdevCheckResult &result)
+{
+    result.skipped = true;
+    return "evdev is only available on Linux";
+}
+#endif
@@ -0,0 +1,58 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * evdev_check.h                                                              *
+ *                                                                            *
+ * Checks the evdev backend end to end, from a virtual wheel to the virtual   *
+ * gamepad                                                                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef EVDEV_CHECK_H
+#define EVDEV_CHECK_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "input_types.h"
+#include "wheel_settings.h"
+
+// what the virtual gamepad reported of a virtual wheel
+struct EvdevCheckResult
+{
+    // uinput is unavailable, so nothing was checked
+    bool skipped = false;
+    // frames sent by the wheel
+    uint64_t checked = 0;
+    // frames the gamepad reported wrongly or not at all
+    uint64_t mismatches = 0;
+    // ns from the wheel sending a frame to the gamepad reporting it
+    uint64_t latencyP50 = 0;
+    uint64_t latencyMax = 0;
+};
+
+// plugs a wheel created through uinput into a running wheel manager using the
+// evdev backend, sends it readings of script, and returns why the gamepad it
+// creates misreported them or outlived the wheel, or an empty string if it
+// did not, sets skipped and returns why if uinput is unavailable
+std::string checkEvdev(const std::vector<WheelState> &script,
+                       const WheelSettings &settings,
+                       EvdevCheckResult &result);
+
+#endif
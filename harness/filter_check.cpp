@@ -0,0 +1,213 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * filter_check.cpp                                                           *
+ *                                                                            *
+ * Checks the axis filters against a trace of wheel readings                  *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "filter_check.h"
+
+#include <cmath>
+#include <cstring>
+
+#include "axis_filter.h"
+
+static const int RATE_HZ = 1000;
+// peak noise added to each axis, about what a worn potentiometer shows
+static const double NOISE = 0.002;
+static const int LANES = AxisFilterBank::LANES;
+
+// the axes of one reading, one per lane
+struct Axes
+{
+    double values[LANES];
+};
+
+// returns the axes of trace with deterministic noise added
+static std::vector<Axes> noisy(const std::vector<WheelState> &trace)
+{
+    std::vector<Axes> samples(trace.size());
+    uint32_t seed = 11;
+    for (size_t i = 0; i < trace.size(); i++)
+    {
+        double axes[LANES] = {trace[i].wheel, trace[i].throttle,
+                              trace[i].brake, 0.0};
+        for (int lane = 0; lane < LANES; lane++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            double noise = NOISE * (((seed >> 8) & 0xffff) / 32767.5 - 1.0);
+            samples[i].values[lane] = axes[lane] + noise;
+        }
+    }
+    return samples;
+}
+
+// filters samples through filter on every lane
+static std::vector<Axes> run(const AxisFilter &filter,
+                             const std::vector<Axes> &samples)
+{
+    AxisFilterBank bank;
+    const AxisFilter *const lanes[LANES] = {&filter, &filter, &filter,
+                                            &filter};
+    bank.configure(lanes, RATE_HZ);
+    std::vector<Axes> filtered = samples;
+    for (Axes &axes : filtered)
+    {
+        bank.process(axes.values);
+    }
+    return filtered;
+}
+
+// returns the number of samples after the first whose lane changed
+static int changes(const std::vector<Axes> &samples, int lane)
+{
+    int count = 0;
+    for (size_t i = 1; i < samples.size(); i++)
+    {
+        count += samples[i].values[lane] != samples[i - 1].values[lane];
+    }
+    return count;
+}
+
+// filters the axes of trace, with added noise, through each filter and
+// returns why a filter misbehaved, or an empty string if none did
+std::string checkFilters(const std::vector<WheelState> &trace)
+{
+    if (trace.size() < 2)
+    {
+        return "";
+    }
+    std::vector<Axes> samples = noisy(trace);
+
+    // disabled filters pass readings through exactly
+    if (std::memcmp(run(AxisFilter{}, samples).data(), samples.data(),
+                    samples.size() * sizeof(Axes)) != 0)
+    {
+        return "disabled filters changed readings";
+    }
+
+    // the same trace always filters to the same output
+    AxisFilter chain;
+    chain.minCutoff = 1.0;
+    chain.beta = 0.5;
+    chain.lowPassHz = 60.0;
+    chain.slewRate = 20.0;
+    chain.quantise = 0.005;
+    chain.hysteresis = 0.002;
+    std::vector<Axes> first = run(chain, samples);
+    std::vector<Axes> second = run(chain, samples);
+    if (std::memcmp(first.data(), second.data(),
+                    first.size() * sizeof(Axes)) != 0)
+    {
+        return "filter chain is not deterministic";
+    }
+
+    // the low pass follows its closed form step response
+    AxisFilter lowPass;
+    lowPass.lowPassHz = 30.0;
+    std::vector<Axes> step(trace.size(), Axes{});
+    for (size_t i = 1; i < step.size(); i++)
+    {
+        step[i].values[0] = 1.0;
+    }
+    std::vector<Axes> response = run(lowPass, step);
+    double alpha = 1.0 / (1.0 + RATE_HZ / (2.0 * std::acos(-1.0) * 30.0));
+    for (size_t i = 1; i < response.size(); i++)
+    {
+        double expected = 1.0 - std::pow(1.0 - alpha, static_cast<double>(i));
+        if (std::fabs(response[i].values[0] - expected) > 1e-9)
+        {
+            return "low pass step response is wrong at sample " +
+                   std::to_string(i);
+        }
+    }
+
+    // the slew limit bounds every change, and the low pass and one euro
+    // filter stay within the range of their input
+    AxisFilter slew;
+    slew.slewRate = 5.0;
+    AxisFilter euro;
+    euro.minCutoff = 1.0;
+    euro.beta = 0.5;
+    std::vector<Axes> slewed = run(slew, samples);
+    std::vector<Axes> smoothed = run(lowPass, samples);
+    std::vector<Axes> euroed = run(euro, samples);
+    for (int lane = 0; lane < LANES; lane++)
+    {
+        double low = samples[0].values[lane];
+        double high = low;
+        for (const Axes &axes : samples)
+        {
+            low = std::fmin(low, axes.values[lane]);
+            high = std::fmax(high, axes.values[lane]);
+        }
+        for (size_t i = 1; i < samples.size(); i++)
+        {
+            double change =
+                slewed[i].values[lane] - slewed[i - 1].values[lane];
+            if (std::fabs(change) > slew.slewRate / RATE_HZ + 1e-12)
+            {
+                return "slew limit exceeded at sample " + std::to_string(i);
+            }
+            if (smoothed[i].values[lane] < low - 1e-12 ||
+                smoothed[i].values[lane] > high + 1e-12 ||
+                euroed[i].values[lane] < low - 1e-12 ||
+                euroed[i].values[lane] > high + 1e-12)
+            {
+                return "filter overshot its input at sample " +
+                       std::to_string(i);
+            }
+        }
+    }
+
+    // at rest, noise no larger than the hysteresis never changes the output,
+    // and the one euro filter removes most of it
+    WheelState centred;
+    centred.wheel = 0.5;
+    centred.throttle = 0.5;
+    centred.brake = 0.5;
+    std::vector<Axes> rest =
+        noisy(std::vector<WheelState>(trace.size(), centred));
+    AxisFilter quantiser;
+    quantiser.quantise = 0.01;
+    quantiser.hysteresis = NOISE * 2;
+    std::vector<Axes> quantised = run(quantiser, rest);
+    std::vector<Axes> restEuro = run(euro, rest);
+    for (int lane = 0; lane < LANES; lane++)
+    {
+        if (changes(quantised, lane) != 0)
+        {
+            return "quantiser changed output with noise at rest";
+        }
+        double inputTravel = 0.0, outputTravel = 0.0;
+        for (size_t i = 1; i < rest.size(); i++)
+        {
+            inputTravel +=
+                std::fabs(rest[i].values[lane] - rest[i - 1].values[lane]);
+            outputTravel += std::fabs(restEuro[i].values[lane] -
+                                      restEuro[i - 1].values[lane]);
+        }
+        if (outputTravel * 10 > inputTravel)
+        {
+            return "one euro filter did not remove jitter at rest";
+        }
+    }
+    return "";
+}
@@ -0,0 +1,37 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * filter_check.h                                                             *
+ *                                                                            *
+ * Checks the axis filters against a trace of wheel readings                  *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef FILTER_CHECK_H
+#define FILTER_CHECK_H
+
+#include <string>
+#include <vector>
+
+#include "input_types.h"
+
+// filters the axes of trace, with added noise, through each filter and
+// returns why a filter misbehaved, or an empty string if none did
+std::string checkFilters(const std::vector<WheelState> &trace);
+
+#endif
@@ -0,0 +1,195 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pool_check.cpp                                                             *
+ *                                                                            *
+ * Checks pooled injectors are left neutral by disconnected wheels            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "pool_check.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "replay_backend.h"
+#include "wheel_manager.h"
+#include "wheel_settings.h"
+
+// time allowed for each step before the check fails
+static const std::chrono::milliseconds STEP_TIMEOUT{2000};
+
+// keeps the last reading injected into a pooled gamepad
+class PooledInjector : public GamepadInjector
+{
+  private:
+    std::mutex stateMutex;
+    GamepadState last;
+    std::atomic<bool> ready;
+    std::atomic<bool> released;
+
+  public:
+    PooledInjector() : last{}, ready{false}, released{false}
+    {
+    }
+    bool initialise() override
+    {
+        ready.store(true);
+        return true;
+    }
+    void inject(const GamepadState &state) override
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        last = state;
+    }
+    void release() override
+    {
+        released.store(true);
+    }
+    // returns the last reading injected
+    GamepadState lastInjected()
+    {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        return last;
+    }
+    // returns if the injector has been initialised
+    bool initialised() const
+    {
+        return ready.load();
+    }
+    // returns if the virtual gamepad was released
+    bool wasReleased() const
+    {
+        return released.load();
+    }
+};
+
+// replays wheels, with one shared gamepad for the pool to keep warm
+class PoolBackend : public DeviceBackend
+{
+  private:
+    ReplayBackend &bus;
+    std::atomic<PooledInjector *> pooled;
+
+  public:
+    PoolBackend(ReplayBackend &bus) : bus(bus), pooled{nullptr}
+    {
+    }
+    std::vector<std::shared_ptr<WheelDevice>> scan() override
+    {
+        return bus.scan();
+    }
+    // the pool only ever holds one injector, which is checked
+    std::unique_ptr<GamepadInjector> createInjector() override
+    {
+        if (pooled.load())
+        {
+            return nullptr;
+        }
+        auto injector = std::make_unique<PooledInjector>();
+        pooled.store(injector.get());
+        return injector;
+    }
+    bool subscribe(DeviceListener *listener) override
+    {
+        return bus.subscribe(listener);
+    }
+    void unsubscribe() override
+    {
+        bus.unsubscribe();
+    }
+    // returns the pooled injector, or null if not yet created
+    PooledInjector *injector() const
+    {
+        return pooled.load();
+    }
+};
+
+// returns if a reading has every input at rest
+static bool neutral(const GamepadState &state)
+{
+    return state.buttons == PadButtons::None && state.leftTrigger == 0.0 &&
+           state.rightTrigger == 0.0 && state.leftThumbstickX == 0.0 &&
+           state.leftThumbstickY == 0.0 && state.rightThumbstickX == 0.0 &&
+           state.rightThumbstickY == 0.0;
+}
+
+// waits until done returns true, returns false if it timed out
+template <typename Fn> static bool waitFor(Fn done)
+{
+    auto end = std::chrono::steady_clock::now() + STEP_TIMEOUT;
+    while (!done())
+    {
+        if (std::chrono::steady_clock::now() > end)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// disconnects a wheel while it holds its inputs and returns why its pooled
+// injector was not left neutral, or an empty string if it was
+std::string checkPoolRelease()
+{
+    ReplayBackend bus;
+    PoolBackend backend(bus);
+    WheelSettings settings;
+    settings.pooledInjectors = 1;
+    WheelManager manager(backend, settings, nullptr, nullptr);
+    manager.start();
+    auto warmed = [&]
+    { return backend.injector() && backend.injector()->initialised(); };
+    if (!waitFor(warmed))
+    {
+        return "pooled injector was not initialised";
+    }
+    PooledInjector &injector = *backend.injector();
+
+    // steering held over, throttle and brake down and a button held
+    WheelState held;
+    held.wheel = 0.5;
+    held.throttle = 1.0;
+    held.brake = 0.25;
+    held.buttons = WheelButtons::Button3;
+    std::shared_ptr<ReplayDevice> device =
+        bus.connect(std::vector<WheelState>(1, held), true, 0);
+    if (!waitFor([&] { return !neutral(injector.lastInjected()); }))
+    {
+        manager.stop();
+        return "wheel did not use the pooled injector";
+    }
+    bus.disconnect(device);
+    bool recycled = waitFor([&] { return neutral(injector.lastInjected()); });
+    bool released = injector.wasReleased();
+    manager.stop();
+    if (!recycled)
+    {
+        return "pooled injector kept the disconnected wheel's inputs";
+    }
+    if (released)
+    {
+        return "pooled injector was released rather than recycled";
+    }
+    return "";
+}
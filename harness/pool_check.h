@@ -0,0 +1,34 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pool_check.h                                                               *
+ *                                                                            *
+ * Checks pooled injectors are left neutral by disconnected wheels            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef POOL_CHECK_H
+#define POOL_CHECK_H
+
+#include <string>
+
+// disconnects a wheel while it holds its inputs and returns why its pooled
+// injector was not left neutral, or an empty string if it was
+std::string checkPoolRelease();
+
+#endif
@@ -0,0 +1,158 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * scraper.cpp                                                                *
+ *                                                                            *
+ * A minimal Prometheus scraper for checking served metrics                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "scraper.h"
+
+#include <cstdlib>
+#include <set>
+#include <sstream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET Socket;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int Socket;
+static const Socket INVALID_SOCKET = -1;
+static int closesocket(Socket socket)
+{
+    return close(socket);
+}
+#endif
+
+// fetches /metrics from localhost:port, returns false and sets error on
+// failure
+bool scrape(uint16_t port, std::string &body, std::string &error)
+{
+#ifdef _WIN32
+    WSADATA data;
+    WSAStartup(MAKEWORD(2, 2), &data);
+#endif
+    Socket socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    std::string response;
+    const std::string request = "GET /metrics HTTP/1.0\r\n\r\n";
+    bool connected =
+        socket != INVALID_SOCKET &&
+        connect(socket, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) == 0 &&
+        send(socket, request.data(), static_cast<int>(request.size()), 0) ==
+            static_cast<int>(request.size());
+    if (connected)
+    {
+        // the server closes the connection once the response is sent
+        char buffer[4096];
+        int count;
+        while ((count = recv(socket, buffer, sizeof(buffer), 0)) > 0)
+        {
+            response.append(buffer, count);
+        }
+    }
+    if (socket != INVALID_SOCKET)
+    {
+        closesocket(socket);
+    }
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    if (!connected)
+    {
+        error = "unable to connect to the metrics server";
+        return false;
+    }
+    size_t headersEnd = response.find("\r\n\r\n");
+    if (response.compare(0, 12, "HTTP/1.0 200") != 0 ||
+        headersEnd == std::string::npos ||
+        response.find("Content-Type: text/plain; version=0.0.4") ==
+            std::string::npos)
+    {
+        error = "unexpected response: " + response.substr(0, 40);
+        return false;
+    }
+    body = response.substr(headersEnd + 4);
+    return true;
+}
+
+// parses metrics in the Prometheus text format into samples keyed by name
+// and labels, returns false and sets error if malformed
+bool parseMetrics(const std::string &text,
+                  std::map<std::string, double> &samples, std::string &error)
+{
+    std::set<std::string> helped, typed;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        std::istringstream words(line);
+        if (line[0] == '#')
+        {
+            // every metric is described and typed before its samples
+            std::string hash, keyword, name, type;
+            words >> hash >> keyword >> name >> type;
+            if (keyword == "HELP" && !name.empty())
+            {
+                helped.insert(name);
+            }
+            else if (keyword == "TYPE" &&
+                     (type == "counter" || type == "gauge") &&
+                     helped.count(name))
+            {
+                typed.insert(name);
+            }
+            else
+            {
+                error = "bad comment: " + line;
+                return false;
+            }
+            continue;
+        }
+        size_t split = line.rfind(' ');
+        std::string key = line.substr(0, split);
+        std::string name = key.substr(0, key.find('{'));
+        const char *value = line.c_str() + split + 1;
+        char *end;
+        double parsed = std::strtod(value, &end);
+        if (split == std::string::npos || end == value || *end != '\0' ||
+            !typed.count(name) ||
+            (key != name && key.back() != '}') || samples.count(key))
+        {
+            error = "bad sample: " + line;
+            return false;
+        }
+        samples[key] = parsed;
+    }
+    return true;
+}
@@ -0,0 +1,40 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * scraper.h                                                                  *
+ *                                                                            *
+ * A minimal Prometheus scraper for checking served metrics                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SCRAPER_H
+#define SCRAPER_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+// fetches /metrics from localhost:port, returns false and sets error on
+// failure
+bool scrape(uint16_t port, std::string &body, std::string &error);
+// parses metrics in the Prometheus text format into samples keyed by name
+// and labels, returns false and sets error if malformed
+bool parseMetrics(const std::string &text,
+                  std::map<std::string, double> &samples, std::string &error);
+
+#endif
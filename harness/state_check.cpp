@@ -0,0 +1,142 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_check.cpp                                                            *
+ *                                                                            *
+ * Checks published wheel state from a separate reader process                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "state_check.h"
+
+#include <thread>
+#include <vector>
+
+#include "state_reader.h"
+
+#ifndef _WIN32
+#include <spawn.h>
+#include <sys/wait.h>
+
+extern char **environ;
+#endif
+
+// what a reader last saw of one slot
+struct SlotView
+{
+    bool seen = false;
+    uint32_t generation = 0;
+    uint64_t version = 0;
+    uint64_t packet = 0;
+};
+
+// reads the region called name for duration, checking every reading with
+// valid, returns false and sets error if the region cannot be read
+bool readState(const std::string &name, std::chrono::milliseconds duration,
+               const std::function<bool(const WheelSample &)> &valid,
+               StateCheckResult &result, std::string &error)
+{
+    StateReader reader;
+    if (!reader.open(name, error))
+    {
+        return false;
+    }
+    // sweep every slot twice per poll so few readings are missed
+    auto interval = std::chrono::microseconds(500000 / reader.pollRateHz());
+    std::vector<SlotView> views(reader.slots());
+    std::vector<bool> publishing(reader.slots(), false);
+    auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end && reader.connected())
+    {
+        for (size_t i = 0; i < views.size(); i++)
+        {
+            PublishedWheel wheel;
+            // the first reading after attaching is empty
+            if (!reader.read(i, wheel) || wheel.version < 2)
+            {
+                continue;
+            }
+            publishing[i] = true;
+            SlotView &view = views[i];
+            if (view.seen && view.generation == wheel.generation &&
+                wheel.version == view.version)
+            {
+                continue;
+            }
+            // each published reading is the next packet of its wheel, so a
+            // torn or reordered reading breaks the step between them
+            if (view.seen && view.generation == wheel.generation &&
+                (wheel.version < view.version ||
+                 wheel.sample.output.timestamp - view.packet !=
+                     wheel.version - view.version))
+            {
+                result.mismatches++;
+            }
+            else if (!valid(wheel.sample))
+            {
+                result.mismatches++;
+            }
+            result.readings++;
+            view.seen = true;
+            view.generation = wheel.generation;
+            view.version = wheel.version;
+            view.packet = wheel.sample.output.timestamp;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+    result.wheels = 0;
+    for (bool seen : publishing)
+    {
+        result.wheels += seen ? 1 : 0;
+    }
+    return true;
+}
+
+// runs this program as a reader of the region called name for duration,
+// passing "-s <name> <ms> <wheels>", returns why the reader failed to see
+// wheels publishing correctly, or an empty string if it did
+std::string checkStateProcess(const std::string &name,
+                              std::chrono::milliseconds duration, int wheels)
+{
+#ifdef _WIN32
+    return "";
+#else
+    std::string program = "/proc/self/exe";
+    std::string ms = std::to_string(duration.count());
+    std::string count = std::to_string(wheels);
+    std::string flag = "-s";
+    char *argv[] = {&program[0], &flag[0], const_cast<char *>(name.c_str()),
+                    &ms[0], &count[0], nullptr};
+    pid_t pid;
+    if (posix_spawn(&pid, program.c_str(), nullptr, nullptr, argv,
+                    environ) != 0)
+    {
+        return "unable to start reader process";
+    }
+    int status;
+    if (waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        return "reader process did not exit";
+    }
+    if (WEXITSTATUS(status) != 0)
+    {
+        return "reader process saw wrong state";
+    }
+    return "";
+#endif
+}
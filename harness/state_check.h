@@ -0,0 +1,57 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_check.h                                                              *
+ *                                                                            *
+ * Checks published wheel state from a separate reader process                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef STATE_CHECK_H
+#define STATE_CHECK_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "input_types.h"
+
+// what a reader process saw of the published wheel state
+struct StateCheckResult
+{
+    // wheels seen publishing
+    int wheels = 0;
+    // distinct readings seen across every wheel
+    uint64_t readings = 0;
+    // readings mapped incorrectly or seen out of order
+    uint64_t mismatches = 0;
+};
+
+// reads the region called name for duration, checking every reading with
+// valid, returns false and sets error if the region cannot be read
+bool readState(const std::string &name, std::chrono::milliseconds duration,
+               const std::function<bool(const WheelSample &)> &valid,
+               StateCheckResult &result, std::string &error);
+// runs this program as a reader of the region called name for duration,
+// passing "-s <name> <ms> <wheels>", returns why the reader failed to see
+// wheels publishing correctly, or an empty string if it did
+std::string checkStateProcess(const std::string &name,
+                              std::chrono::milliseconds duration, int wheels);
+
+#endif
@@ -0,0 +1,591 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wheel_harness.cpp                                                          *
+ *                                                                            *
+ * Runs the wheel pipeline end to end against simulated wheels                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include "evdev_check.h"
+#include "filter_check.h"
+#include "metrics_server.h"
+#include "output_manager.h"
+#include "pool_check.h"
+#include "replay_backend.h"
+#include "scraper.h"
+#include "state_check.h"
+#include "state_publisher.h"
+#include "wheel_manager.h"
+#include "wheel_settings.h"
+
+static const int MAX_WHEELS = 8;
+static const size_t SCRIPT_LENGTH = 1000;
+static const std::chrono::milliseconds SCAN_INTERVAL{10};
+static const std::chrono::milliseconds DISCOVERY_TIMEOUT{2000};
+// centring spring driven through each wheel's simulated motor
+static const double SPRING = 0.8;
+static const double SPRING_GAIN = 0.9;
+
+// the results of one run
+struct RunResult
+{
+    bool discovered = false;
+    double readingsPerSecond = 0.0;
+    double slowestWheelHz = 0.0;
+    uint64_t latencyP50 = 0;
+    uint64_t latencyP99 = 0;
+    uint64_t latencyMax = 0;
+    uint64_t forceP99 = 0;
+    uint64_t forcesChecked = 0;
+    uint64_t checked = 0;
+    uint64_t mismatches = 0;
+    // why the served metrics were wrong, empty if they were right
+    std::string metricsError;
+    // why another process read wrong wheel state, empty if it was right
+    std::string sharedError;
+};
+
+bool parseCount(const char *arg, int &value);
+std::vector<WheelState> generateScript(int wheel);
+bool expectedOutput(const WheelState &input, const GamepadState &output);
+uint64_t verify(const std::vector<WheelState> &script,
+                const ReplayDevice &device, uint64_t &checked);
+uint64_t verifyForces(const ReplayDevice &device, uint64_t &checked);
+std::string
+checkMetrics(uint16_t port, const WheelSettings &settings,
+             const std::vector<std::shared_ptr<ReplayDevice>> &devices);
+RunResult run(const std::vector<std::vector<WheelState>> &scripts,
+              const WheelSettings &settings,
+              std::chrono::milliseconds duration);
+int readerMain(const char *name, const char *ms, const char *wheels);
+
+int main(int argc, char **argv)
+{
+    // started by a run to read its published state from another process
+    if (argc == 5 && std::string(argv[1]) == "-s")
+    {
+        return readerMain(argv[2], argv[3], argv[4]);
+    }
+
+    int durationMs = 1000;
+    int pollThreads = 0;
+    std::string replayPath;
+    // parse command line arguments
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        int value;
+        if (arg == "-d" && i + 1 < argc && parseCount(argv[i + 1], value) &&
+            value > 0)
+        {
+            durationMs = value;
+            i++;
+        }
+        else if (arg == "-e" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value))
+        {
+            pollThreads = value;
+            i++;
+        }
+        else if (arg == "-r" && i + 1 < argc)
+        {
+            replayPath = argv[++i];
+        }
+        else
+        {
+            // print help message
+            std::cout << "Usage: " << argv[0] << " [OPTIONS]" << std::endl
+                      << std::endl
+                      << "Options:" << std::endl
+                      << "-h Show this help message and exit" << std::endl
+                      << "-d <ms> Time to measure each run (default 1000)"
+                      << std::endl
+                      << "-e <n> Poll all wheels from n shared threads "
+                         "(0 = one thread per wheel)"
+                      << std::endl
+                      << "-r <file> Replay the first wheel of a recording "
+                         "instead of a generated script"
+                      << std::endl;
+            return arg == "-h" ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::vector<std::vector<WheelState>> scripts;
+    for (int i = 0; i < MAX_WHEELS; i++)
+    {
+        scripts.push_back(generateScript(i));
+    }
+    if (!replayPath.empty())
+    {
+        std::string error;
+        std::vector<WheelState> recorded;
+        if (!ReplayBackend::load(replayPath, 0, recorded, error))
+        {
+            std::cerr << error << std::endl;
+            return EXIT_FAILURE;
+        }
+        std::fill(scripts.begin(), scripts.end(), recorded);
+    }
+
+    // filter every script, or the recording, before running any wheels
+    std::string filterError;
+    for (size_t i = 0; i < scripts.size() && filterError.empty(); i++)
+    {
+        filterError = checkFilters(scripts[i]);
+    }
+    std::cout << "Filters " << (filterError.empty() ? "ok" : filterError)
+              << std::endl;
+
+    WheelSettings settings;
+    settings.scanInterval = SCAN_INTERVAL;
+    settings.pollThreads = pollThreads;
+    settings.forceFeedback.spring = SPRING;
+    settings.forceFeedback.gain = SPRING_GAIN;
+    OutputManager::getInstance().mute(true);
+
+    // a disconnected wheel must not leave its inputs on a pooled gamepad
+    std::string poolError = checkPoolRelease();
+    std::cout << "Pool " << (poolError.empty() ? "ok" : poolError)
+              << std::endl;
+
+    // drive real evdev and uinput devices, where the kernel allows it
+    EvdevCheckResult evdev;
+    std::string evdevError = checkEvdev(scripts[0], settings, evdev);
+    if (evdev.skipped)
+    {
+        std::cout << "Evdev skipped, " << evdevError << std::endl;
+    }
+    else
+    {
+        std::cout << std::fixed << std::setprecision(1) << "Evdev "
+                  << (evdevError.empty() ? "ok" : evdevError) << ", "
+                  << evdev.checked << " frames, p50 "
+                  << evdev.latencyP50 / 1000.0 << " us, max "
+                  << evdev.latencyMax / 1000.0 << " us" << std::endl;
+    }
+    std::cout << std::endl;
+
+    std::cout << std::setw(6) << "Wheels" << std::setw(14) << "Readings/s"
+              << std::setw(12) << "Slowest Hz" << std::setw(10) << "p50 us"
+              << std::setw(10) << "p99 us" << std::setw(10) << "Max us"
+              << std::setw(10) << "FFB us" << std::setw(10) << "Checked"
+              << std::setw(12) << "Mismatches" << std::setw(9) << "Metrics"
+              << std::setw(8) << "Shared"
+              << std::endl;
+    bool passed = filterError.empty() && poolError.empty() &&
+                  (evdev.skipped || evdevError.empty());
+    for (int numWheels = 1; numWheels <= MAX_WHEELS; numWheels++)
+    {
+        std::vector<std::vector<WheelState>> runScripts(
+            scripts.begin(), scripts.begin() + numWheels);
+        RunResult result = run(runScripts, settings,
+                               std::chrono::milliseconds(durationMs));
+        if (!result.discovered)
+        {
+            std::cout << std::setw(6) << numWheels
+                      << "  wheels were not discovered" << std::endl;
+            passed = false;
+            continue;
+        }
+        std::cout << std::fixed << std::setprecision(1) << std::setw(6)
+                  << numWheels << std::setw(14) << result.readingsPerSecond
+                  << std::setw(12) << result.slowestWheelHz << std::setw(10)
+                  << result.latencyP50 / 1000.0 << std::setw(10)
+                  << result.latencyP99 / 1000.0 << std::setw(10)
+                  << result.latencyMax / 1000.0 << std::setw(10)
+                  << result.forceP99 / 1000.0 << std::setw(10)
+                  << result.checked << std::setw(12) << result.mismatches
+                  << std::setw(9)
+                  << (result.metricsError.empty() ? "ok" : "wrong")
+                  << std::setw(8)
+                  << (result.sharedError.empty() ? "ok" : "wrong")
+                  << std::endl;
+        if (!result.metricsError.empty())
+        {
+            std::cout << "        " << result.metricsError << std::endl;
+        }
+        if (!result.sharedError.empty())
+        {
+            std::cout << "        " << result.sharedError << std::endl;
+        }
+        passed = passed && result.checked > 0 && result.forcesChecked > 0 &&
+                 result.mismatches == 0 &&
+                 result.metricsError.empty() && result.sharedError.empty();
+    }
+    std::cout << (passed ? "PASSED" : "FAILED") << std::endl;
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+// parses a non-negative integer argument
+bool parseCount(const char *arg, int &value)
+{
+    char *end;
+    long parsed = std::strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || parsed < 0 || parsed > INT_MAX)
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// returns readings exercising every button and the full travel of each axis
+std::vector<WheelState> generateScript(int wheel)
+{
+    const double pi = std::acos(-1.0);
+    std::vector<WheelState> script(SCRIPT_LENGTH);
+    for (size_t i = 0; i < SCRIPT_LENGTH; i++)
+    {
+        double phase = 2 * pi * (i + wheel * 37) / SCRIPT_LENGTH;
+        WheelState &state = script[i];
+        state.timestamp = i;
+        // each button alone, then pairs of neighbouring buttons
+        state.buttons =
+            (i / 10) % 2 ? 3u << (i / 20 % 21) : 1u << (i / 10 % 22);
+        state.wheel = std::sin(phase);
+        state.throttle = (1 + std::sin(phase * 3)) / 2;
+        state.brake = (1 + std::cos(phase * 2)) / 2;
+        state.clutch = static_cast<double>(i) / SCRIPT_LENGTH;
+        state.patternShifterGear = static_cast<int32_t>(i / 100 % 7);
+    }
+    return script;
+}
+
+// returns if a reading was mapped to the output of the default layout
+bool expectedOutput(const WheelState &input, const GamepadState &output)
+{
+    // written out in full so the harness does not share the code under test
+    uint32_t buttons = PadButtons::None;
+    if (input.buttons & WheelButtons::DPadDown)
+    {
+        buttons |= PadButtons::DPadDown;
+    }
+    if (input.buttons & WheelButtons::DPadUp)
+    {
+        buttons |= PadButtons::DPadUp;
+    }
+    if (input.buttons & WheelButtons::DPadLeft)
+    {
+        buttons |= PadButtons::DPadLeft;
+    }
+    if (input.buttons & WheelButtons::DPadRight)
+    {
+        buttons |= PadButtons::DPadRight;
+    }
+    if (input.buttons & WheelButtons::NextGear)
+    {
+        buttons |= PadButtons::RightShoulder;
+    }
+    if (input.buttons & WheelButtons::PreviousGear)
+    {
+        buttons |= PadButtons::LeftShoulder;
+    }
+    if (input.buttons & WheelButtons::Button1)
+    {
+        buttons |= PadButtons::Menu;
+    }
+    if (input.buttons & WheelButtons::Button2)
+    {
+        buttons |= PadButtons::View;
+    }
+    if (input.buttons & WheelButtons::Button3)
+    {
+        buttons |= PadButtons::A;
+    }
+    if (input.buttons & WheelButtons::Button4)
+    {
+        buttons |= PadButtons::B;
+    }
+    if (input.buttons & WheelButtons::Button5)
+    {
+        buttons |= PadButtons::X;
+    }
+    if (input.buttons & WheelButtons::Button6)
+    {
+        buttons |= PadButtons::Y;
+    }
+    return output.buttons == buttons && output.leftTrigger == input.brake &&
+           output.rightTrigger == input.throttle &&
+           output.leftThumbstickX == input.wheel &&
+           output.leftThumbstickY == 0.0 && output.rightThumbstickX == 0.0 &&
+           output.rightThumbstickY == 0.0;
+}
+
+// returns the number of captured readings which were out of order or mapped
+// incorrectly
+uint64_t verify(const std::vector<WheelState> &script,
+                const ReplayDevice &device, uint64_t &checked)
+{
+    uint64_t mismatches = 0;
+    const std::vector<WheelSample> &captured = device.getCaptured();
+    for (size_t i = 0; i < captured.size(); i++)
+    {
+        const WheelSample &sample = captured[i];
+        // every reading is injected in order, numbered from zero
+        if (sample.input.timestamp != script[i % script.size()].timestamp ||
+            sample.output.timestamp != i ||
+            !expectedOutput(sample.input, sample.output))
+        {
+            mismatches++;
+        }
+    }
+    checked += captured.size();
+    return mismatches;
+}
+
+// returns the number of forces sent to a simulated motor which were not the
+// centring spring's force at the steering position they were computed from
+uint64_t verifyForces(const ReplayDevice &device, uint64_t &checked)
+{
+    uint64_t mismatches = 0;
+    for (const std::pair<double, double> &sent : device.getForces())
+    {
+        // written out so the harness does not share the code under test
+        double expected = -SPRING * sent.first;
+        expected = std::max(-1.0, std::min(1.0, expected)) * SPRING_GAIN;
+        if (std::fabs(sent.second - expected) > 1e-12)
+        {
+            mismatches++;
+        }
+    }
+    checked += device.getForces().size();
+    return mismatches;
+}
+
+// polls simulated wheels through the wheel manager and measures the output
+RunResult run(const std::vector<std::vector<WheelState>> &scripts,
+              const WheelSettings &settings, std::chrono::milliseconds duration)
+{
+    RunResult result;
+    ReplayBackend backend;
+    std::vector<std::shared_ptr<ReplayDevice>> devices;
+    // capture every reading of the measured window, with room to spare
+    size_t captureLimit = static_cast<size_t>(
+        settings.pollRateHz * (duration.count() / 1000.0 + 1) * 2);
+    for (const std::vector<WheelState> &script : scripts)
+    {
+        devices.push_back(backend.connect(script, true, captureLimit));
+    }
+
+    // publish wheel state for a reader process to check, as the service does
+    // with -o
+    StatePublisher publisher;
+    std::string publishName;
+#ifndef _WIN32
+    publishName = "xwcs_harness_" + std::to_string(getpid());
+    std::string publishError;
+    if (!publisher.open(publishName, settings.pollRateHz, publishError))
+    {
+        result.sharedError = publishError;
+    }
+#endif
+
+    WheelManager wheelManager(backend, settings, nullptr,
+                              publisher.publishing() ? &publisher : nullptr);
+    wheelManager.start();
+    // serve metrics on any free port, as the service does on a chosen one
+    MetricsServer metricsServer([&wheelManager](MetricsWriter &out)
+                                { wheelManager.writeMetrics(out); });
+    std::string error;
+    if (!metricsServer.start(0, error))
+    {
+        result.metricsError = error;
+    }
+    // wait for every wheel to be found before measuring
+    auto deadline = std::chrono::steady_clock::now() + DISCOVERY_TIMEOUT;
+    auto allFound = [&]()
+    {
+        return std::all_of(devices.begin(), devices.end(),
+                           [](const std::shared_ptr<ReplayDevice> &device)
+                           { return device->injected() > 0; });
+    };
+    while (!allFound() && std::chrono::steady_clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    result.discovered = allFound();
+    // poll rates are measured from one scrape to the next
+    std::string body;
+    scrape(metricsServer.port(), body, error);
+
+    std::vector<uint64_t> before;
+    for (const std::shared_ptr<ReplayDevice> &device : devices)
+    {
+        before.push_back(device->injected());
+    }
+    // read the published state from another process while measuring
+    std::thread readerThread;
+    if (publisher.publishing())
+    {
+        readerThread = std::thread(
+            [&]()
+            {
+                result.sharedError = checkStateProcess(
+                    publishName, duration / 2,
+                    static_cast<int>(devices.size()));
+            });
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    if (readerThread.joinable())
+    {
+        readerThread.join();
+    }
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+    uint64_t total = 0;
+    result.slowestWheelHz = settings.pollRateHz;
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        uint64_t count = devices[i]->injected() - before[i];
+        total += count;
+        result.slowestWheelHz =
+            std::min(result.slowestWheelHz, count / seconds);
+    }
+    result.readingsPerSecond = total / seconds;
+    if (result.metricsError.empty())
+    {
+        result.metricsError =
+            checkMetrics(metricsServer.port(), settings, devices);
+    }
+    metricsServer.stop();
+    wheelManager.stop();
+    publisher.close();
+
+    for (size_t i = 0; i < devices.size(); i++)
+    {
+        const Histogram &latency = devices[i]->getLatency();
+        result.latencyP50 =
+            std::max(result.latencyP50, latency.percentile(0.5));
+        result.latencyP99 =
+            std::max(result.latencyP99, latency.percentile(0.99));
+        result.latencyMax = std::max(result.latencyMax, latency.max());
+        result.mismatches += verify(scripts[i], *devices[i], result.checked);
+        result.forceP99 = std::max(
+            result.forceP99, devices[i]->getForceLatency().percentile(0.99));
+        result.mismatches += verifyForces(*devices[i], result.forcesChecked);
+    }
+    return result;
+}
+
+// returns why metrics scraped from the wheel manager do not describe the
+// simulated wheels, or an empty string if they do
+std::string
+checkMetrics(uint16_t port, const WheelSettings &settings,
+             const std::vector<std::shared_ptr<ReplayDevice>> &devices)
+{
+    // injections continue while scraping, so bound the injected total
+    uint64_t before = 0, after = 0;
+    for (const std::shared_ptr<ReplayDevice> &device : devices)
+    {
+        before += device->injected();
+    }
+    std::string body, error;
+    std::map<std::string, double> samples;
+    if (!scrape(port, body, error) || !parseMetrics(body, samples, error))
+    {
+        return error;
+    }
+    for (const std::shared_ptr<ReplayDevice> &device : devices)
+    {
+        after += device->injected();
+    }
+
+    // each device counts an injection just before the pipeline does
+    double injected = samples["xwcs_injections_total"];
+    if (injected + devices.size() < before || injected > after)
+    {
+        return "xwcs_injections_total is " + std::to_string(injected) +
+               ", expected " + std::to_string(before) + " to " +
+               std::to_string(after);
+    }
+    if (samples["xwcs_wheels_connected"] != devices.size())
+    {
+        return "xwcs_wheels_connected does not match the wheels connected";
+    }
+    if (!samples.count("xwcs_injections_skipped_total") ||
+        !samples.count("xwcs_loop_overruns_total"))
+    {
+        return "counters are missing";
+    }
+    for (size_t i = 1; i <= devices.size(); i++)
+    {
+        std::string key =
+            "xwcs_wheel_poll_rate_hz{wheel=\"" + std::to_string(i) + "\"}";
+        if (!samples.count(key) || samples[key] < settings.pollRateHz / 2.0)
+        {
+            return key + " is missing or too low";
+        }
+        std::string cpu = "xwcs_thread_cpu_seconds_total{thread=\"wheel_" +
+                          std::to_string(i) + "\"}";
+        if (settings.pollThreads == 0 && !samples.count(cpu))
+        {
+            return cpu + " is missing";
+        }
+    }
+    return "";
+}
+
+// reads the state published as name for ms milliseconds, returns
+// EXIT_SUCCESS if every one of wheels published correctly mapped readings
+int readerMain(const char *name, const char *ms, const char *wheels)
+{
+    int durationMs, expectedWheels;
+    if (!parseCount(ms, durationMs) || !parseCount(wheels, expectedWheels))
+    {
+        return EXIT_FAILURE;
+    }
+    StateCheckResult result;
+    std::string error;
+    if (!readState(name, std::chrono::milliseconds(durationMs),
+                   [](const WheelSample &sample)
+                   { return expectedOutput(sample.input, sample.output); },
+                   result, error))
+    {
+        std::cerr << error << std::endl;
+        return EXIT_FAILURE;
+    }
+    if (result.wheels != expectedWheels || result.mismatches > 0)
+    {
+        std::cerr << "Reader saw " << result.wheels << " of "
+                  << expectedWheels << " wheels and " << result.mismatches
+                  << " wrong of " << result.readings << " readings"
+                  << std::endl;
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
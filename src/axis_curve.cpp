@@ -0,0 +1,316 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_curve.cpp                                                             *
+ *                                                                            *
+ * Response curve for a single axis: deadzones, gamma or spline, inversion    *
+ * and range clamping                                                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "axis_curve.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+// parses a number, returns false if the text is not a number
+static bool parseNumber(const std::string &text, double &value)
+{
+    char *end;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+AxisCurve::AxisCurve(Range range)
+    : range(range), innerDeadzone{0.0}, outerDeadzone{0.0}, gamma{1.0},
+      spline{}, tangents{}, inverted{false},
+      minimum{range == Range::Bipolar ? -1.0 : 0.0}, maximum{1.0},
+      identity{true}, table{}
+{
+    build();
+}
+
+// applies deadzones and the curve to a magnitude from 0 to 1
+double AxisCurve::shape(double magnitude) const
+{
+    if (magnitude <= innerDeadzone)
+    {
+        return 0.0;
+    }
+    if (magnitude >= 1.0 - outerDeadzone)
+    {
+        return 1.0;
+    }
+    double scaled =
+        (magnitude - innerDeadzone) / (1.0 - outerDeadzone - innerDeadzone);
+    return spline.empty() ? std::pow(scaled, gamma) : splineAt(scaled);
+}
+
+// evaluates the spline at a point from 0 to 1
+double AxisCurve::splineAt(double x) const
+{
+    size_t i = 0;
+    while (i + 2 < spline.size() && x > spline[i + 1].x)
+    {
+        i++;
+    }
+    // cubic hermite segment between points i and i + 1
+    const Point &a = spline[i];
+    const Point &b = spline[i + 1];
+    double h = b.x - a.x;
+    double t = (x - a.x) / h;
+    double t2 = t * t;
+    double t3 = t2 * t;
+    return (2 * t3 - 3 * t2 + 1) * a.y + (t3 - 2 * t2 + t) * h * tangents[i] +
+           (-2 * t3 + 3 * t2) * b.y + (t3 - t2) * h * tangents[i + 1];
+}
+
+// computes spline tangents and fills the lookup table
+void AxisCurve::build()
+{
+    identity = innerDeadzone == 0.0 && outerDeadzone == 0.0 &&
+               gamma == 1.0 && spline.empty();
+
+    // monotone tangents (Fritsch-Carlson) keep the curve from overshooting
+    tangents.assign(spline.size(), 0.0);
+    if (spline.size() >= 2)
+    {
+        std::vector<double> slopes;
+        for (size_t i = 0; i + 1 < spline.size(); i++)
+        {
+            slopes.push_back((spline[i + 1].y - spline[i].y) /
+                             (spline[i + 1].x - spline[i].x));
+        }
+        tangents.front() = slopes.front();
+        tangents.back() = slopes.back();
+        for (size_t i = 1; i + 1 < spline.size(); i++)
+        {
+            tangents[i] = slopes[i - 1] * slopes[i] <= 0.0
+                              ? 0.0
+                              : (slopes[i - 1] + slopes[i]) / 2.0;
+        }
+        for (size_t i = 0; i < slopes.size(); i++)
+        {
+            if (slopes[i] == 0.0)
+            {
+                tangents[i] = 0.0;
+                tangents[i + 1] = 0.0;
+                continue;
+            }
+            double alpha = tangents[i] / slopes[i];
+            double beta = tangents[i + 1] / slopes[i];
+            double length = alpha * alpha + beta * beta;
+            if (length > 9.0)
+            {
+                double scale = 3.0 / std::sqrt(length);
+                tangents[i] = scale * alpha * slopes[i];
+                tangents[i + 1] = scale * beta * slopes[i];
+            }
+        }
+    }
+
+    // the table is only read when the curve changes the axis
+    if (identity)
+    {
+        return;
+    }
+    for (int i = 0; i <= TABLE_SIZE; i++)
+    {
+        table[i] = static_cast<float>(shape(static_cast<double>(i) /
+                                            TABLE_SIZE));
+    }
+}
+
+// applies axis.<name>.* entries from a profile, returns false and sets error
+// if an entry is invalid
+bool AxisCurve::configure(const Profile &profile, const std::string &name,
+                          std::string &error)
+{
+    const std::string prefix = "axis." + name + ".";
+    for (const auto &entry : profile.entries())
+    {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        std::string key = entry.first.substr(prefix.size());
+        const std::string &value = entry.second;
+        double number = 0.0;
+        bool isNumber = parseNumber(value, number);
+        if (key == "inner_deadzone" && isNumber && number >= 0.0 &&
+            number < 1.0)
+        {
+            innerDeadzone = number;
+        }
+        else if (key == "outer_deadzone" && isNumber && number >= 0.0 &&
+                 number < 1.0)
+        {
+            outerDeadzone = number;
+        }
+        else if (key == "gamma" && isNumber && number > 0.0)
+        {
+            gamma = number;
+        }
+        else if (key == "invert" && (value == "true" || value == "false"))
+        {
+            inverted = value == "true";
+        }
+        else if (key == "min" && isNumber)
+        {
+            minimum = number;
+        }
+        else if (key == "max" && isNumber)
+        {
+            maximum = number;
+        }
+        else if (key == "curve")
+        {
+            // space separated x:y points, x increasing from 0 to 1
+            std::vector<Point> points;
+            std::istringstream pairs(value);
+            std::string pair;
+            while (pairs >> pair)
+            {
+                size_t separator = pair.find(':');
+                Point point;
+                if (separator == std::string::npos ||
+                    !parseNumber(pair.substr(0, separator), point.x) ||
+                    !parseNumber(pair.substr(separator + 1), point.y) ||
+                    point.x < 0.0 || point.x > 1.0 ||
+                    (!points.empty() && point.x <= points.back().x))
+                {
+                    error = "Invalid point " + pair + " in " + entry.first;
+                    return false;
+                }
+                points.push_back(point);
+            }
+            if (points.size() < 2 || points.front().x != 0.0 ||
+                points.back().x != 1.0)
+            {
+                error = entry.first + " must have points at 0 and 1";
+                return false;
+            }
+            spline = points;
+        }
+        else
+        {
+            error = "Invalid setting " + entry.first + " = " + value;
+            return false;
+        }
+    }
+    if (innerDeadzone + outerDeadzone >= 1.0 || minimum > maximum)
+    {
+        error = "Invalid range or deadzones for axis " + name;
+        return false;
+    }
+    build();
+    return true;
+}
+
+// copies the settings of the curve to shape, returns false if it has more
+// points than a shape holds
+bool AxisCurve::getShape(Shape &shape) const
+{
+    if (spline.size() > MAX_SHAPE_POINTS)
+    {
+        return false;
+    }
+    shape = Shape{};
+    shape.innerDeadzone = innerDeadzone;
+    shape.outerDeadzone = outerDeadzone;
+    shape.gamma = gamma;
+    shape.minimum = minimum;
+    shape.maximum = maximum;
+    shape.inverted = inverted;
+    shape.numPoints = static_cast<uint32_t>(spline.size());
+    for (size_t i = 0; i < spline.size(); i++)
+    {
+        shape.pointX[i] = spline[i].x;
+        shape.pointY[i] = spline[i].y;
+    }
+    return true;
+}
+
+// replaces the settings of the curve with shape, which must have come from
+// getShape, and rebuilds it
+void AxisCurve::setShape(const Shape &shape)
+{
+    innerDeadzone = shape.innerDeadzone;
+    outerDeadzone = shape.outerDeadzone;
+    gamma = shape.gamma;
+    minimum = shape.minimum;
+    maximum = shape.maximum;
+    inverted = shape.inverted != 0;
+    spline.clear();
+    for (uint32_t i = 0; i < shape.numPoints && i < MAX_SHAPE_POINTS; i++)
+    {
+        spline.push_back(Point{shape.pointX[i], shape.pointY[i]});
+    }
+    build();
+}
+
+// evaluates the curve directly, without the lookup table
+double AxisCurve::evaluate(double value) const
+{
+    double sign = 1.0;
+    double magnitude = value;
+    if (range == Range::Bipolar)
+    {
+        sign = value < 0.0 ? -1.0 : 1.0;
+        magnitude = std::fabs(value);
+        sign = inverted ? -sign : sign;
+    }
+    else if (inverted)
+    {
+        magnitude = 1.0 - magnitude;
+    }
+    magnitude = magnitude > 0.0 ? (magnitude < 1.0 ? magnitude : 1.0) : 0.0;
+    double result = sign * shape(magnitude);
+    return result < minimum ? minimum : (result > maximum ? maximum : result);
+}
+
+// evaluates the curve using the lookup table
+double AxisCurve::apply(double value) const
+{
+    double sign = 1.0;
+    double magnitude = value;
+    if (range == Range::Bipolar)
+    {
+        sign = value < 0.0 ? -1.0 : 1.0;
+        magnitude = std::fabs(value);
+        sign = inverted ? -sign : sign;
+    }
+    else if (inverted)
+    {
+        magnitude = 1.0 - magnitude;
+    }
+    // also maps NaN to zero
+    magnitude = magnitude > 0.0 ? (magnitude < 1.0 ? magnitude : 1.0) : 0.0;
+    double result = magnitude;
+    if (!identity)
+    {
+        double position = magnitude * TABLE_SIZE;
+        int index = static_cast<int>(position);
+        index = index < TABLE_SIZE ? index : TABLE_SIZE - 1;
+        double fraction = position - index;
+        result = table[index] + (table[index + 1] - table[index]) * fraction;
+    }
+    result *= sign;
+    return result < minimum ? minimum : (result > maximum ? maximum : result);
+}
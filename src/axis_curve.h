@@ -0,0 +1,112 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_curve.h                                                               *
+ *                                                                            *
+ * Response curve for a single axis: deadzones, gamma or spline, inversion    *
+ * and range clamping                                                         *
+ *                                                                            *
+ * The deadzones and curve are baked into a lookup table when configured, so  *
+ * applying the curve costs a table lookup and a linear interpolation.        *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef AXIS_CURVE_H
+#define AXIS_CURVE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "profile.h"
+
+class AxisCurve
+{
+  public:
+    // the values an axis reports
+    enum class Range
+    {
+        // -1 to 1, centred at 0, such as steering
+        Bipolar,
+        // 0 to 1, such as pedals
+        Unipolar
+    };
+    // the most points of a custom curve a shape holds
+    static constexpr int MAX_SHAPE_POINTS = 16;
+    // the settings a curve is built from, which can be copied byte for byte
+    struct Shape
+    {
+        double innerDeadzone;
+        double outerDeadzone;
+        double gamma;
+        double minimum;
+        double maximum;
+        uint32_t inverted;
+        // points of a custom curve, or 0 to use gamma
+        uint32_t numPoints;
+        double pointX[MAX_SHAPE_POINTS];
+        double pointY[MAX_SHAPE_POINTS];
+    };
+
+  private:
+    struct Point
+    {
+        double x;
+        double y;
+    };
+
+    static const int TABLE_SIZE = 1024;
+
+    Range range;
+    double innerDeadzone;
+    double outerDeadzone;
+    double gamma;
+    std::vector<Point> spline;
+    std::vector<double> tangents;
+    bool inverted;
+    double minimum;
+    double maximum;
+    bool identity;
+    float table[TABLE_SIZE + 1];
+
+    // applies deadzones and the curve to a magnitude from 0 to 1
+    double shape(double magnitude) const;
+    // evaluates the spline at a point from 0 to 1
+    double splineAt(double x) const;
+    // computes spline tangents and fills the lookup table
+    void build();
+
+  public:
+    AxisCurve(Range range);
+    // applies axis.<name>.* entries from a profile, returns false and sets
+    // error if an entry is invalid
+    bool configure(const Profile &profile, const std::string &name,
+                   std::string &error);
+    // copies the settings of the curve to shape, returns false if it has
+    // more points than a shape holds
+    bool getShape(Shape &shape) const;
+    // replaces the settings of the curve with shape, which must have come
+    // from getShape, and rebuilds it
+    void setShape(const Shape &shape);
+    // evaluates the curve directly, without the lookup table
+    double evaluate(double value) const;
+    // evaluates the curve using the lookup table
+    double apply(double value) const;
+};
+
+#endif
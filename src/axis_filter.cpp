@@ -0,0 +1,229 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_filter.cpp                                                            *
+ *                                                                            *
+ * Smoothing of noisy axes before their response curves: a one euro filter,  *
+ * a first order low pass, a slew rate limit and a hysteresis quantiser,      *
+ * applied in that order                                                      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "axis_filter.h"
+
+#include <cmath>
+#include <cstdlib>
+
+static const double TWO_PI = 2.0 * std::acos(-1.0);
+
+// parses a number, returns false if the text is not a number
+static bool parseNumber(const std::string &text, double &value)
+{
+    char *end;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+// returns the smoothing factor of a first order low pass at cutoffHz
+static double smoothing(double cutoffHz, double rateHz)
+{
+    return 1.0 / (1.0 + rateHz / (TWO_PI * cutoffHz));
+}
+
+// applies filter.<name>.* entries from a profile, returns false and sets
+// error if an entry is invalid
+bool AxisFilter::configure(const Profile &profile, const std::string &name,
+                           std::string &error)
+{
+    const std::string prefix = "filter." + name + ".";
+    for (const auto &entry : profile.entries())
+    {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        std::string key = entry.first.substr(prefix.size());
+        double number = 0.0;
+        if (!parseNumber(entry.second, number) || number < 0.0)
+        {
+            error = "Invalid setting " + entry.first + " = " + entry.second;
+            return false;
+        }
+        if (key == "min_cutoff")
+        {
+            minCutoff = number;
+        }
+        else if (key == "beta")
+        {
+            beta = number;
+        }
+        else if (key == "derivative_cutoff" && number > 0.0)
+        {
+            derivativeCutoff = number;
+        }
+        else if (key == "low_pass")
+        {
+            lowPassHz = number;
+        }
+        else if (key == "slew_rate")
+        {
+            slewRate = number;
+        }
+        else if (key == "quantise" && number < 1.0)
+        {
+            quantise = number;
+        }
+        else if (key == "hysteresis" && number < 1.0)
+        {
+            hysteresis = number;
+        }
+        else
+        {
+            error = "Invalid setting " + entry.first + " = " + entry.second;
+            return false;
+        }
+    }
+    return true;
+}
+
+// returns if any filter is enabled
+bool AxisFilter::enabled() const
+{
+    return minCutoff > 0.0 || lowPassHz > 0.0 || slewRate > 0.0 ||
+           quantise > 0.0;
+}
+
+AxisFilterBank::AxisFilterBank()
+    : euroMinCutoff{}, euroBeta{}, euroDerivativeAlpha{}, lowPassAlpha{},
+      slewStep{}, quantiseStep{}, quantiseScale{}, quantiseThreshold{},
+      euroEnabled{}, lowPassEnabled{}, slewEnabled{}, quantiseEnabled{},
+      euroValue{}, euroSpeed{}, lowPassValue{}, slewValue{}, quantiseValue{},
+      rateHz{1000.0}, active{false}, primed{false}
+{
+    const AxisFilter *const none[LANES] = {};
+    configure(none, 1000);
+}
+
+// sets the filters of each lane for samples taken at rateHz, null filters
+// disable their lane, and resets the state
+void AxisFilterBank::configure(const AxisFilter *const filters[LANES],
+                               int rateHz)
+{
+    this->rateHz = rateHz;
+    active = false;
+    const AxisFilter disabled;
+    for (int i = 0; i < LANES; i++)
+    {
+        const AxisFilter &filter = filters[i] ? *filters[i] : disabled;
+        euroEnabled[i] = filter.minCutoff > 0.0;
+        euroMinCutoff[i] = euroEnabled[i] ? filter.minCutoff : 1.0;
+        euroBeta[i] = filter.beta;
+        euroDerivativeAlpha[i] =
+            smoothing(filter.derivativeCutoff, this->rateHz);
+        lowPassEnabled[i] = filter.lowPassHz > 0.0;
+        lowPassAlpha[i] =
+            lowPassEnabled[i] ? smoothing(filter.lowPassHz, this->rateHz)
+                              : 1.0;
+        slewEnabled[i] = filter.slewRate > 0.0;
+        slewStep[i] = slewEnabled[i] ? filter.slewRate / this->rateHz : 1.0;
+        quantiseEnabled[i] = filter.quantise > 0.0;
+        quantiseStep[i] = quantiseEnabled[i] ? filter.quantise : 1.0;
+        quantiseScale[i] = 1.0 / quantiseStep[i];
+        quantiseThreshold[i] = quantiseStep[i] / 2.0 + filter.hysteresis;
+        active = active || filter.enabled();
+    }
+    reset();
+}
+
+// forgets previous samples, so the next sample passes through unchanged
+void AxisFilterBank::reset()
+{
+    primed = false;
+}
+
+// returns if any lane has a filter enabled
+bool AxisFilterBank::enabled() const
+{
+    return active;
+}
+
+// filters one sample of every lane in place
+void AxisFilterBank::process(double values[LANES])
+{
+    if (!primed)
+    {
+        for (int i = 0; i < LANES; i++)
+        {
+            // also maps NaN to zero, which would otherwise stick
+            double x = values[i] == values[i] ? values[i] : 0.0;
+            euroValue[i] = x;
+            euroSpeed[i] = 0.0;
+            lowPassValue[i] = x;
+            slewValue[i] = x;
+            quantiseValue[i] =
+                quantiseEnabled[i]
+                    ? std::floor(x * quantiseScale[i] + 0.5) * quantiseStep[i]
+                    : x;
+            values[i] = quantiseValue[i];
+        }
+        primed = true;
+        return;
+    }
+    // every stage is computed for every lane and disabled stages are
+    // selected away, keeping the loop free of branches
+    for (int i = 0; i < LANES; i++)
+    {
+        double x = values[i] == values[i] ? values[i] : 0.0;
+
+        // one euro: a low pass whose cutoff rises with speed
+        double speed = (x - euroValue[i]) * rateHz;
+        double smoothedSpeed =
+            euroSpeed[i] + euroDerivativeAlpha[i] * (speed - euroSpeed[i]);
+        double cutoff =
+            euroMinCutoff[i] + euroBeta[i] * std::fabs(smoothedSpeed);
+        double alpha = cutoff / (cutoff + rateHz / TWO_PI);
+        double euro = euroValue[i] + alpha * (x - euroValue[i]);
+        euroSpeed[i] = smoothedSpeed;
+        euroValue[i] = euro;
+        x = euroEnabled[i] ? euro : x;
+
+        // first order low pass
+        double lowPass =
+            lowPassValue[i] + lowPassAlpha[i] * (x - lowPassValue[i]);
+        lowPassValue[i] = lowPass;
+        x = lowPassEnabled[i] ? lowPass : x;
+
+        // slew rate limit
+        double change = x - slewValue[i];
+        change = change < -slewStep[i] ? -slewStep[i] : change;
+        change = change > slewStep[i] ? slewStep[i] : change;
+        double slewed = slewValue[i] + change;
+        slewValue[i] = slewed;
+        x = slewEnabled[i] ? slewed : x;
+
+        // quantise, holding the step until the input leaves it by more than
+        // the hysteresis
+        double rounded =
+            std::floor(x * quantiseScale[i] + 0.5) * quantiseStep[i];
+        double held = std::fabs(x - quantiseValue[i]) > quantiseThreshold[i]
+                          ? rounded
+                          : quantiseValue[i];
+        quantiseValue[i] = held;
+        values[i] = quantiseEnabled[i] ? held : x;
+    }
+}
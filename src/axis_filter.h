@@ -0,0 +1,107 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * axis_filter.h                                                              *
+ *                                                                            *
+ * Smoothing of noisy axes before their response curves: a one euro filter,  *
+ * a first order low pass, a slew rate limit and a hysteresis quantiser,      *
+ * applied in that order                                                      *
+ *                                                                            *
+ * A filter bank keeps the coefficients and state of each axis in arrays      *
+ * indexed by lane, so one pass over the lanes filters every axis with no     *
+ * branches on the stages in use.                                             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef AXIS_FILTER_H
+#define AXIS_FILTER_H
+
+#include <string>
+
+#include "profile.h"
+
+// the filters applied to one axis, each disabled by default
+struct AxisFilter
+{
+    // one euro filter cutoff at rest in Hz, or 0 to disable it
+    double minCutoff = 0.0;
+    // increase in one euro cutoff per unit per second of movement
+    double beta = 0.0;
+    // cutoff in Hz of the one euro filter's speed estimate
+    double derivativeCutoff = 1.0;
+    // low pass cutoff in Hz, or 0 to disable it
+    double lowPassHz = 0.0;
+    // largest change per second, or 0 to disable the limit
+    double slewRate = 0.0;
+    // step outputs are rounded to, or 0 to disable quantising
+    double quantise = 0.0;
+    // distance beyond half a step the input must move to change step
+    double hysteresis = 0.0;
+
+    // applies filter.<name>.* entries from a profile, returns false and
+    // sets error if an entry is invalid
+    bool configure(const Profile &profile, const std::string &name,
+                   std::string &error);
+    // returns if any filter is enabled
+    bool enabled() const;
+};
+
+class AxisFilterBank
+{
+  public:
+    // steering, throttle and brake, padded to a whole vector
+    static constexpr int LANES = 4;
+
+  private:
+    // coefficients, with disabled stages passing input through
+    alignas(32) double euroMinCutoff[LANES];
+    alignas(32) double euroBeta[LANES];
+    alignas(32) double euroDerivativeAlpha[LANES];
+    alignas(32) double lowPassAlpha[LANES];
+    alignas(32) double slewStep[LANES];
+    alignas(32) double quantiseStep[LANES];
+    alignas(32) double quantiseScale[LANES];
+    alignas(32) double quantiseThreshold[LANES];
+    bool euroEnabled[LANES];
+    bool lowPassEnabled[LANES];
+    bool slewEnabled[LANES];
+    bool quantiseEnabled[LANES];
+    // state, the output of each stage for the previous sample
+    alignas(32) double euroValue[LANES];
+    alignas(32) double euroSpeed[LANES];
+    alignas(32) double lowPassValue[LANES];
+    alignas(32) double slewValue[LANES];
+    alignas(32) double quantiseValue[LANES];
+    double rateHz;
+    bool active;
+    bool primed;
+
+  public:
+    AxisFilterBank();
+    // sets the filters of each lane for samples taken at rateHz, null
+    // filters disable their lane, and resets the state
+    void configure(const AxisFilter *const filters[LANES], int rateHz);
+    // forgets previous samples, so the next sample passes through unchanged
+    void reset();
+    // returns if any lane has a filter enabled
+    bool enabled() const;
+    // filters one sample of every lane in place
+    void process(double values[LANES]);
+};
+
+#endif
@@ -0,0 +1,197 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * button_map.cpp                                                             *
+ *                                                                            *
+ * Table driven mapping of racing wheel buttons to gamepad buttons            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "button_map.h"
+
+#include <cstdio>
+#include <cstring>
+
+// returns true if mapDefault moves every default route to its gamepad button
+// and maps nothing else
+static constexpr bool defaultRoutesMatch()
+{
+    uint32_t routed = WheelButtons::None;
+    for (const ButtonRoute &route : ButtonMap::DEFAULT_ROUTES)
+    {
+        if (ButtonMap::mapDefault(route.from) != route.to)
+        {
+            return false;
+        }
+        routed |= route.from;
+    }
+    return ButtonMap::mapDefault(~routed) == PadButtons::None;
+}
+
+static_assert(defaultRoutesMatch(),
+              "mapDefault must match the default routes");
+static_assert(sizeof(ButtonMap::WHEEL_BUTTON_NAMES) /
+                      sizeof(ButtonMap::WHEEL_BUTTON_NAMES[0]) <=
+                  24,
+              "wheel buttons must fit in the three byte lookup table");
+
+ButtonMap::ButtonMap() : targets{}, table{}
+{
+    for (const ButtonRoute &route : DEFAULT_ROUTES)
+    {
+        targets[bitIndex(route.from)] |= route.to;
+    }
+    build();
+}
+
+// expands the routes into the lookup table
+void ButtonMap::build()
+{
+    for (int byte = 0; byte < TABLE_BYTES; byte++)
+    {
+        for (int value = 0; value < 256; value++)
+        {
+            uint32_t mapped = PadButtons::None;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                int button = byte * 8 + bit;
+                if (button < WHEEL_BUTTONS && (value & (1 << bit)))
+                {
+                    mapped |= targets[button];
+                }
+            }
+            table[byte][value] = mapped;
+        }
+    }
+}
+
+// applies button.<WheelButton> = <PadButton> entries from a profile,
+// returns false and sets error if an entry is invalid
+bool ButtonMap::configure(const Profile &profile, std::string &error)
+{
+    const std::string prefix = "button.";
+    for (const auto &entry : profile.entries())
+    {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        // find the wheel button
+        std::string wheelName = entry.first.substr(prefix.size());
+        int button = -1;
+        for (int i = 0; i < WHEEL_BUTTONS; i++)
+        {
+            if (wheelName == WHEEL_BUTTON_NAMES[i].name)
+            {
+                button = i;
+                break;
+            }
+        }
+        if (button < 0)
+        {
+            error = "Unknown wheel button " + wheelName;
+            return false;
+        }
+        // parse gamepad buttons, separated by +
+        uint32_t mapped = PadButtons::None;
+        size_t start = 0;
+        while (start <= entry.second.size())
+        {
+            size_t end = entry.second.find('+', start);
+            if (end == std::string::npos)
+            {
+                end = entry.second.size();
+            }
+            std::string padName = entry.second.substr(start, end - start);
+            bool found = padName == "None";
+            for (const ButtonName &pad : PAD_BUTTON_NAMES)
+            {
+                if (padName == pad.name)
+                {
+                    mapped |= pad.flag;
+                    found = true;
+                }
+            }
+            if (!found)
+            {
+                error = "Unknown gamepad button " + padName;
+                return false;
+            }
+            start = end + 1;
+        }
+        targets[button] = mapped;
+    }
+    build();
+    return true;
+}
+
+// copies the gamepad buttons each wheel button is mapped to, indexed by bit
+// position, to targets
+void ButtonMap::getTargets(uint32_t targets[WHEEL_BUTTONS]) const
+{
+    std::memcpy(targets, this->targets, sizeof(this->targets));
+}
+
+// maps each wheel button, indexed by bit position, to targets
+void ButtonMap::setTargets(const uint32_t targets[WHEEL_BUTTONS])
+{
+    std::memcpy(this->targets, targets, sizeof(this->targets));
+    build();
+}
+
+// returns the names of the given gamepad buttons, separated by commas
+std::string ButtonMap::describe(uint32_t padButtons)
+{
+    std::string names;
+    for (const ButtonName &pad : PAD_BUTTON_NAMES)
+    {
+        if (padButtons & pad.flag)
+        {
+            if (!names.empty())
+            {
+                names += ", ";
+            }
+            names += pad.name;
+        }
+    }
+    return names;
+}
+
+// writes the names of the given gamepad buttons to a buffer of size
+// characters without allocating, truncating them if necessary
+void ButtonMap::describe(uint32_t padButtons, char *buffer, size_t size)
+{
+    size_t length = 0;
+    for (const ButtonName &pad : PAD_BUTTON_NAMES)
+    {
+        if (padButtons & pad.flag)
+        {
+            int written = std::snprintf(buffer + length, size - length,
+                                        length ? ", %s" : "%s", pad.name);
+            if (written < 0 || length + written >= size)
+            {
+                return;
+            }
+            length += written;
+        }
+    }
+    if (length == 0 && size > 0)
+    {
+        buffer[0] = '\0';
+    }
+}
@@ -0,0 +1,164 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * button_map.h                                                               *
+ *                                                                            *
+ * Table driven mapping of racing wheel buttons to gamepad buttons            *
+ *                                                                            *
+ * The default layout is expanded at compile time into a fixed sequence of    *
+ * shifts and masks. Layouts remapped by a profile are expanded once into a   *
+ * lookup table indexed by each byte of the wheel's button flags.             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef BUTTON_MAP_H
+#define BUTTON_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "input_types.h"
+#include "profile.h"
+
+// a button flag and its display name
+struct ButtonName
+{
+    uint32_t flag;
+    const char *name;
+};
+
+// a wheel button and the gamepad button it is mapped to
+struct ButtonRoute
+{
+    uint32_t from;
+    uint32_t to;
+};
+
+class ButtonMap
+{
+  public:
+    // gamepad buttons in telemetry display order
+    static constexpr ButtonName PAD_BUTTON_NAMES[] = {
+        {PadButtons::DPadUp, "DPadUp"},
+        {PadButtons::DPadDown, "DPadDown"},
+        {PadButtons::DPadLeft, "DPadLeft"},
+        {PadButtons::DPadRight, "DPadRight"},
+        {PadButtons::LeftShoulder, "LB"},
+        {PadButtons::RightShoulder, "RB"},
+        {PadButtons::Menu, "Menu"},
+        {PadButtons::View, "View"},
+        {PadButtons::A, "A"},
+        {PadButtons::B, "B"},
+        {PadButtons::X, "X"},
+        {PadButtons::Y, "Y"},
+        {PadButtons::LeftThumbstick, "LS"},
+        {PadButtons::RightThumbstick, "RS"}};
+    // wheel buttons, indexed by bit position
+    static constexpr ButtonName WHEEL_BUTTON_NAMES[] = {
+        {WheelButtons::PreviousGear, "PreviousGear"},
+        {WheelButtons::NextGear, "NextGear"},
+        {WheelButtons::DPadUp, "DPadUp"},
+        {WheelButtons::DPadDown, "DPadDown"},
+        {WheelButtons::DPadLeft, "DPadLeft"},
+        {WheelButtons::DPadRight, "DPadRight"},
+        {WheelButtons::Button1, "Button1"},
+        {WheelButtons::Button2, "Button2"},
+        {WheelButtons::Button3, "Button3"},
+        {WheelButtons::Button4, "Button4"},
+        {WheelButtons::Button5, "Button5"},
+        {WheelButtons::Button6, "Button6"},
+        {WheelButtons::Button7, "Button7"},
+        {WheelButtons::Button8, "Button8"},
+        {WheelButtons::Button9, "Button9"},
+        {WheelButtons::Button10, "Button10"},
+        {WheelButtons::Button11, "Button11"},
+        {WheelButtons::Button12, "Button12"},
+        {WheelButtons::Button13, "Button13"},
+        {WheelButtons::Button14, "Button14"},
+        {WheelButtons::Button15, "Button15"},
+        {WheelButtons::Button16, "Button16"}};
+    // the default layout
+    static constexpr ButtonRoute DEFAULT_ROUTES[] = {
+        {WheelButtons::DPadDown, PadButtons::DPadDown},
+        {WheelButtons::DPadUp, PadButtons::DPadUp},
+        {WheelButtons::DPadLeft, PadButtons::DPadLeft},
+        {WheelButtons::DPadRight, PadButtons::DPadRight},
+        {WheelButtons::NextGear, PadButtons::RightShoulder},
+        {WheelButtons::PreviousGear, PadButtons::LeftShoulder},
+        {WheelButtons::Button1, PadButtons::Menu},
+        {WheelButtons::Button2, PadButtons::View},
+        {WheelButtons::Button3, PadButtons::A},
+        {WheelButtons::Button4, PadButtons::B},
+        {WheelButtons::Button5, PadButtons::X},
+        {WheelButtons::Button6, PadButtons::Y}};
+
+    static constexpr int WHEEL_BUTTONS =
+        sizeof(WHEEL_BUTTON_NAMES) / sizeof(WHEEL_BUTTON_NAMES[0]);
+
+  private:
+    static constexpr int TABLE_BYTES = (WHEEL_BUTTONS + 7) / 8;
+
+    uint32_t targets[WHEEL_BUTTONS];
+    uint32_t table[TABLE_BYTES][256];
+
+    // returns the position of the single bit set in a flag
+    static constexpr int bitIndex(uint32_t flag)
+    {
+        int index = 0;
+        while (flag >>= 1)
+        {
+            index++;
+        }
+        return index;
+    }
+    // expands the routes into the lookup table
+    void build();
+
+  public:
+    // creates a map with the default layout
+    ButtonMap();
+    // maps buttons with the default layout, the routes fall in three runs
+    // of adjacent bits so each run is moved with one mask and shift
+    static constexpr uint32_t mapDefault(uint32_t buttons)
+    {
+        return ((buttons & 0x3u) << 10) | ((buttons & 0x3cu) << 4) |
+               ((buttons >> 6) & 0x3fu);
+    }
+    // maps buttons with this map's layout
+    uint32_t map(uint32_t buttons) const
+    {
+        return table[0][buttons & 0xff] | table[1][(buttons >> 8) & 0xff] |
+               table[2][(buttons >> 16) & 0xff];
+    }
+    // applies button.<WheelButton> = <PadButton> entries from a profile,
+    // returns false and sets error if an entry is invalid
+    bool configure(const Profile &profile, std::string &error);
+    // copies the gamepad buttons each wheel button is mapped to, indexed by
+    // bit position, to targets
+    void getTargets(uint32_t targets[WHEEL_BUTTONS]) const;
+    // maps each wheel button, indexed by bit position, to targets
+    void setTargets(const uint32_t targets[WHEEL_BUTTONS]);
+    // returns the names of the given gamepad buttons, separated by commas
+    static std::string describe(uint32_t padButtons);
+    // writes the names of the given gamepad buttons to a buffer of size
+    // characters without allocating, truncating them if necessary
+    static void describe(uint32_t padButtons, char *buffer, size_t size);
+};
+
+#endif
@@ -0,0 +1,160 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * clock.cpp                                                                  *
+ *                                                                            *
+ * Time source used for pacing, replaceable for simulation                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "clock.h"
+
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CPU_RELAX() _mm_pause()
+#elif defined(__x86_64__) || defined(__i386__)
+#define CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CPU_RELAX()
+#endif
+
+#ifdef _WIN32
+// per thread high resolution timer, closed when the thread exits
+struct WaitableTimer
+{
+    HANDLE handle;
+    WaitableTimer()
+        : handle{CreateWaitableTimerExW(nullptr, nullptr,
+                                        CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS)}
+    {
+    }
+    ~WaitableTimer()
+    {
+        if (handle)
+        {
+            CloseHandle(handle);
+        }
+    }
+};
+
+// returns the calling thread's timer
+static WaitableTimer &threadTimer()
+{
+    thread_local WaitableTimer timer;
+    return timer;
+}
+#endif
+
+// blocks the calling thread until roughly the given time or until signal is
+// raised, returns if it was raised
+bool Clock::waitUntil(time_point deadline, const WakeSignal &signal)
+{
+    sleepUntil(deadline);
+    return signal.raised();
+}
+
+// returns the singleton instance
+SteadyClock &SteadyClock::getInstance()
+{
+    static SteadyClock instance;
+    return instance;
+}
+
+// returns the current time
+Clock::time_point SteadyClock::now()
+{
+    return std::chrono::steady_clock::now();
+}
+
+// blocks the calling thread until roughly the given time
+void SteadyClock::sleepUntil(time_point deadline)
+{
+#ifdef _WIN32
+    // Sleep() rounds up to the system timer resolution (up to 15.6 ms), so
+    // use a high resolution waitable timer where available
+    WaitableTimer &timer = threadTimer();
+    auto remaining = deadline - now();
+    if (remaining <= std::chrono::steady_clock::duration::zero())
+    {
+        return;
+    }
+    if (timer.handle)
+    {
+        LARGE_INTEGER dueTime;
+        // negative due times are relative, in 100 ns units
+        dueTime.QuadPart =
+            -std::chrono::duration_cast<std::chrono::duration<
+                long long, std::ratio<1, 10000000>>>(remaining)
+                 .count();
+        if (SetWaitableTimer(timer.handle, &dueTime, 0, nullptr, nullptr,
+                             FALSE))
+        {
+            WaitForSingleObject(timer.handle, INFINITE);
+            return;
+        }
+    }
+#endif
+    std::this_thread::sleep_until(deadline);
+}
+
+// blocks the calling thread until roughly the given time or until signal is
+// raised, returns if it was raised
+bool SteadyClock::waitUntil(time_point deadline, const WakeSignal &signal)
+{
+#ifdef _WIN32
+    // wait on the high resolution timer and the signal's event together
+    WaitableTimer &timer = threadTimer();
+    auto remaining = deadline - now();
+    if (remaining > std::chrono::steady_clock::duration::zero() &&
+        timer.handle && !signal.raised())
+    {
+        LARGE_INTEGER dueTime;
+        dueTime.QuadPart =
+            -std::chrono::duration_cast<std::chrono::duration<
+                long long, std::ratio<1, 10000000>>>(remaining)
+                 .count();
+        if (SetWaitableTimer(timer.handle, &dueTime, 0, nullptr, nullptr,
+                             FALSE))
+        {
+            HANDLE handles[] = {timer.handle, signal.handle()};
+            WaitForMultipleObjects(2, handles, FALSE, INFINITE);
+            return signal.raised();
+        }
+    }
+#endif
+    return signal.waitUntil(deadline);
+}
+
+// busy waits until the given time
+void SteadyClock::spinUntil(time_point deadline)
+{
+    while (now() < deadline)
+    {
+        CPU_RELAX();
+    }
+}
@@ -0,0 +1,70 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * clock.h                                                                    *
+ *                                                                            *
+ * Time source used for pacing, replaceable for simulation                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include <chrono>
+
+#include "wake_signal.h"
+
+class Clock
+{
+  public:
+    typedef std::chrono::steady_clock::time_point time_point;
+
+    virtual ~Clock() = default;
+    // returns the current time
+    virtual time_point now() = 0;
+    // blocks the calling thread until roughly the given time
+    virtual void sleepUntil(time_point deadline) = 0;
+    // blocks the calling thread until roughly the given time or until signal
+    // is raised, returns if it was raised
+    virtual bool waitUntil(time_point deadline, const WakeSignal &signal);
+    // busy waits until the given time
+    virtual void spinUntil(time_point deadline) = 0;
+};
+
+class SteadyClock : public Clock
+{
+  private:
+    SteadyClock() = default;
+
+  public:
+    // returns the singleton instance
+    static SteadyClock &getInstance();
+    SteadyClock &operator=(const SteadyClock &) = delete;
+    SteadyClock(const SteadyClock &) = delete;
+    // returns the current time
+    time_point now() override;
+    // blocks the calling thread until roughly the given time
+    void sleepUntil(time_point deadline) override;
+    // blocks the calling thread until roughly the given time or until signal
+    // is raised, returns if it was raised
+    bool waitUntil(time_point deadline, const WakeSignal &signal) override;
+    // busy waits until the given time
+    void spinUntil(time_point deadline) override;
+};
+
+#endif
@@ -0,0 +1,60 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * device_backend.cpp                                                         *
+ *                                                                            *
+ * Discovers wheels and opens their input and output                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "device_backend.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+
+// parses a hexadecimal id of 1 to 4 digits, returns false if it is not one
+static bool parseHalf(const std::string &text, uint16_t &id)
+{
+    // strtoul alone also accepts whitespace, signs and a 0x prefix
+    if (text.empty() || text.size() > 4 ||
+        !std::all_of(text.begin(), text.end(),
+                     [](unsigned char c) { return std::isxdigit(c) != 0; }))
+    {
+        return false;
+    }
+    id = static_cast<uint16_t>(std::strtoul(text.c_str(), nullptr, 16));
+    return true;
+}
+
+// parses <vendor>:<product> in hexadecimal, returns false if text is not a
+// known model
+bool DeviceId::parse(const std::string &text, DeviceId &id)
+{
+    size_t separator = text.find(':');
+    DeviceId parsed;
+    if (separator == std::string::npos ||
+        !parseHalf(text.substr(0, separator), parsed.vendor) ||
+        !parseHalf(text.substr(separator + 1), parsed.product) ||
+        parsed.key() == 0)
+    {
+        return false;
+    }
+    id = parsed;
+    return true;
+}
@@ -0,0 +1,129 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * device_backend.h                                                           *
+ *                                                                            *
+ * Discovers wheels and opens their input and output                          *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef DEVICE_BACKEND_H
+#define DEVICE_BACKEND_H
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gamepad_injector.h"
+#include "reading_source.h"
+#include "wheel_motor.h"
+
+// a recoverable error reported by a device, after which polling is retried
+class DeviceError : public std::runtime_error
+{
+  private:
+    int32_t errorCode;
+
+  public:
+    // creates an error with the platform's error code, or 0 if it has none
+    explicit DeviceError(const std::string &message, int32_t code = 0)
+        : std::runtime_error(message), errorCode{code}
+    {
+    }
+    // returns the platform's error code, such as an HRESULT
+    int32_t code() const
+    {
+        return errorCode;
+    }
+};
+
+// the USB vendor and product of a device, which identify its model
+struct DeviceId
+{
+    uint16_t vendor = 0;
+    uint16_t product = 0;
+
+    // returns both ids as one number, or 0 if the model is unknown
+    uint32_t key() const
+    {
+        return static_cast<uint32_t>(vendor) << 16 | product;
+    }
+    // parses <vendor>:<product> in hexadecimal, returns false if text is not
+    // a known model
+    static bool parse(const std::string &text, DeviceId &id);
+};
+
+class WheelDevice
+{
+  public:
+    virtual ~WheelDevice() = default;
+    // returns if both devices refer to the same connected wheel
+    virtual bool matches(const WheelDevice &other) const = 0;
+    // returns the model of the wheel, or zero ids if it is unknown
+    virtual DeviceId id() const
+    {
+        return DeviceId{};
+    }
+    // opens the wheel for reading
+    virtual std::unique_ptr<ReadingSource> createSource() = 0;
+    // creates the injector the wheel's readings are sent to
+    virtual std::unique_ptr<GamepadInjector> createInjector() = 0;
+    // creates the force feedback motor of the wheel, or null if it has none
+    virtual std::unique_ptr<WheelMotor> createMotor()
+    {
+        return nullptr;
+    }
+};
+
+class DeviceListener
+{
+  public:
+    virtual ~DeviceListener() = default;
+    // called when a wheel is connected, from any thread
+    virtual void deviceAdded(std::shared_ptr<WheelDevice> device) = 0;
+    // called when a wheel is disconnected, from any thread
+    virtual void deviceRemoved(std::shared_ptr<WheelDevice> device) = 0;
+};
+
+class DeviceBackend
+{
+  public:
+    virtual ~DeviceBackend() = default;
+    // returns the wheels currently connected
+    virtual std::vector<std::shared_ptr<WheelDevice>> scan() = 0;
+    // creates an injector any of the backend's wheels can use, or null if
+    // each wheel needs its own
+    virtual std::unique_ptr<GamepadInjector> createInjector()
+    {
+        return nullptr;
+    }
+    // reports connections to listener until unsubscribed, returns false if
+    // the backend can only be scanned
+    virtual bool subscribe(DeviceListener *listener)
+    {
+        return false;
+    }
+    // stops reporting connections, returns once no report is in progress
+    virtual void unsubscribe()
+    {
+    }
+};
+
+#endif
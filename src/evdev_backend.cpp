@@ -0,0 +1,856 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * evdev_backend.cpp                                                          *
+ *                                                                            *
+ * Wheels read from Linux evdev devices and injected as a uinput gamepad      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "evdev_backend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+static const char *const INPUT_DIRECTORY = "/dev/input";
+static const int MAX_EPOLL_EVENTS = 16;
+static const int LONG_BITS = sizeof(unsigned long) * 8;
+
+// vendor and product of a wired Xbox 360 controller, whose layout games
+// already know
+static const uint16_t GAMEPAD_VENDOR = 0x045e;
+static const uint16_t GAMEPAD_PRODUCT = 0x028e;
+static const int32_t STICK_MAX = 32767;
+static const int32_t TRIGGER_MAX = 1023;
+
+// gamepad buttons and the keys they are sent as
+static const struct
+{
+    uint32_t button;
+    uint16_t code;
+} PAD_KEYS[] = {
+    {PadButtons::A, BTN_A},
+    {PadButtons::B, BTN_B},
+    {PadButtons::X, BTN_X},
+    {PadButtons::Y, BTN_Y},
+    {PadButtons::LeftShoulder, BTN_TL},
+    {PadButtons::RightShoulder, BTN_TR},
+    {PadButtons::View, BTN_SELECT},
+    {PadButtons::Menu, BTN_START},
+    {PadButtons::LeftThumbstick, BTN_THUMBL},
+    {PadButtons::RightThumbstick, BTN_THUMBR},
+};
+static const int NUM_PAD_KEYS = sizeof(PAD_KEYS) / sizeof(PAD_KEYS[0]);
+// gamepad axes, sent after the buttons in this order
+static const uint16_t PAD_AXES[] = {ABS_X,  ABS_Y,  ABS_RX,    ABS_RY,
+                                    ABS_Z,  ABS_RZ, ABS_HAT0X, ABS_HAT0Y};
+
+// the x axis of a force, along which SDL and most games turn a wheel
+static const uint16_t FORCE_DIRECTION = 0x4000;
+static const int16_t MAX_FORCE_LEVEL = 0x7fff;
+
+// returns if a bit is set in an evdev bit mask
+static bool testBit(const unsigned long *bits, int bit)
+{
+    return (bits[bit / LONG_BITS] >> (bit % LONG_BITS)) & 1;
+}
+
+// scales a value to an integer axis from -max - 1 to max, or 0 to max
+static int32_t scale(double value, int32_t max, bool centred)
+{
+    double scaled = std::round(value * max);
+    double min = centred ? -max - 1.0 : 0.0;
+    scaled = scaled < min ? min : scaled;
+    scaled = scaled > max ? max : scaled;
+    return static_cast<int32_t>(scaled);
+}
+
+EvdevSource::EvdevSource(const EvdevDevice &device) : device(device)
+{
+}
+
+// reads the latest frame from the wheel, returns false if disconnected
+bool EvdevSource::read(WheelState &state)
+{
+    if (!device.connected())
+    {
+        return false;
+    }
+    state = device.read();
+    return true;
+}
+
+const char *const UinputGamepadInjector::GAMEPAD_NAME =
+    "Xbox Wheel Compatibility Gamepad";
+
+UinputGamepadInjector::UinputGamepadInjector() : sent{}
+{
+}
+
+UinputGamepadInjector::~UinputGamepadInjector()
+{
+    release();
+}
+
+// opens uinput and describes the gamepad, returns false if uinput is
+// unavailable
+bool UinputGamepadInjector::create()
+{
+    std::string error;
+    if (!gamepad.open(error))
+    {
+        return false;
+    }
+    bool described = true;
+    for (const auto &key : PAD_KEYS)
+    {
+        described = described && gamepad.enableKey(key.code);
+    }
+    for (int i = 0; i < 4; i++)
+    {
+        described = described &&
+                    gamepad.enableAbs(PAD_AXES[i], -STICK_MAX - 1, STICK_MAX);
+    }
+    described = described && gamepad.enableAbs(ABS_Z, 0, TRIGGER_MAX) &&
+                gamepad.enableAbs(ABS_RZ, 0, TRIGGER_MAX) &&
+                gamepad.enableAbs(ABS_HAT0X, -1, 1) &&
+                gamepad.enableAbs(ABS_HAT0Y, -1, 1);
+    if (!described)
+    {
+        gamepad.close();
+    }
+    return described;
+}
+
+// creates the virtual gamepad
+bool UinputGamepadInjector::initialise()
+{
+    std::string error;
+    if (!gamepad.create(GAMEPAD_NAME, GAMEPAD_VENDOR, GAMEPAD_PRODUCT, error))
+    {
+        return false;
+    }
+    // a new device starts with every value at zero
+    std::fill(sent, sent + NUM_VALUES, 0);
+    return true;
+}
+
+// sends the values of a gamepad reading which have changed
+void UinputGamepadInjector::inject(const GamepadState &state)
+{
+    static_assert(NUM_PAD_KEYS + sizeof(PAD_AXES) / sizeof(PAD_AXES[0]) ==
+                      NUM_VALUES,
+                  "every gamepad value must be sent");
+    if (!gamepad.active())
+    {
+        return;
+    }
+    int32_t values[NUM_VALUES];
+    for (int i = 0; i < NUM_PAD_KEYS; i++)
+    {
+        values[i] = (state.buttons & PAD_KEYS[i].button) ? 1 : 0;
+    }
+    // evdev's y axes point down
+    int32_t *axes = values + NUM_PAD_KEYS;
+    axes[0] = scale(state.leftThumbstickX, STICK_MAX, true);
+    axes[1] = scale(-state.leftThumbstickY, STICK_MAX, true);
+    axes[2] = scale(state.rightThumbstickX, STICK_MAX, true);
+    axes[3] = scale(-state.rightThumbstickY, STICK_MAX, true);
+    axes[4] = scale(state.leftTrigger, TRIGGER_MAX, false);
+    axes[5] = scale(state.rightTrigger, TRIGGER_MAX, false);
+    axes[6] = ((state.buttons & PadButtons::DPadRight) ? 1 : 0) -
+              ((state.buttons & PadButtons::DPadLeft) ? 1 : 0);
+    axes[7] = ((state.buttons & PadButtons::DPadDown) ? 1 : 0) -
+              ((state.buttons & PadButtons::DPadUp) ? 1 : 0);
+    bool changed = false;
+    for (int i = 0; i < NUM_VALUES; i++)
+    {
+        if (values[i] == sent[i])
+        {
+            continue;
+        }
+        if (i < NUM_PAD_KEYS)
+        {
+            gamepad.queue(EV_KEY, PAD_KEYS[i].code, values[i]);
+        }
+        else
+        {
+            gamepad.queue(EV_ABS, PAD_AXES[i - NUM_PAD_KEYS], values[i]);
+        }
+        sent[i] = values[i];
+        changed = true;
+    }
+    if (changed && !gamepad.sync())
+    {
+        throw DeviceError(std::string("Unable to write to the gamepad: ") +
+                              std::strerror(errno),
+                          errno);
+    }
+}
+
+// destroys the virtual gamepad
+void UinputGamepadInjector::release()
+{
+    gamepad.close();
+}
+
+// long enough to outlast any gap between polls, short enough that the wheel
+// goes slack soon after the service stops
+const std::chrono::milliseconds EvdevMotor::FORCE_DURATION{500};
+
+EvdevMotor::EvdevMotor(int fd) : fd{fd}, effect{}, thread{}
+{
+    effect.id = -1;
+}
+
+EvdevMotor::~EvdevMotor()
+{
+    release();
+}
+
+// uploads the effect and plays it, returns false on failure
+bool EvdevMotor::play()
+{
+    // uploading an effect with an id updates it, and playing it again
+    // renews the duration
+    if (ioctl(fd, EVIOCSFF, &effect) < 0)
+    {
+        return false;
+    }
+    input_event event{};
+    event.type = EV_FF;
+    event.code = static_cast<uint16_t>(effect.id);
+    event.value = 1;
+    return write(fd, &event, sizeof(event)) == sizeof(event);
+}
+
+// uploads a constant force effect, returns false if it cannot be
+bool EvdevMotor::initialise()
+{
+    if (fd < 0)
+    {
+        return false;
+    }
+    effect = {};
+    effect.type = FF_CONSTANT;
+    effect.id = -1;
+    effect.direction = FORCE_DIRECTION;
+    effect.replay.length = static_cast<uint16_t>(FORCE_DURATION.count());
+    if (!play())
+    {
+        int code = errno;
+        release();
+        throw DeviceError(std::string("Unable to load force effect: ") +
+                              std::strerror(code),
+                          code);
+    }
+    thread = std::make_unique<MotorThread>([this](double force)
+                                           { apply(force); });
+    return true;
+}
+
+// sets the strength of the constant force, on the motor thread
+void EvdevMotor::apply(double force)
+{
+    effect.u.constant.level =
+        static_cast<int16_t>(scale(force, MAX_FORCE_LEVEL, true));
+    if (!play())
+    {
+        int code = errno;
+        throw DeviceError(std::string("Unable to set force: ") +
+                              std::strerror(code),
+                          code);
+    }
+}
+
+// passes the strength of the constant force to the motor thread
+void EvdevMotor::setForce(double force)
+{
+    if (thread)
+    {
+        thread->setForce(force);
+    }
+}
+
+// stops and removes the effect
+void EvdevMotor::release()
+{
+    // the motor thread must not update the effect while it is removed
+    thread.reset();
+    if (effect.id < 0)
+    {
+        return;
+    }
+    // the wheel may already have been disconnected
+    input_event event{};
+    event.type = EV_FF;
+    event.code = static_cast<uint16_t>(effect.id);
+    event.value = 0;
+    if (write(fd, &event, sizeof(event)) == sizeof(event))
+    {
+        ioctl(fd, EVIOCRMFF, effect.id);
+    }
+    effect.id = -1;
+}
+
+EvdevDevice::EvdevDevice(const std::string &path, int fd, bool writable)
+    : path{path}, fd{fd}, writable{writable}, forceFeedback{false},
+      model{}, axes{},
+      keyButtons(KEY_CNT, WheelButtons::None), pending{}, pressed{0},
+      hatX{0}, hatY{0}, dropped{false}, lost{false}
+{
+}
+
+EvdevDevice::~EvdevDevice()
+{
+    ::close(fd);
+}
+
+// opens path, returns null if it is not a racing wheel
+std::shared_ptr<EvdevDevice> EvdevDevice::open(const std::string &path)
+{
+    // force feedback is written to the device, reading only needs read
+    bool writable = true;
+    int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        writable = false;
+        fd = ::open(path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    }
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+    auto device = std::make_shared<EvdevDevice>(path, fd, writable);
+
+    char name[256] = {};
+    unsigned long evBits[EV_CNT / LONG_BITS + 1] = {};
+    unsigned long absBits[ABS_CNT / LONG_BITS + 1] = {};
+    unsigned long keyBits[KEY_CNT / LONG_BITS + 1] = {};
+    unsigned long ffBits[FF_CNT / LONG_BITS + 1] = {};
+    if (ioctl(fd, EVIOCGNAME(sizeof(name) - 1), name) < 0 ||
+        ioctl(fd, EVIOCGBIT(0, sizeof(evBits)), evBits) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(absBits)), absBits) < 0 ||
+        ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(keyBits)), keyBits) < 0)
+    {
+        return nullptr;
+    }
+    ioctl(fd, EVIOCGBIT(EV_FF, sizeof(ffBits)), ffBits);
+
+    // a wheel axis and a pedal, without the right stick of a gamepad
+    uint16_t wheel = testBit(absBits, ABS_WHEEL) ? ABS_WHEEL : ABS_X;
+    uint16_t throttle = testBit(absBits, ABS_GAS) ? ABS_GAS : ABS_Z;
+    uint16_t brake = testBit(absBits, ABS_BRAKE) ? ABS_BRAKE : ABS_RZ;
+    if (std::strcmp(name, UinputGamepadInjector::GAMEPAD_NAME) == 0 ||
+        !testBit(evBits, EV_ABS) || !testBit(evBits, EV_KEY) ||
+        !testBit(absBits, wheel) || testBit(absBits, ABS_RX) ||
+        !(testBit(absBits, throttle) || testBit(absBits, brake)))
+    {
+        return nullptr;
+    }
+    auto addAxis = [&](uint16_t code, bool centred, double WheelState::*value)
+    {
+        input_absinfo info{};
+        if (testBit(absBits, code) && ioctl(fd, EVIOCGABS(code), &info) == 0 &&
+            info.maximum > info.minimum)
+        {
+            device->axes.push_back(
+                Axis{code, info.minimum, info.maximum, centred, value});
+        }
+    };
+    addAxis(wheel, true, &WheelState::wheel);
+    addAxis(throttle, false, &WheelState::throttle);
+    addAxis(brake, false, &WheelState::brake);
+    addAxis(ABS_Y, false, &WheelState::clutch);
+
+    // dpad keys keep their meaning, other buttons are numbered in order
+    int numButtons = 0;
+    for (int code = BTN_MISC; code < KEY_CNT; code++)
+    {
+        if (!testBit(keyBits, code))
+        {
+            continue;
+        }
+        switch (code)
+        {
+        case BTN_DPAD_UP:
+            device->keyButtons[code] = WheelButtons::DPadUp;
+            break;
+        case BTN_DPAD_DOWN:
+            device->keyButtons[code] = WheelButtons::DPadDown;
+            break;
+        case BTN_DPAD_LEFT:
+            device->keyButtons[code] = WheelButtons::DPadLeft;
+            break;
+        case BTN_DPAD_RIGHT:
+            device->keyButtons[code] = WheelButtons::DPadRight;
+            break;
+        default:
+            if (numButtons < 16)
+            {
+                device->keyButtons[code] = WheelButtons::Button1
+                                           << numButtons++;
+            }
+        }
+    }
+    device->forceFeedback = writable && testBit(evBits, EV_FF) &&
+                            testBit(ffBits, FF_CONSTANT);
+    input_id model{};
+    if (ioctl(fd, EVIOCGID, &model) == 0)
+    {
+        device->model = DeviceId{model.vendor, model.product};
+    }
+
+    // timestamp events on the same clock as the poll loop
+    int clock = CLOCK_MONOTONIC;
+    ioctl(fd, EVIOCSCLOCKID, &clock);
+    device->resync();
+    device->state.write(device->pending);
+    return device;
+}
+
+// sets an axis of the pending frame
+void EvdevDevice::setAxis(uint16_t code, int32_t value)
+{
+    for (const Axis &axis : axes)
+    {
+        if (axis.code != code)
+        {
+            continue;
+        }
+        double position =
+            static_cast<double>(value - axis.min) / (axis.max - axis.min);
+        position = position < 0.0 ? 0.0 : position > 1.0 ? 1.0 : position;
+        pending.*axis.value = axis.centred ? position * 2.0 - 1.0 : position;
+        return;
+    }
+}
+
+// sets the buttons of the pending frame from the keys and hat
+void EvdevDevice::setButtons()
+{
+    uint32_t buttons = pressed;
+    buttons |= hatX < 0 ? WheelButtons::DPadLeft : WheelButtons::None;
+    buttons |= hatX > 0 ? WheelButtons::DPadRight : WheelButtons::None;
+    buttons |= hatY < 0 ? WheelButtons::DPadUp : WheelButtons::None;
+    buttons |= hatY > 0 ? WheelButtons::DPadDown : WheelButtons::None;
+    pending.buttons = buttons;
+}
+
+// reads every axis and key from the device into the pending frame
+void EvdevDevice::resync()
+{
+    input_absinfo info{};
+    for (const Axis &axis : axes)
+    {
+        if (ioctl(fd, EVIOCGABS(axis.code), &info) == 0)
+        {
+            setAxis(axis.code, info.value);
+        }
+    }
+    hatX = ioctl(fd, EVIOCGABS(ABS_HAT0X), &info) == 0 ? info.value : 0;
+    hatY = ioctl(fd, EVIOCGABS(ABS_HAT0Y), &info) == 0 ? info.value : 0;
+    unsigned long keys[KEY_CNT / LONG_BITS + 1] = {};
+    pressed = WheelButtons::None;
+    if (ioctl(fd, EVIOCGKEY(sizeof(keys)), keys) >= 0)
+    {
+        for (int code = BTN_MISC; code < KEY_CNT; code++)
+        {
+            if (keyButtons[code] && testBit(keys, code))
+            {
+                pressed |= keyButtons[code];
+            }
+        }
+    }
+    setButtons();
+}
+
+// returns the device node
+const std::string &EvdevDevice::getPath() const
+{
+    return path;
+}
+
+// returns the file descriptor events are read from
+int EvdevDevice::descriptor() const
+{
+    return fd;
+}
+
+// reads every waiting event, publishing each complete frame, returns false
+// if the wheel has been disconnected
+bool EvdevDevice::drain()
+{
+    input_event events[64];
+    for (;;)
+    {
+        ssize_t size = ::read(fd, events, sizeof(events));
+        if (size < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno == EAGAIN;
+        }
+        if (size == 0)
+        {
+            return false;
+        }
+        size_t count = static_cast<size_t>(size) / sizeof(input_event);
+        for (size_t i = 0; i < count; i++)
+        {
+            const input_event &event = events[i];
+            if (event.type == EV_SYN && event.code == SYN_DROPPED)
+            {
+                dropped = true;
+            }
+            else if (event.type == EV_SYN && event.code == SYN_REPORT)
+            {
+                // events up to a dropped frame's report are incomplete
+                if (dropped)
+                {
+                    resync();
+                    dropped = false;
+                }
+                setButtons();
+                pending.timestamp =
+                    static_cast<uint64_t>(event.input_event_sec) * 1000000 +
+                    event.input_event_usec;
+                state.write(pending);
+            }
+            else if (dropped)
+            {
+                continue;
+            }
+            else if (event.type == EV_ABS && event.code == ABS_HAT0X)
+            {
+                hatX = event.value;
+            }
+            else if (event.type == EV_ABS && event.code == ABS_HAT0Y)
+            {
+                hatY = event.value;
+            }
+            else if (event.type == EV_ABS)
+            {
+                setAxis(event.code, event.value);
+            }
+            else if (event.type == EV_KEY && event.code < KEY_CNT)
+            {
+                uint32_t button = keyButtons[event.code];
+                pressed = event.value ? pressed | button : pressed & ~button;
+            }
+        }
+    }
+}
+
+// marks the wheel as disconnected
+void EvdevDevice::disconnect()
+{
+    lost.store(true);
+}
+
+// returns if the wheel is still connected
+bool EvdevDevice::connected() const
+{
+    return !lost.load(std::memory_order_relaxed);
+}
+
+// returns the latest complete frame
+WheelState EvdevDevice::read() const
+{
+    return state.read();
+}
+
+// returns if both devices refer to the same connected wheel
+bool EvdevDevice::matches(const WheelDevice &other) const
+{
+    // the backend opens each connected wheel once
+    return &other == this;
+}
+
+// returns the vendor and product the wheel reports
+DeviceId EvdevDevice::id() const
+{
+    return model;
+}
+
+// opens the wheel for reading
+std::unique_ptr<ReadingSource> EvdevDevice::createSource()
+{
+    return std::make_unique<EvdevSource>(*this);
+}
+
+// creates the injector the wheel's readings are sent to
+std::unique_ptr<GamepadInjector> EvdevDevice::createInjector()
+{
+    return std::make_unique<UinputGamepadInjector>();
+}
+
+// creates the wheel's force feedback motor, or null if it has none
+std::unique_ptr<WheelMotor> EvdevDevice::createMotor()
+{
+    if (!forceFeedback)
+    {
+        return nullptr;
+    }
+    return std::make_unique<EvdevMotor>(fd);
+}
+
+EvdevBackend::EvdevBackend(ThreadPriority priority,
+                           const std::vector<int> &cores)
+    : epollFd{epoll_create1(EPOLL_CLOEXEC)},
+      inotifyFd{inotify_init1(IN_NONBLOCK | IN_CLOEXEC)},
+      wakeFd{eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)},
+      readerPriority{priority}, readerCores{cores}, listener{nullptr}
+{
+    if (epollFd < 0 || wakeFd < 0)
+    {
+        return;
+    }
+    // the wake descriptor is told apart by a null pointer, the inotify
+    // descriptor by this backend, and wheels by their device
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = nullptr;
+    if (epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event) != 0)
+    {
+        return;
+    }
+    // nodes are created before udev makes them readable, so watch both
+    event.data.ptr = this;
+    if (inotifyFd >= 0 &&
+        (inotify_add_watch(inotifyFd, INPUT_DIRECTORY,
+                           IN_CREATE | IN_ATTRIB) < 0 ||
+         epoll_ctl(epollFd, EPOLL_CTL_ADD, inotifyFd, &event) != 0))
+    {
+        ::close(inotifyFd);
+        inotifyFd = -1;
+    }
+    reader = std::thread(&EvdevBackend::run, this);
+}
+
+EvdevBackend::~EvdevBackend()
+{
+    unsubscribe();
+    if (reader.joinable())
+    {
+        uint64_t wake = 1;
+        if (write(wakeFd, &wake, sizeof(wake)) == sizeof(wake))
+        {
+            reader.join();
+        }
+        else
+        {
+            reader.detach();
+        }
+    }
+    for (int fd : {epollFd, inotifyFd, wakeFd})
+    {
+        if (fd >= 0)
+        {
+            ::close(fd);
+        }
+    }
+}
+
+// returns the open wheel at path, opening it if needed, and sets added if it
+// was opened, returns null if path is not a wheel
+std::shared_ptr<EvdevDevice> EvdevBackend::open(const std::string &path,
+                                                bool &added)
+{
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    added = false;
+    auto it = devices.find(path);
+    if (it != devices.end())
+    {
+        return it->second;
+    }
+    std::shared_ptr<EvdevDevice> device = EvdevDevice::open(path);
+    if (!device)
+    {
+        return nullptr;
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.ptr = device.get();
+    if (!reader.joinable() ||
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, device->descriptor(), &event) != 0)
+    {
+        return nullptr;
+    }
+    devices[path] = device;
+    added = true;
+    return device;
+}
+
+// reads wheels and device node changes until stopped
+void EvdevBackend::run()
+{
+    ThreadTuning tuning;
+    tuning.apply(readerPriority, readerCores, "evdev reader");
+    epoll_event events[MAX_EPOLL_EVENTS];
+    for (;;)
+    {
+        int count = epoll_wait(epollFd, events, MAX_EPOLL_EVENTS, -1);
+        if (count < 0 && errno != EINTR)
+        {
+            return;
+        }
+        for (int i = 0; i < count; i++)
+        {
+            void *source = events[i].data.ptr;
+            if (!source)
+            {
+                return;
+            }
+            if (source == this)
+            {
+                readNotifications();
+                continue;
+            }
+            // only this thread removes wheels, so the device is still open
+            auto device = static_cast<EvdevDevice *>(source);
+            if (!device->drain() ||
+                (events[i].events & (EPOLLHUP | EPOLLERR)))
+            {
+                remove(device);
+            }
+        }
+    }
+}
+
+// opens wheels whose device nodes have appeared
+void EvdevBackend::readNotifications()
+{
+    alignas(inotify_event) char buffer[4096];
+    for (;;)
+    {
+        ssize_t size = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (size <= 0)
+        {
+            return;
+        }
+        for (char *next = buffer; next < buffer + size;)
+        {
+            auto notification = reinterpret_cast<inotify_event *>(next);
+            next += sizeof(inotify_event) + notification->len;
+            if (notification->len == 0 ||
+                std::strncmp(notification->name, "event", 5) != 0)
+            {
+                continue;
+            }
+            bool added;
+            std::shared_ptr<EvdevDevice> device = open(
+                std::string(INPUT_DIRECTORY) + "/" + notification->name,
+                added);
+            std::lock_guard<std::mutex> lock(listenerMutex);
+            if (added && listener)
+            {
+                listener->deviceAdded(device);
+            }
+        }
+    }
+}
+
+// closes a disconnected wheel and reports it
+void EvdevBackend::remove(EvdevDevice *device)
+{
+    std::shared_ptr<EvdevDevice> removed;
+    {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        auto it = devices.find(device->getPath());
+        if (it == devices.end() || it->second.get() != device)
+        {
+            return;
+        }
+        removed = it->second;
+        devices.erase(it);
+    }
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, removed->descriptor(), nullptr);
+    removed->disconnect();
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    if (listener)
+    {
+        listener->deviceRemoved(removed);
+    }
+}
+
+// returns the racing wheels currently connected
+std::vector<std::shared_ptr<WheelDevice>> EvdevBackend::scan()
+{
+    std::vector<std::shared_ptr<WheelDevice>> wheels;
+    DIR *dir = opendir(INPUT_DIRECTORY);
+    if (!dir)
+    {
+        return wheels;
+    }
+    while (dirent *entry = readdir(dir))
+    {
+        if (std::strncmp(entry->d_name, "event", 5) != 0)
+        {
+            continue;
+        }
+        bool added;
+        std::shared_ptr<EvdevDevice> device = open(
+            std::string(INPUT_DIRECTORY) + "/" + entry->d_name, added);
+        if (device && device->connected())
+        {
+            wheels.push_back(device);
+        }
+    }
+    closedir(dir);
+    return wheels;
+}
+
+// creates an injector, which any racing wheel can use
+std::unique_ptr<GamepadInjector> EvdevBackend::createInjector()
+{
+    return std::make_unique<UinputGamepadInjector>();
+}
+
+// reports racing wheels as they are connected and disconnected
+bool EvdevBackend::subscribe(DeviceListener *listener)
+{
+    // without inotify new wheels are only found by scanning
+    if (inotifyFd < 0 || !reader.joinable())
+    {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    this->listener = listener;
+    return true;
+}
+
+// stops reporting racing wheels
+void EvdevBackend::unsubscribe()
+{
+    // wait for any report already being made
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listener = nullptr;
+}
@@ -0,0 +1,238 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * evdev_backend.h                                                            *
+ *                                                                            *
+ * Wheels read from Linux evdev devices and injected as a uinput gamepad      *
+ *                                                                            *
+ * One thread waits on every open wheel with epoll and publishes each frame   *
+ * of events as it arrives, so reading a wheel never blocks or polls the      *
+ * device.                                                                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef EVDEV_BACKEND_H
+#define EVDEV_BACKEND_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <linux/input.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "device_backend.h"
+#include "gamepad_injector.h"
+#include "motor_thread.h"
+#include "reading_source.h"
+#include "snapshot.h"
+#include "thread_tuning.h"
+#include "uinput_device.h"
+#include "wheel_motor.h"
+
+class EvdevDevice;
+
+class EvdevSource : public ReadingSource
+{
+  private:
+    const EvdevDevice &device;
+
+  public:
+    EvdevSource(const EvdevDevice &device);
+    // reads the latest frame from the wheel, returns false if disconnected
+    bool read(WheelState &state) override;
+};
+
+class UinputGamepadInjector : public GamepadInjector
+{
+  public:
+    // the name of the virtual gamepad, which is never read as a wheel
+    static const char *const GAMEPAD_NAME;
+
+  private:
+    // buttons, then stick, trigger and hat axes
+    static const int NUM_VALUES = 18;
+
+    UinputDevice gamepad;
+    // the values last sent, as evdev only reports changes
+    int32_t sent[NUM_VALUES];
+
+  public:
+    UinputGamepadInjector();
+    ~UinputGamepadInjector();
+    // opens uinput and describes the gamepad, returns false if uinput is
+    // unavailable
+    bool create() override;
+    // creates the virtual gamepad
+    bool initialise() override;
+    // sends the values of a gamepad reading which have changed
+    void inject(const GamepadState &state) override;
+    // destroys the virtual gamepad
+    void release() override;
+};
+
+class EvdevMotor : public WheelMotor
+{
+  private:
+    // how long each force lasts if the wheel stops being polled
+    static const std::chrono::milliseconds FORCE_DURATION;
+
+    int fd;
+    ff_effect effect;
+    // sets each force, as uploading an effect can block on the device
+    std::unique_ptr<MotorThread> thread;
+
+    // uploads the effect and plays it, returns false on failure
+    bool play();
+    // sets the strength of the constant force, on the motor thread
+    void apply(double force);
+
+  public:
+    EvdevMotor(int fd);
+    ~EvdevMotor();
+    // uploads a constant force effect, returns false if it cannot be
+    bool initialise() override;
+    // passes the strength of the constant force to the motor thread
+    void setForce(double force) override;
+    // stops and removes the effect
+    void release() override;
+};
+
+class EvdevDevice : public WheelDevice
+{
+  private:
+    // an evdev axis and the reading it sets
+    struct Axis
+    {
+        uint16_t code;
+        int32_t min;
+        int32_t max;
+        // maps to -1 to 1 rather than 0 to 1
+        bool centred;
+        double WheelState::*value;
+    };
+
+    std::string path;
+    int fd;
+    bool writable;
+    bool forceFeedback;
+    DeviceId model;
+    std::vector<Axis> axes;
+    // the wheel button flag of each key, or none if it is not reported
+    std::vector<uint32_t> keyButtons;
+    // the frame being received, only used by the reader thread
+    WheelState pending;
+    uint32_t pressed;
+    int32_t hatX;
+    int32_t hatY;
+    // events were lost, so the device is read afresh at the next report
+    bool dropped;
+    Snapshot<WheelState> state;
+    std::atomic<bool> lost;
+
+    // sets an axis of the pending frame
+    void setAxis(uint16_t code, int32_t value);
+    // sets the buttons of the pending frame from the keys and hat
+    void setButtons();
+    // reads every axis and key from the device into the pending frame
+    void resync();
+
+  public:
+    EvdevDevice(const std::string &path, int fd, bool writable);
+    ~EvdevDevice();
+    EvdevDevice &operator=(const EvdevDevice &) = delete;
+    EvdevDevice(const EvdevDevice &) = delete;
+
+    // opens path, returns null if it is not a racing wheel
+    static std::shared_ptr<EvdevDevice> open(const std::string &path);
+    // returns the device node
+    const std::string &getPath() const;
+    // returns the file descriptor events are read from
+    int descriptor() const;
+    // reads every waiting event, publishing each complete frame, returns
+    // false if the wheel has been disconnected
+    bool drain();
+    // marks the wheel as disconnected
+    void disconnect();
+    // returns if the wheel is still connected
+    bool connected() const;
+    // returns the latest complete frame
+    WheelState read() const;
+
+    // returns if both devices refer to the same connected wheel
+    bool matches(const WheelDevice &other) const override;
+    // returns the vendor and product the wheel reports
+    DeviceId id() const override;
+    // opens the wheel for reading
+    std::unique_ptr<ReadingSource> createSource() override;
+    // creates the injector the wheel's readings are sent to
+    std::unique_ptr<GamepadInjector> createInjector() override;
+    // creates the wheel's force feedback motor, or null if it has none
+    std::unique_ptr<WheelMotor> createMotor() override;
+};
+
+class EvdevBackend : public DeviceBackend
+{
+  private:
+    int epollFd;
+    int inotifyFd;
+    // written to stop the reader thread
+    int wakeFd;
+    std::thread reader;
+    // the reader thread is tuned like the poll threads, as it times events
+    ThreadPriority readerPriority;
+    std::vector<int> readerCores;
+    // guards devices between scans and the reader thread
+    std::mutex devicesMutex;
+    // open wheels by device node, removed only by the reader thread
+    std::map<std::string, std::shared_ptr<EvdevDevice>> devices;
+    // guards listener against reports made while unsubscribing
+    std::mutex listenerMutex;
+    DeviceListener *listener;
+
+    // returns the open wheel at path, opening it if needed, and sets added
+    // if it was opened, returns null if path is not a wheel
+    std::shared_ptr<EvdevDevice> open(const std::string &path, bool &added);
+    // reads wheels and device node changes until stopped
+    void run();
+    // opens wheels whose device nodes have appeared
+    void readNotifications();
+    // closes a disconnected wheel and reports it
+    void remove(EvdevDevice *device);
+
+  public:
+    // creates a backend whose reader thread runs at priority on cores, or
+    // on any core if cores is empty
+    EvdevBackend(ThreadPriority priority = ThreadPriority::Normal,
+                 const std::vector<int> &cores = {});
+    ~EvdevBackend();
+    // returns the racing wheels currently connected
+    std::vector<std::shared_ptr<WheelDevice>> scan() override;
+    // creates an injector, which any racing wheel can use
+    std::unique_ptr<GamepadInjector> createInjector() override;
+    // reports racing wheels as they are connected and disconnected
+    bool subscribe(DeviceListener *listener) override;
+    // stops reporting racing wheels
+    void unsubscribe() override;
+};
+
+#endif
@@ -0,0 +1,175 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * force_feedback.cpp                                                         *
+ *                                                                            *
+ * Centring spring, damper and friction forces computed from the steering    *
+ * position on each poll of a wheel                                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "force_feedback.h"
+
+#include <cmath>
+#include <cstdlib>
+
+// friction ramps in over a small speed so a still wheel does not buzz
+const double ForceFeedback::FRICTION_SPEED = 0.05;
+// differentiating a noisy position at 1 kHz gives a noisy speed
+const double ForceFeedback::SPEED_CUTOFF_HZ = 30.0;
+// motors drop a force which is not renewed, see RacingWheelMotor
+const double ForceFeedback::KEEPALIVE_SECONDS = 0.1;
+
+// parses a number, returns false if the text is not a number
+static bool parseNumber(const std::string &text, double &value)
+{
+    char *end;
+    value = std::strtod(text.c_str(), &end);
+    return !text.empty() && *end == '\0' && std::isfinite(value);
+}
+
+// applies ffb.* entries from a profile, returns false and sets error if an
+// entry is invalid
+bool ForceFeedbackSettings::configure(const Profile &profile,
+                                      std::string &error)
+{
+    const std::string prefix = "ffb.";
+    for (const auto &entry : profile.entries())
+    {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        std::string key = entry.first.substr(prefix.size());
+        double number = 0.0;
+        bool isNumber = parseNumber(entry.second, number);
+        if (key == "spring" && isNumber && number >= 0.0)
+        {
+            spring = number;
+        }
+        else if (key == "damper" && isNumber && number >= 0.0)
+        {
+            damper = number;
+        }
+        else if (key == "friction" && isNumber && number >= 0.0 &&
+                 number <= 1.0)
+        {
+            friction = number;
+        }
+        else if (key == "centre" && isNumber && number >= -1.0 &&
+                 number <= 1.0)
+        {
+            centre = number;
+        }
+        else if (key == "gain" && isNumber && number >= 0.0 && number <= 1.0)
+        {
+            gain = number;
+        }
+        else if (key == "min_change" && isNumber && number >= 0.0)
+        {
+            minChange = number;
+        }
+        else
+        {
+            error = "Invalid setting " + entry.first + " = " + entry.second;
+            return false;
+        }
+    }
+    return true;
+}
+
+// returns if any effect is enabled
+bool ForceFeedbackSettings::enabled() const
+{
+    return gain > 0.0 && (spring > 0.0 || damper > 0.0 || friction > 0.0);
+}
+
+ForceFeedback::ForceFeedback(const ForceFeedbackSettings &settings,
+                             int rateHz)
+    : settings(settings), rateHz{static_cast<double>(rateHz)},
+      speedAlpha{1.0 / (1.0 + rateHz / (2.0 * std::acos(-1.0) *
+                                        SPEED_CUTOFF_HZ))},
+      lastPosition{0.0}, speed{0.0}, lastForce{0.0}, unsentTicks{0},
+      keepaliveTicks{static_cast<uint64_t>(rateHz * KEEPALIVE_SECONDS)},
+      primed{false}, motor{nullptr}, sentCount{0}
+{
+}
+
+// returns the force for the next steering position, from -gain to gain
+double ForceFeedback::compute(double position)
+{
+    // a NaN position would stick in the speed estimate
+    position = position == position ? position : lastPosition;
+    if (!primed)
+    {
+        lastPosition = position;
+        speed = 0.0;
+        primed = true;
+    }
+    speed += speedAlpha * ((position - lastPosition) * rateHz - speed);
+    lastPosition = position;
+
+    double friction = speed / FRICTION_SPEED;
+    friction = friction < -1.0 ? -1.0 : (friction > 1.0 ? 1.0 : friction);
+    double force = -settings.spring * (position - settings.centre) -
+                   settings.damper * speed - settings.friction * friction;
+    force = force < -1.0 ? -1.0 : (force > 1.0 ? 1.0 : force);
+    return force * settings.gain;
+}
+
+// computes the force for the next steering position and sends it to the
+// motor if it has changed
+void ForceFeedback::update(double position)
+{
+    double force = compute(position);
+    if (!motor)
+    {
+        return;
+    }
+    if (sentCount > 0 && std::fabs(force - lastForce) < settings.minChange &&
+        ++unsentTicks < keepaliveTicks)
+    {
+        return;
+    }
+    motor->setForce(force);
+    lastForce = force;
+    unsentTicks = 0;
+    sentCount++;
+}
+
+// drives motor, or stops driving one if null, and forgets previous positions
+void ForceFeedback::setMotor(WheelMotor *motor)
+{
+    this->motor = motor;
+    primed = false;
+    lastForce = 0.0;
+    unsentTicks = 0;
+    sentCount = 0;
+}
+
+// returns if a motor is being driven
+bool ForceFeedback::driving() const
+{
+    return motor != nullptr;
+}
+
+// returns the number of forces sent to the motor
+uint64_t ForceFeedback::sent() const
+{
+    return sentCount;
+}
@@ -0,0 +1,98 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * force_feedback.h                                                           *
+ *                                                                            *
+ * Centring spring, damper and friction forces computed from the steering    *
+ * position on each poll of a wheel                                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef FORCE_FEEDBACK_H
+#define FORCE_FEEDBACK_H
+
+#include <cstdint>
+#include <string>
+
+#include "profile.h"
+#include "wheel_motor.h"
+
+// the strength of each effect, all disabled by default
+struct ForceFeedbackSettings
+{
+    // force per unit of steering away from centre
+    double spring = 0.0;
+    // force per unit per second of steering speed
+    double damper = 0.0;
+    // force resisting any movement
+    double friction = 0.0;
+    // steering position the spring pulls towards, from -1 to 1
+    double centre = 0.0;
+    // largest force sent to the motor, from 0 to 1
+    double gain = 1.0;
+    // smallest change in force which is sent to the motor
+    double minChange = 0.002;
+
+    // applies ffb.* entries from a profile, returns false and sets error if
+    // an entry is invalid
+    bool configure(const Profile &profile, std::string &error);
+    // returns if any effect is enabled
+    bool enabled() const;
+};
+
+class ForceFeedback
+{
+  private:
+    // steering speed in units per second at which friction is at full force
+    static const double FRICTION_SPEED;
+    // cutoff in Hz of the steering speed estimate
+    static const double SPEED_CUTOFF_HZ;
+    // longest time an unchanged force goes without being resent
+    static const double KEEPALIVE_SECONDS;
+
+    ForceFeedbackSettings settings;
+    double rateHz;
+    double speedAlpha;
+    double lastPosition;
+    double speed;
+    double lastForce;
+    // polls since a force was last sent, and the most allowed
+    uint64_t unsentTicks;
+    uint64_t keepaliveTicks;
+    bool primed;
+    WheelMotor *motor;
+    uint64_t sentCount;
+
+  public:
+    // creates effects for a wheel polled at rateHz
+    ForceFeedback(const ForceFeedbackSettings &settings, int rateHz);
+    // returns the force for the next steering position, from -gain to gain
+    double compute(double position);
+    // computes the force for the next steering position and sends it to the
+    // motor if it has changed
+    void update(double position);
+    // drives motor, or stops driving one if null, and forgets previous
+    // positions
+    void setMotor(WheelMotor *motor);
+    // returns if a motor is being driven
+    bool driving() const;
+    // returns the number of forces sent to the motor
+    uint64_t sent() const;
+};
+
+#endif
@@ -0,0 +1,54 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * gamepad_injector.h                                                         *
+ *                                                                            *
+ * Interface for virtual gamepads which accept injected input                 *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef GAMEPAD_INJECTOR_H
+#define GAMEPAD_INJECTOR_H
+
+#include <chrono>
+
+#include "input_types.h"
+
+class GamepadInjector
+{
+  public:
+    virtual ~GamepadInjector() = default;
+    // creates the injector, returns false if injection is unavailable
+    virtual bool create()
+    {
+        return true;
+    }
+    // returns the time the injector needs between create and initialise
+    virtual std::chrono::milliseconds settleTime() const
+    {
+        return std::chrono::milliseconds(0);
+    }
+    // prepares the injector for use, returns false on failure
+    virtual bool initialise() = 0;
+    // injects a gamepad reading
+    virtual void inject(const GamepadState &state) = 0;
+    // releases the virtual gamepad
+    virtual void release() = 0;
+};
+
+#endif
@@ -0,0 +1,294 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * gamepad_merger.cpp                                                         *
+ *                                                                            *
+ * Combines the input of several wheels into one virtual gamepad              *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "gamepad_merger.h"
+
+#include <cmath>
+#include <exception>
+#include <thread>
+
+#include "input_pipeline.h"
+#include "output_manager.h"
+
+const std::chrono::milliseconds GamepadMerger::RETRY_DELAY{500};
+
+GamepadMerger::SourceInjector::SourceInjector(Slot &slot) : slot{&slot}
+{
+}
+
+GamepadMerger::SourceInjector::~SourceInjector()
+{
+    // a wheel which failed to initialise never releases its injector
+    release();
+}
+
+bool GamepadMerger::SourceInjector::initialise()
+{
+    return true;
+}
+
+void GamepadMerger::SourceInjector::inject(const GamepadState &state)
+{
+    if (slot)
+    {
+        slot->state.write(state);
+    }
+}
+
+// returns the slot to neutral and frees it for the next wheel
+void GamepadMerger::SourceInjector::release()
+{
+    if (slot)
+    {
+        slot->state.write(GamepadState{});
+        slot->model.store(0, std::memory_order_relaxed);
+        slot->used.store(false, std::memory_order_release);
+        slot = nullptr;
+    }
+}
+
+GamepadMerger::GamepadMerger(DeviceBackend &backend,
+                             const WheelSettings &settings)
+    : backend(backend), settings(settings), slots{}, injector{},
+      executor(SteadyClock::getInstance(), settings, 1), active{false},
+      packetNumber{0}, lastInjected{}, hasInjected{false}, lastInjectTime{},
+      lastOutput{}, changeTime{}, retryTime{}, injectedCount{0}
+{
+    for (Slot &slot : slots)
+    {
+        slot.model.store(0, std::memory_order_relaxed);
+        slot.used.store(false, std::memory_order_relaxed);
+    }
+}
+
+GamepadMerger::~GamepadMerger()
+{
+    stop();
+}
+
+// creates and initialises the merged gamepad and begins injecting, returns
+// false and sets error if it could not be initialised
+bool GamepadMerger::start(std::string &error)
+{
+    if (active.load())
+    {
+        return true;
+    }
+    injector = backend.createInjector();
+    if (!injector)
+    {
+        error = "Merging needs a backend which can create a shared gamepad";
+        return false;
+    }
+    bool created = false;
+    try
+    {
+        created = injector->create();
+        if (created)
+        {
+            std::this_thread::sleep_for(injector->settleTime());
+            if (injector->initialise())
+            {
+                active.store(true);
+                executor.add(this);
+                executor.start();
+                OutputManager::getInstance().log(
+                    "Merging wheels into one gamepad");
+                return true;
+            }
+        }
+        error = "Failed to initialise the merged gamepad";
+    }
+    catch (const std::exception &e)
+    {
+        error = std::string("Failed to initialise the merged gamepad: ") +
+                e.what();
+    }
+    if (created)
+    {
+        injector->release();
+    }
+    injector.reset();
+    return false;
+}
+
+// stops injecting and releases the merged gamepad
+void GamepadMerger::stop()
+{
+    bool expected = true;
+    if (active.compare_exchange_strong(expected, false))
+    {
+        executor.remove(this);
+        executor.stop();
+        injector->release();
+        injector.reset();
+    }
+}
+
+// returns if the merged gamepad is being injected
+bool GamepadMerger::running() const
+{
+    return active.load();
+}
+
+// returns an injector feeding the next free source from a device of model, or
+// null if every source is taken or the merger is stopped
+std::unique_ptr<GamepadInjector> GamepadMerger::attach(DeviceId model)
+{
+    if (!active.load())
+    {
+        return nullptr;
+    }
+    for (Slot &slot : slots)
+    {
+        bool expected = false;
+        if (slot.used.compare_exchange_strong(expected, true))
+        {
+            // the slot is neutral until the wheel's first reading, so merging
+            // it before its model is stored changes nothing
+            slot.model.store(model.key(), std::memory_order_release);
+            return std::make_unique<SourceInjector>(slot);
+        }
+    }
+    return nullptr;
+}
+
+// returns the number of sources attached
+int GamepadMerger::sources() const
+{
+    int count = 0;
+    for (const Slot &slot : slots)
+    {
+        count += slot.used.load(std::memory_order_relaxed);
+    }
+    return count;
+}
+
+// returns the value furthest from rest
+static double furthest(double a, double b)
+{
+    return std::fabs(b) > std::fabs(a) ? b : a;
+}
+
+// returns the latest output of every source combined by the rules
+GamepadState GamepadMerger::merge() const
+{
+    const MergeRules &rules = settings.mergeRules;
+    GamepadState merged;
+    for (int i = 0; i < MAX_SOURCES; i++)
+    {
+        if (!slots[i].used.load(std::memory_order_acquire))
+        {
+            continue;
+        }
+        GamepadState state = slots[i].state.read();
+        DeviceId model;
+        uint32_t key = slots[i].model.load(std::memory_order_acquire);
+        model.vendor = static_cast<uint16_t>(key >> 16);
+        model.product = static_cast<uint16_t>(key);
+        auto takes = [model](DeviceId rule)
+        { return MergeRules::takes(rule, model); };
+        if (takes(rules.steering))
+        {
+            merged.leftThumbstickX =
+                furthest(merged.leftThumbstickX, state.leftThumbstickX);
+        }
+        if (takes(rules.throttle) && state.rightTrigger > merged.rightTrigger)
+        {
+            merged.rightTrigger = state.rightTrigger;
+        }
+        if (takes(rules.brake) && state.leftTrigger > merged.leftTrigger)
+        {
+            merged.leftTrigger = state.leftTrigger;
+        }
+        if (takes(rules.buttons))
+        {
+            merged.buttons |= state.buttons;
+        }
+        // wheels leave the other sticks at rest, so always combine them
+        merged.leftThumbstickY =
+            furthest(merged.leftThumbstickY, state.leftThumbstickY);
+        merged.rightThumbstickX =
+            furthest(merged.rightThumbstickX, state.rightThumbstickX);
+        merged.rightThumbstickY =
+            furthest(merged.rightThumbstickY, state.rightThumbstickY);
+    }
+    return merged;
+}
+
+// injects the merged output
+void GamepadMerger::poll(Clock::time_point now)
+{
+    if (now < retryTime)
+    {
+        return;
+    }
+    GamepadState output = merge();
+    if (!InputPipeline::sameInput(output, lastOutput))
+    {
+        lastOutput = output;
+        changeTime = now;
+    }
+    // skip readings which would not change the gamepad state
+    if (settings.skipUnchanged && hasInjected &&
+        InputPipeline::sameInput(output, lastInjected) &&
+        (settings.keepalive.count() == 0 ||
+         now - lastInjectTime < settings.keepalive))
+    {
+        return;
+    }
+    output.timestamp = packetNumber;
+    try
+    {
+        injector->inject(output);
+    }
+    catch (const DeviceError &e)
+    {
+        OutputManager::getInstance().error(
+            std::string("Merged injection error: ") + e.what());
+        // the wheels keep filling their slots while this backs off
+        retryTime = now + RETRY_DELAY;
+        return;
+    }
+    packetNumber++;
+    lastInjected = output;
+    lastInjectTime = now;
+    hasInjected = true;
+    // only this thread writes the count, so avoid a locked increment
+    injectedCount.store(injectedCount.load(std::memory_order_relaxed) + 1,
+                        std::memory_order_relaxed);
+}
+
+// returns if the merged output has not changed for the idle timeout
+bool GamepadMerger::idle(Clock::time_point now)
+{
+    return settings.idleTimeout.count() > 0 &&
+           now - changeTime >= settings.idleTimeout;
+}
+
+// returns the number of merged readings injected
+uint64_t GamepadMerger::injected() const
+{
+    return injectedCount.load(std::memory_order_relaxed);
+}
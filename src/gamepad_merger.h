@@ -0,0 +1,121 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * gamepad_merger.h                                                           *
+ *                                                                            *
+ * Combines the input of several wheels into one virtual gamepad              *
+ *                                                                            *
+ * Each wheel writes its output to a slot of its own without locking, and     *
+ * the merger reads every slot and injects the combined output once per tick. *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef GAMEPAD_MERGER_H
+#define GAMEPAD_MERGER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "clock.h"
+#include "device_backend.h"
+#include "gamepad_injector.h"
+#include "input_types.h"
+#include "merge_rules.h"
+#include "poll_executor.h"
+#include "pollable.h"
+#include "snapshot.h"
+#include "wheel_settings.h"
+
+class GamepadMerger : public Pollable
+{
+  public:
+    static constexpr int MAX_SOURCES = MergeRules::MAX_SOURCES;
+
+  private:
+    static const std::chrono::milliseconds RETRY_DELAY;
+
+    // the latest output of one wheel, written only by its poll thread
+    struct Slot
+    {
+        Snapshot<GamepadState> state;
+        // the key of the wheel's model, which the rules select by
+        std::atomic<uint32_t> model;
+        std::atomic<bool> used;
+    };
+
+    // the injector given to each merged wheel, which fills its slot
+    class SourceInjector : public GamepadInjector
+    {
+      private:
+        Slot *slot;
+
+      public:
+        SourceInjector(Slot &slot);
+        ~SourceInjector();
+        bool initialise() override;
+        void inject(const GamepadState &state) override;
+        // returns the slot to neutral and frees it for the next wheel
+        void release() override;
+    };
+
+    DeviceBackend &backend;
+    WheelSettings settings;
+    Slot slots[MAX_SOURCES];
+    std::unique_ptr<GamepadInjector> injector;
+    PollExecutor executor;
+    std::atomic<bool> active;
+    // injection state, only used by the poll thread
+    uint64_t packetNumber;
+    GamepadState lastInjected;
+    bool hasInjected;
+    Clock::time_point lastInjectTime;
+    GamepadState lastOutput;
+    Clock::time_point changeTime;
+    Clock::time_point retryTime;
+    std::atomic<uint64_t> injectedCount;
+
+  public:
+    // creates a merger injecting through a gamepad shared by backend
+    GamepadMerger(DeviceBackend &backend, const WheelSettings &settings);
+    ~GamepadMerger();
+    // creates and initialises the merged gamepad and begins injecting,
+    // returns false and sets error if it could not be initialised
+    bool start(std::string &error);
+    // stops injecting and releases the merged gamepad
+    void stop();
+    // returns if the merged gamepad is being injected
+    bool running() const;
+    // returns an injector feeding the next free source from a device of
+    // model, or null if every source is taken or the merger is stopped
+    std::unique_ptr<GamepadInjector> attach(DeviceId model);
+    // returns the number of sources attached
+    int sources() const;
+    // returns the latest output of every source combined by the rules
+    GamepadState merge() const;
+    // injects the merged output
+    void poll(Clock::time_point now) override;
+    // returns if the merged output has not changed for the idle timeout
+    bool idle(Clock::time_point now) override;
+    // returns the number of merged readings injected
+    uint64_t injected() const;
+};
+
+#endif
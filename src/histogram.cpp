@@ -0,0 +1,173 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * histogram.cpp                                                              *
+ *                                                                            *
+ * Fixed size log-linear histogram of durations                               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "histogram.h"
+
+#include <iomanip>
+#include <sstream>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+const int Histogram::SUB_BUCKET_BITS = 5;
+const int Histogram::SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+Histogram::Histogram() : total{0}, maximum{0}
+{
+    for (std::atomic<uint64_t> &count : counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+}
+
+// returns the bucket holding a value
+int Histogram::bucketOf(uint64_t value)
+{
+    if (value < static_cast<uint64_t>(SUB_BUCKETS))
+    {
+        return static_cast<int>(value);
+    }
+#ifdef _MSC_VER
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    int msb = static_cast<int>(index);
+#else
+    int msb = 63 - __builtin_clzll(value);
+#endif
+    int shift = msb - SUB_BUCKET_BITS;
+    int sub = static_cast<int>(value >> shift) - SUB_BUCKETS;
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+// returns the largest value held by a bucket
+uint64_t Histogram::bucketMax(int bucket)
+{
+    if (bucket < SUB_BUCKETS)
+    {
+        return static_cast<uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    uint64_t sub = static_cast<uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS);
+    return ((sub + 1) << shift) - 1;
+}
+
+// records a value, must only be called from one thread at a time
+void Histogram::record(uint64_t value)
+{
+    // single writer, so plain load/store avoids locked instructions
+    std::atomic<uint64_t> &count = counts[bucketOf(value)];
+    count.store(count.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    total.store(total.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+    if (value > maximum.load(std::memory_order_relaxed))
+    {
+        maximum.store(value, std::memory_order_relaxed);
+    }
+}
+
+// returns the value below which the given fraction of values fall
+uint64_t Histogram::percentile(double fraction) const
+{
+    uint64_t value;
+    percentiles(&fraction, &value, 1);
+    return value;
+}
+
+// sets values to the percentile of each of count ascending fractions, in a
+// single pass over the buckets
+void Histogram::percentiles(const double *fractions, uint64_t *values,
+                            int count) const
+{
+    uint64_t recorded = total.load(std::memory_order_relaxed);
+    uint64_t largest = max();
+    int found = 0;
+    if (recorded > 0)
+    {
+        // rank of the next value to find
+        auto targetOf = [&](int index)
+        {
+            uint64_t target =
+                static_cast<uint64_t>(fractions[index] * recorded);
+            return target < recorded ? target : recorded - 1;
+        };
+        uint64_t target = targetOf(0);
+        uint64_t seen = 0;
+        for (int i = 0; i < NUM_BUCKETS && found < count; i++)
+        {
+            seen += counts[i].load(std::memory_order_relaxed);
+            while (found < count && seen > target)
+            {
+                uint64_t value = bucketMax(i);
+                values[found++] = value < largest ? value : largest;
+                if (found < count)
+                {
+                    target = targetOf(found);
+                }
+            }
+        }
+    }
+    // fractions beyond the values seen, or of an empty histogram
+    while (found < count)
+    {
+        values[found++] = recorded > 0 ? largest : 0;
+    }
+}
+
+// returns the largest value recorded
+uint64_t Histogram::max() const
+{
+    return maximum.load(std::memory_order_relaxed);
+}
+
+// returns the number of values recorded
+uint64_t Histogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+// returns p50/p99/p99.9/max of values in ns, formatted in us
+std::string Histogram::describe() const
+{
+    const double fractions[] = {0.5, 0.99, 0.999};
+    uint64_t values[3];
+    percentiles(fractions, values, 3);
+    std::ostringstream ss;
+    ss << std::fixed << std::setprecision(1) << values[0] / 1000.0 << "/"
+       << values[1] / 1000.0 << "/" << values[2] / 1000.0 << "/"
+       << max() / 1000.0 << " us";
+    return ss.str();
+}
+
+// discards all recorded values, must not race with record
+void Histogram::reset()
+{
+    for (std::atomic<uint64_t> &count : counts)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+    total.store(0, std::memory_order_relaxed);
+    maximum.store(0, std::memory_order_relaxed);
+}
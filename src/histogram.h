@@ -0,0 +1,72 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * histogram.h                                                                *
+ *                                                                            *
+ * Fixed size log-linear histogram of durations                               *
+ *                                                                            *
+ * Values are grouped into power of two ranges, each split into 32 linear     *
+ * buckets, giving ~3% precision from 1 ns to centuries without allocating.   *
+ * Recording is single writer; any thread may read.                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class Histogram
+{
+  private:
+    static const int SUB_BUCKET_BITS;
+    static const int SUB_BUCKETS;
+    static const int NUM_BUCKETS = 1920;
+
+    std::atomic<uint64_t> counts[NUM_BUCKETS];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> maximum;
+
+    // returns the bucket holding a value
+    static int bucketOf(uint64_t value);
+    // returns the largest value held by a bucket
+    static uint64_t bucketMax(int bucket);
+
+  public:
+    Histogram();
+    // records a value, must only be called from one thread at a time
+    void record(uint64_t value);
+    // returns the value below which the given fraction of values fall
+    uint64_t percentile(double fraction) const;
+    // sets values to the percentile of each of count ascending fractions,
+    // in a single pass over the buckets
+    void percentiles(const double *fractions, uint64_t *values,
+                     int count) const;
+    // returns the largest value recorded
+    uint64_t max() const;
+    // returns the number of values recorded
+    uint64_t count() const;
+    // returns p50/p99/p99.9/max of values in ns, formatted in us
+    std::string describe() const;
+    // discards all recorded values, must not race with record
+    void reset();
+};
+
+#endif
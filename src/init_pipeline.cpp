@@ -0,0 +1,258 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * init_pipeline.cpp                                                          *
+ *                                                                            *
+ * Initialises injectors in parallel off the scanner thread                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "init_pipeline.h"
+
+#include <algorithm>
+#include <exception>
+
+const char *const InitPipeline::STAGE_NAMES[NUM_STAGES] = {
+    "Create", "Settle", "Initialise", "Total"};
+
+InitPipeline::InitPipeline(int numThreads,
+                           std::chrono::milliseconds stageTimeout)
+    : stageTimeout{stageTimeout}, numThreads{std::max(numThreads, 1)},
+      workers{}, jobs{}, running{}, active{false}, latency{}, timeoutCount{0}
+{
+}
+
+InitPipeline::~InitPipeline()
+{
+    stop();
+}
+
+// runs the stages of jobs as they fall due
+void InitPipeline::run()
+{
+    std::unique_lock<std::mutex> lock(jobsMutex);
+    while (active)
+    {
+        // take the job which falls due first
+        auto next = std::min_element(jobs.begin(), jobs.end(),
+                                     [](const Job &a, const Job &b)
+                                     { return a.due < b.due; });
+        if (next == jobs.end())
+        {
+            jobsChanged.wait(lock);
+            continue;
+        }
+        if (next->due > std::chrono::steady_clock::now())
+        {
+            jobsChanged.wait_until(lock, next->due);
+            continue;
+        }
+        Job job = std::move(*next);
+        jobs.erase(next);
+        GamepadInjector *injector = job.injector;
+        running.push_back(injector);
+
+        // stages may block, so run them without holding up other workers
+        lock.unlock();
+        bool unfinished = runStage(job);
+        lock.lock();
+
+        if (unfinished)
+        {
+            jobs.push_back(std::move(job));
+        }
+        running.erase(std::find(running.begin(), running.end(), injector));
+        jobsChanged.notify_all();
+    }
+}
+
+// runs the next stage of a job, returns false once it has finished
+bool InitPipeline::runStage(Job &job)
+{
+    auto now = std::chrono::steady_clock::now();
+    try
+    {
+        if (job.stage == Stage::Create)
+        {
+            job.stageStart = now;
+            if (!job.injector->create())
+            {
+                finish(job, false, "Failed to create injector");
+                return false;
+            }
+            now = std::chrono::steady_clock::now();
+            if (!endStage(job, now))
+            {
+                return false;
+            }
+            // wait for the injector to settle without occupying a worker
+            job.stage = Stage::Settle;
+            job.stageStart = now;
+            job.due = now + job.injector->settleTime();
+            return true;
+        }
+        endStage(job, now);
+        job.stage = Stage::Initialise;
+        job.stageStart = now;
+        if (!job.injector->initialise())
+        {
+            finish(job, false, "Failed to initialise injector");
+            return false;
+        }
+        if (endStage(job, std::chrono::steady_clock::now()))
+        {
+            finish(job, true, "");
+        }
+    }
+    catch (const std::exception &e)
+    {
+        finish(job, false,
+               std::string("Failed to initialise injector: ") + e.what());
+    }
+    return false;
+}
+
+// ends the current stage of a job, returns false if it overran
+bool InitPipeline::endStage(Job &job,
+                            std::chrono::steady_clock::time_point now)
+{
+    auto elapsed = now - job.stageStart;
+    uint64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    job.result.stageNs[static_cast<int>(job.stage)] = ns;
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        latency[static_cast<int>(job.stage)].record(ns);
+        // settling is a wait the pipeline chose, so cannot overrun
+        if (job.stage == Stage::Settle || elapsed <= stageTimeout)
+        {
+            return true;
+        }
+        timeoutCount++;
+    }
+    // blocking calls cannot be interrupted, so fail once they return
+    finish(job, false,
+           std::string("Injector ") + stageName(job.stage) + " timed out");
+    return false;
+}
+
+// reports the outcome of a job
+void InitPipeline::finish(Job &job, bool initialised,
+                          const std::string &error)
+{
+    auto elapsed = std::chrono::steady_clock::now() - job.submitted;
+    uint64_t ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    job.result.stageNs[static_cast<int>(Stage::Total)] = ns;
+    if (initialised)
+    {
+        std::lock_guard<std::mutex> lock(latencyMutex);
+        latency[static_cast<int>(Stage::Total)].record(ns);
+    }
+    else
+    {
+        job.injector->release();
+    }
+    job.result.initialised = initialised;
+    job.result.error = error;
+    job.done(job.result);
+}
+
+// returns if a stage of an injector is running
+bool InitPipeline::isRunning(const GamepadInjector *injector) const
+{
+    return std::find(running.begin(), running.end(), injector) !=
+           running.end();
+}
+
+// starts the worker threads
+void InitPipeline::start()
+{
+    std::lock_guard<std::mutex> lock(jobsMutex);
+    // prevent re-running threads if already started
+    if (active)
+    {
+        return;
+    }
+    active = true;
+    for (int i = 0; i < numThreads; i++)
+    {
+        workers.push_back(std::thread(&InitPipeline::run, this));
+    }
+}
+
+// stops and joins the worker threads, abandoning waiting injectors once any
+// running stages return
+void InitPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        active = false;
+    }
+    jobsChanged.notify_all();
+    for (std::thread &worker : workers)
+    {
+        worker.join();
+    }
+    workers.clear();
+    jobs.clear();
+}
+
+// initialises an injector, calling done from a worker thread once it has
+// finished or failed
+void InitPipeline::submit(GamepadInjector &injector, Callback done)
+{
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(jobsMutex);
+        jobs.push_back(
+            Job{&injector, std::move(done), Stage::Create, now, now, now, {}});
+    }
+    jobsChanged.notify_all();
+}
+
+// abandons an injector, returns once none of its stages are running, however
+// long a stage blocks, as the caller may then destroy it
+void InitPipeline::cancel(const GamepadInjector &injector)
+{
+    std::unique_lock<std::mutex> lock(jobsMutex);
+    jobsChanged.wait(lock, [&] { return !isRunning(&injector); });
+    jobs.erase(std::remove_if(jobs.begin(), jobs.end(),
+                              [&](const Job &job)
+                              { return job.injector == &injector; }),
+               jobs.end());
+}
+
+// returns the time taken by a stage, in ns
+const Histogram &InitPipeline::getLatency(Stage stage) const
+{
+    return latency[static_cast<int>(stage)];
+}
+
+// returns the number of stages which overran their timeout
+uint64_t InitPipeline::timeouts()
+{
+    std::lock_guard<std::mutex> lock(latencyMutex);
+    return timeoutCount;
+}
+
+// returns the display name of a stage
+const char *InitPipeline::stageName(Stage stage)
+{
+    return STAGE_NAMES[static_cast<int>(stage)];
+}
@@ -0,0 +1,130 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * init_pipeline.h                                                            *
+ *                                                                            *
+ * Initialises injectors in parallel off the scanner thread                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef INIT_PIPELINE_H
+#define INIT_PIPELINE_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gamepad_injector.h"
+#include "histogram.h"
+
+class InitPipeline
+{
+  public:
+    // stages of initialising an injector, Total covers every stage
+    enum class Stage
+    {
+        Create,
+        Settle,
+        Initialise,
+        Total
+    };
+    static constexpr int NUM_STAGES = 4;
+
+    // the outcome of initialising an injector
+    struct Result
+    {
+        bool initialised;
+        // why initialisation failed
+        std::string error;
+        // time taken by each stage, in ns
+        uint64_t stageNs[NUM_STAGES];
+    };
+    typedef std::function<void(const Result &result)> Callback;
+
+  private:
+    static const char *const STAGE_NAMES[NUM_STAGES];
+
+    // an injector waiting for its next stage
+    struct Job
+    {
+        GamepadInjector *injector;
+        Callback done;
+        Stage stage;
+        std::chrono::steady_clock::time_point due;
+        std::chrono::steady_clock::time_point stageStart;
+        std::chrono::steady_clock::time_point submitted;
+        Result result;
+    };
+
+    std::chrono::milliseconds stageTimeout;
+    int numThreads;
+    std::vector<std::thread> workers;
+    // guards jobs, running and active
+    std::mutex jobsMutex;
+    std::condition_variable jobsChanged;
+    std::vector<Job> jobs;
+    std::vector<GamepadInjector *> running;
+    bool active;
+    // guards latency, which is recorded from every worker
+    std::mutex latencyMutex;
+    Histogram latency[NUM_STAGES];
+    uint64_t timeoutCount;
+
+    // runs the stages of jobs as they fall due
+    void run();
+    // runs the next stage of a job, returns false once it has finished
+    bool runStage(Job &job);
+    // ends the current stage of a job, returns false if it overran
+    bool endStage(Job &job, std::chrono::steady_clock::time_point now);
+    // reports the outcome of a job
+    void finish(Job &job, bool initialised, const std::string &error);
+    // returns if a stage of an injector is running
+    bool isRunning(const GamepadInjector *injector) const;
+
+  public:
+    // creates a pipeline running stages on numThreads threads, failing any
+    // stage which takes longer than stageTimeout, checked once the stage
+    // returns as a blocking stage cannot be interrupted, so the timeout does
+    // not bound how long stop or cancel wait
+    InitPipeline(int numThreads, std::chrono::milliseconds stageTimeout);
+    ~InitPipeline();
+    // starts the worker threads
+    void start();
+    // stops and joins the worker threads, abandoning waiting injectors once
+    // any running stages return
+    void stop();
+    // initialises an injector, calling done from a worker thread once it
+    // has finished or failed
+    void submit(GamepadInjector &injector, Callback done);
+    // abandons an injector, returns once none of its stages are running,
+    // however long a stage blocks, as the caller may then destroy it
+    void cancel(const GamepadInjector &injector);
+    // returns the time taken by a stage, in ns
+    const Histogram &getLatency(Stage stage) const;
+    // returns the number of stages which overran their timeout
+    uint64_t timeouts();
+    // returns the display name of a stage
+    static const char *stageName(Stage stage);
+};
+
+#endif
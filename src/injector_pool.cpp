@@ -0,0 +1,158 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * injector_pool.cpp                                                          *
+ *                                                                            *
+ * Keeps injectors initialised ahead of time for new wheels                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "injector_pool.h"
+
+#include <algorithm>
+
+InjectorPool::InjectorPool(DeviceBackend &backend, InitPipeline &initPipeline,
+                           size_t size)
+    : backend(backend), initPipeline(initPipeline), size{size}, ready{},
+      warming{}, active{false}, hitCount{0}, missCount{0}
+{
+}
+
+InjectorPool::~InjectorPool()
+{
+    stop();
+}
+
+// begins initialising injectors until the pool would be full, must be
+// called with injectorsMutex held
+void InjectorPool::refill()
+{
+    while (active && ready.size() + warming.size() < size)
+    {
+        std::unique_ptr<GamepadInjector> injector = backend.createInjector();
+        if (!injector)
+        {
+            return;
+        }
+        GamepadInjector *pending = injector.get();
+        warming.push_back(std::move(injector));
+        initPipeline.submit(*pending,
+                            [this, pending](const InitPipeline::Result &result)
+                            { warmed(pending, result.initialised); });
+    }
+}
+
+// moves an injector from warming to ready once initialised
+void InjectorPool::warmed(GamepadInjector *injector, bool initialised)
+{
+    std::lock_guard<std::mutex> lock(injectorsMutex);
+    auto found = std::find_if(
+        warming.begin(), warming.end(),
+        [&](const std::unique_ptr<GamepadInjector> &warm)
+        { return warm.get() == injector; });
+    if (found == warming.end())
+    {
+        return;
+    }
+    // a failed injector is retried when the pool is next used, and recycled
+    // injectors may already have filled the pool
+    if (initialised && ready.size() < size)
+    {
+        ready.push_back(std::move(*found));
+    }
+    else if (initialised)
+    {
+        (*found)->release();
+    }
+    warming.erase(found);
+}
+
+// begins filling the pool, initPipeline must be running
+void InjectorPool::start()
+{
+    std::lock_guard<std::mutex> lock(injectorsMutex);
+    active = true;
+    refill();
+}
+
+// releases every pooled injector, abandoning any being initialised
+void InjectorPool::stop()
+{
+    std::vector<std::unique_ptr<GamepadInjector>> abandoned;
+    {
+        std::lock_guard<std::mutex> lock(injectorsMutex);
+        active = false;
+        abandoned.swap(warming);
+        for (std::unique_ptr<GamepadInjector> &injector : ready)
+        {
+            injector->release();
+        }
+        ready.clear();
+    }
+    // cancel outside the lock, as finishing a stage calls warmed
+    for (std::unique_ptr<GamepadInjector> &injector : abandoned)
+    {
+        initPipeline.cancel(*injector);
+        injector->release();
+    }
+}
+
+// returns an initialised injector, or null if none are ready
+std::unique_ptr<GamepadInjector> InjectorPool::acquire()
+{
+    std::lock_guard<std::mutex> lock(injectorsMutex);
+    if (ready.empty())
+    {
+        missCount.fetch_add(1, std::memory_order_relaxed);
+        refill();
+        return nullptr;
+    }
+    hitCount.fetch_add(1, std::memory_order_relaxed);
+    std::unique_ptr<GamepadInjector> injector = std::move(ready.back());
+    ready.pop_back();
+    refill();
+    return injector;
+}
+
+// returns an injector to neutral and keeps it for the next wheel if there is
+// room, otherwise releases it
+void InjectorPool::recycle(std::unique_ptr<GamepadInjector> injector)
+{
+    // the gamepad stays connected, so let go of every input the wheel held
+    // rather than leave games reading them until the next wheel
+    injector->inject(GamepadState{});
+    std::lock_guard<std::mutex> lock(injectorsMutex);
+    if (!active || ready.size() >= size)
+    {
+        injector->release();
+        return;
+    }
+    ready.push_back(std::move(injector));
+}
+
+// returns the number of wheels given an initialised injector
+uint64_t InjectorPool::hits() const
+{
+    return hitCount.load(std::memory_order_relaxed);
+}
+
+// returns the number of wheels which found the pool empty
+uint64_t InjectorPool::misses() const
+{
+    return missCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,79 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * injector_pool.h                                                            *
+ *                                                                            *
+ * Keeps injectors initialised ahead of time for new wheels                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef INJECTOR_POOL_H
+#define INJECTOR_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "device_backend.h"
+#include "gamepad_injector.h"
+#include "init_pipeline.h"
+
+class InjectorPool
+{
+  private:
+    DeviceBackend &backend;
+    InitPipeline &initPipeline;
+    size_t size;
+    // guards ready, warming and active
+    std::mutex injectorsMutex;
+    std::vector<std::unique_ptr<GamepadInjector>> ready;
+    std::vector<std::unique_ptr<GamepadInjector>> warming;
+    bool active;
+    std::atomic<uint64_t> hitCount;
+    std::atomic<uint64_t> missCount;
+
+    // begins initialising injectors until the pool would be full, must be
+    // called with injectorsMutex held
+    void refill();
+    // moves an injector from warming to ready once initialised
+    void warmed(GamepadInjector *injector, bool initialised);
+
+  public:
+    // creates a pool of up to size injectors from backend, initialised by
+    // initPipeline
+    InjectorPool(DeviceBackend &backend, InitPipeline &initPipeline,
+                 size_t size);
+    ~InjectorPool();
+    // begins filling the pool, initPipeline must be running
+    void start();
+    // releases every pooled injector, abandoning any being initialised
+    void stop();
+    // returns an initialised injector, or null if none are ready
+    std::unique_ptr<GamepadInjector> acquire();
+    // returns an injector to neutral and keeps it for the next wheel if
+    // there is room, otherwise releases it
+    void recycle(std::unique_ptr<GamepadInjector> injector);
+    // returns the number of wheels given an initialised injector
+    uint64_t hits() const;
+    // returns the number of wheels which found the pool empty
+    uint64_t misses() const;
+};
+
+#endif
@@ -0,0 +1,231 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * input_pipeline.cpp                                                         *
+ *                                                                            *
+ * Reads, maps and injects input for a single wheel                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "input_pipeline.h"
+
+const double InputPipeline::NO_INPUT = 0.0;
+const char *const InputPipeline::STAGE_NAMES[NUM_STAGES] = {"Read", "Map",
+                                                            "Inject", "Total"};
+// reading the clock costs tens of ns, so only time a sample of ticks
+const uint64_t InputPipeline::TIMING_INTERVAL = 4;
+
+InputPipeline::InputPipeline(ReadingSource &source, GamepadInjector &injector,
+                             const WheelSettings &settings)
+    : source(source), injector(injector), settings(settings), filters{},
+      forceFeedback(settings.forceFeedback, settings.pollRateHz),
+      packetNumber{0},
+      latest{}, lastInjected{}, hasInjected{false}, lastInjectTime{},
+      lastOutput{}, hasOutput{false}, changeTime{},
+      injectedCount{0}, skippedCount{0}, recorder{nullptr}, published{nullptr},
+      latency{}, tickCount{0}
+{
+    const AxisFilter *const lanes[AxisFilterBank::LANES] = {
+        &this->settings.steeringFilter, &this->settings.throttleFilter,
+        &this->settings.brakeFilter, nullptr};
+    filters.configure(lanes, settings.pollRateHz);
+}
+
+// returns if two readings produce the same input, ignoring timestamps
+bool InputPipeline::sameInput(const GamepadState &a, const GamepadState &b)
+{
+    return a.buttons == b.buttons && a.leftTrigger == b.leftTrigger &&
+           a.rightTrigger == b.rightTrigger &&
+           a.leftThumbstickX == b.leftThumbstickX &&
+           a.leftThumbstickY == b.leftThumbstickY &&
+           a.rightThumbstickX == b.rightThumbstickX &&
+           a.rightThumbstickY == b.rightThumbstickY;
+}
+
+// records the duration of a stage
+void InputPipeline::record(Stage stage,
+                           std::chrono::steady_clock::duration duration)
+{
+    latency[static_cast<int>(stage)].record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(duration)
+            .count());
+}
+
+// reads, maps and injects one reading, returns false if source is lost
+bool InputPipeline::tick(std::chrono::steady_clock::time_point now)
+{
+    // time one tick in every TIMING_INTERVAL
+    bool timed =
+        settings.timeStages && tickCount++ % TIMING_INTERVAL == 0;
+    std::chrono::steady_clock::time_point start, read, mapped, injected;
+    if (timed)
+    {
+        start = std::chrono::steady_clock::now();
+    }
+
+    WheelState reading;
+    if (!source.read(reading))
+    {
+        return false;
+    }
+    if (timed)
+    {
+        read = std::chrono::steady_clock::now();
+    }
+
+    // drive the motor before anything else, so force follows the wheel
+    // as closely as possible
+    if (forceFeedback.driving())
+    {
+        forceFeedback.update(reading.wheel);
+    }
+
+    // smooth the axes, leaving the reading itself as the wheel sent it
+    double axes[AxisFilterBank::LANES] = {reading.wheel, reading.throttle,
+                                          reading.brake, 0.0};
+    if (filters.enabled())
+    {
+        filters.process(axes);
+    }
+
+    // compile output
+    GamepadState newOutput;
+    newOutput.timestamp = packetNumber;
+    newOutput.buttons = settings.buttonMap.map(reading.buttons);
+    newOutput.leftTrigger = settings.brakeCurve.apply(axes[2]);
+    newOutput.rightTrigger = settings.throttleCurve.apply(axes[1]);
+    newOutput.leftThumbstickX = settings.steeringCurve.apply(axes[0]);
+    newOutput.leftThumbstickY = NO_INPUT;
+    newOutput.rightThumbstickX = NO_INPUT;
+    newOutput.rightThumbstickY = NO_INPUT;
+    WheelSample sample{reading, newOutput};
+    latest.write(sample);
+    if (!hasOutput || !sameInput(newOutput, lastOutput))
+    {
+        lastOutput = newOutput;
+        hasOutput = true;
+        changeTime = now;
+    }
+    if (recorder)
+    {
+        recorder->record(sample, now);
+    }
+    if (published)
+    {
+        published->write(sample);
+    }
+    if (timed)
+    {
+        mapped = std::chrono::steady_clock::now();
+        record(Stage::Read, read - start);
+        record(Stage::Map, mapped - read);
+    }
+
+    // skip readings which would not change the gamepad state
+    if (settings.skipUnchanged && hasInjected &&
+        sameInput(newOutput, lastInjected) &&
+        (settings.keepalive.count() == 0 ||
+         now - lastInjectTime < settings.keepalive))
+    {
+        skippedCount.fetch_add(1, std::memory_order_relaxed);
+        if (timed)
+        {
+            record(Stage::Total, mapped - start);
+        }
+        return true;
+    }
+
+    // inject output
+    injector.inject(newOutput);
+    packetNumber++;
+    lastInjected = newOutput;
+    lastInjectTime = now;
+    hasInjected = true;
+    injectedCount.fetch_add(1, std::memory_order_relaxed);
+    if (timed)
+    {
+        injected = std::chrono::steady_clock::now();
+        record(Stage::Inject, injected - mapped);
+        record(Stage::Total, injected - start);
+    }
+    return true;
+}
+
+// records every reading to channel, or stops recording if null,
+// must not be called while ticking
+void InputPipeline::setRecorder(RecordChannel *channel)
+{
+    recorder = channel;
+}
+
+// publishes every reading to target, or stops publishing if null, must not
+// be called while ticking
+void InputPipeline::setPublisher(Snapshot<WheelSample> *target)
+{
+    published = target;
+}
+
+// drives motor from every reading, or stops driving it if null, must not be
+// called while ticking
+void InputPipeline::setMotor(WheelMotor *motor)
+{
+    forceFeedback.setMotor(motor);
+}
+
+// returns the most recently mapped reading
+GamepadState InputPipeline::getOutput() const
+{
+    return latest.read().output;
+}
+
+// returns the most recent reading and its mapping, safe from any thread
+WheelSample InputPipeline::getSample() const
+{
+    return latest.read();
+}
+
+// returns the number of readings injected
+uint64_t InputPipeline::injected() const
+{
+    return injectedCount.load(std::memory_order_relaxed);
+}
+
+// returns the number of unchanged readings which were not injected
+uint64_t InputPipeline::skipped() const
+{
+    return skippedCount.load(std::memory_order_relaxed);
+}
+
+// returns the time of the last tick whose output differed from the previous
+// tick's, must be called from the ticking thread
+std::chrono::steady_clock::time_point InputPipeline::lastChange() const
+{
+    return changeTime;
+}
+
+// returns the time taken by a stage of each tick, in ns
+const Histogram &InputPipeline::getLatency(Stage stage) const
+{
+    return latency[static_cast<int>(stage)];
+}
+
+// returns the display name of a stage
+const char *InputPipeline::stageName(Stage stage)
+{
+    return STAGE_NAMES[static_cast<int>(stage)];
+}
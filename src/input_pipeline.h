@@ -0,0 +1,117 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * input_pipeline.h                                                           *
+ *                                                                            *
+ * Reads, maps and injects input for a single wheel                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef INPUT_PIPELINE_H
+#define INPUT_PIPELINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "axis_filter.h"
+#include "force_feedback.h"
+#include "gamepad_injector.h"
+#include "histogram.h"
+#include "input_types.h"
+#include "reading_source.h"
+#include "session_recorder.h"
+#include "snapshot.h"
+#include "wheel_settings.h"
+
+class InputPipeline
+{
+  public:
+    // parts of a tick which are timed, Total covers the whole tick
+    enum class Stage
+    {
+        Read,
+        Map,
+        Inject,
+        Total
+    };
+    static constexpr int NUM_STAGES = 4;
+
+  private:
+    static const double NO_INPUT;
+    static const char *const STAGE_NAMES[NUM_STAGES];
+    static const uint64_t TIMING_INTERVAL;
+
+    ReadingSource &source;
+    GamepadInjector &injector;
+    WheelSettings settings;
+    AxisFilterBank filters;
+    ForceFeedback forceFeedback;
+    uint64_t packetNumber;
+    Snapshot<WheelSample> latest;
+    GamepadState lastInjected;
+    bool hasInjected;
+    std::chrono::steady_clock::time_point lastInjectTime;
+    // the previous output, injected or not, and when the output last changed
+    GamepadState lastOutput;
+    bool hasOutput;
+    std::chrono::steady_clock::time_point changeTime;
+    std::atomic<uint64_t> injectedCount;
+    std::atomic<uint64_t> skippedCount;
+    RecordChannel *recorder;
+    Snapshot<WheelSample> *published;
+    Histogram latency[NUM_STAGES];
+    uint64_t tickCount;
+
+    // records the duration of a stage
+    void record(Stage stage, std::chrono::steady_clock::duration duration);
+
+  public:
+    InputPipeline(ReadingSource &source, GamepadInjector &injector,
+                  const WheelSettings &settings);
+    // reads, maps and injects one reading, returns false if source is lost
+    bool tick(std::chrono::steady_clock::time_point now);
+    // records every reading to channel, or stops recording if null,
+    // must not be called while ticking
+    void setRecorder(RecordChannel *channel);
+    // publishes every reading to target, or stops publishing if null,
+    // must not be called while ticking
+    void setPublisher(Snapshot<WheelSample> *target);
+    // drives motor from every reading, or stops driving it if null, must not
+    // be called while ticking
+    void setMotor(WheelMotor *motor);
+    // returns the most recently mapped reading
+    GamepadState getOutput() const;
+    // returns the most recent reading and its mapping, safe from any thread
+    WheelSample getSample() const;
+    // returns the number of readings injected
+    uint64_t injected() const;
+    // returns the number of unchanged readings which were not injected
+    uint64_t skipped() const;
+    // returns the time of the last tick whose output differed from the
+    // previous tick's, must be called from the ticking thread
+    std::chrono::steady_clock::time_point lastChange() const;
+    // returns the time taken by a stage of each tick, in ns
+    const Histogram &getLatency(Stage stage) const;
+    // returns the display name of a stage
+    static const char *stageName(Stage stage);
+    // returns if two readings produce the same input, ignoring timestamps
+    static bool sameInput(const GamepadState &a, const GamepadState &b);
+};
+
+#endif
@@ -0,0 +1,111 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * input_types.h                                                              *
+ *                                                                            *
+ * Platform independent wheel and gamepad readings                            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef INPUT_TYPES_H
+#define INPUT_TYPES_H
+
+#include <cstdint>
+
+// racing wheel button flags, values match RacingWheelButtons
+struct WheelButtons
+{
+    static constexpr uint32_t None = 0x0;
+    static constexpr uint32_t PreviousGear = 0x1;
+    static constexpr uint32_t NextGear = 0x2;
+    static constexpr uint32_t DPadUp = 0x4;
+    static constexpr uint32_t DPadDown = 0x8;
+    static constexpr uint32_t DPadLeft = 0x10;
+    static constexpr uint32_t DPadRight = 0x20;
+    static constexpr uint32_t Button1 = 0x40;
+    static constexpr uint32_t Button2 = 0x80;
+    static constexpr uint32_t Button3 = 0x100;
+    static constexpr uint32_t Button4 = 0x200;
+    static constexpr uint32_t Button5 = 0x400;
+    static constexpr uint32_t Button6 = 0x800;
+    static constexpr uint32_t Button7 = 0x1000;
+    static constexpr uint32_t Button8 = 0x2000;
+    static constexpr uint32_t Button9 = 0x4000;
+    static constexpr uint32_t Button10 = 0x8000;
+    static constexpr uint32_t Button11 = 0x10000;
+    static constexpr uint32_t Button12 = 0x20000;
+    static constexpr uint32_t Button13 = 0x40000;
+    static constexpr uint32_t Button14 = 0x80000;
+    static constexpr uint32_t Button15 = 0x100000;
+    static constexpr uint32_t Button16 = 0x200000;
+};
+
+// gamepad button flags, values match GamepadButtons
+struct PadButtons
+{
+    static constexpr uint32_t None = 0x0;
+    static constexpr uint32_t Menu = 0x1;
+    static constexpr uint32_t View = 0x2;
+    static constexpr uint32_t A = 0x4;
+    static constexpr uint32_t B = 0x8;
+    static constexpr uint32_t X = 0x10;
+    static constexpr uint32_t Y = 0x20;
+    static constexpr uint32_t DPadUp = 0x40;
+    static constexpr uint32_t DPadDown = 0x80;
+    static constexpr uint32_t DPadLeft = 0x100;
+    static constexpr uint32_t DPadRight = 0x200;
+    static constexpr uint32_t LeftShoulder = 0x400;
+    static constexpr uint32_t RightShoulder = 0x800;
+    static constexpr uint32_t LeftThumbstick = 0x1000;
+    static constexpr uint32_t RightThumbstick = 0x2000;
+};
+
+// a single reading from a racing wheel
+struct WheelState
+{
+    uint64_t timestamp = 0;
+    uint32_t buttons = WheelButtons::None;
+    double wheel = 0.0;
+    double throttle = 0.0;
+    double brake = 0.0;
+    double clutch = 0.0;
+    double handbrake = 0.0;
+    int32_t patternShifterGear = 0;
+};
+
+// a single reading to be injected as a gamepad
+struct GamepadState
+{
+    uint64_t timestamp = 0;
+    uint32_t buttons = PadButtons::None;
+    double leftTrigger = 0.0;
+    double rightTrigger = 0.0;
+    double leftThumbstickX = 0.0;
+    double leftThumbstickY = 0.0;
+    double rightThumbstickX = 0.0;
+    double rightThumbstickY = 0.0;
+};
+
+// a wheel reading paired with the gamepad reading it was mapped to
+struct WheelSample
+{
+    WheelState input;
+    GamepadState output;
+};
+
+#endif
@@ -0,0 +1,51 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * log_record.h                                                               *
+ *                                                                            *
+ * A preformatted log message of fixed size                                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef LOG_RECORD_H
+#define LOG_RECORD_H
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+struct LogRecord
+{
+    // longer messages are truncated
+    static constexpr size_t TEXT_SIZE = 248;
+
+    uint32_t length;
+    bool error;
+    char text[TEXT_SIZE];
+
+    // copies a message into the record, truncating it if necessary
+    void set(const std::string &message, bool isError)
+    {
+        length = static_cast<uint32_t>(
+            message.size() < TEXT_SIZE ? message.size() : TEXT_SIZE);
+        error = isError;
+        std::memcpy(text, message.data(), length);
+    }
+};
+
+#endif
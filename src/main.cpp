@@ -23,30 +23,174 @@
  ******************************************************************************/
 
 #include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
 
+#include "metrics_server.h"
 #include "output_manager.h"
+#include "profile.h"
+#include "profile_cache.h"
+#include "session_recorder.h"
+#include "state_publisher.h"
+#include "thread_tuning.h"
+#include "wake_signal.h"
 #include "wheel_manager.h"
+#include "wheel_settings.h"
+#ifdef _WIN32
+#include "winrt_backend.h"
+#else
+#include "evdev_backend.h"
+#endif
 
-static const DWORD SLEEP_DURATION_MS = 100;
+static const int MAX_TELEMETRY_RATE_HZ = 120;
+static const int MAX_POOLED_INJECTORS = 8;
+static const int MAX_PORT = 65535;
 
 static WheelManager *g_wheelManager = nullptr;
-static std::atomic<bool> g_shutdownComplete{false};
-
+static MetricsServer *g_metricsServer = nullptr;
+static WakeSignal g_shutdownComplete;
+#ifdef _WIN32
 BOOL WINAPI controlHandler(DWORD signal);
+#else
+// how often the main loop checks for signals if they cannot wake it
+static const int SLEEP_DURATION_MS = 100;
+static std::atomic<bool> g_shutdownRequested{false};
+// written by the signal handler to wake the main loop
+static int g_signalPipe[2] = {-1, -1};
+void signalHandler(int signal);
+#endif
+bool parseCount(const char *arg, int &value);
+bool parseWaitMode(const std::string &arg, WaitMode &mode);
+bool parseCores(const std::string &arg, std::vector<int> &cores);
+bool applyProfile(const std::string &path, WheelSettings &settings,
+                  std::string &error);
 
 int main(int argc, char **argv)
 {
     bool telemetry = false;
+    std::string recordPath;
+    std::string publishName;
+    std::string profileDirectory;
+    int metricsPort = 0;
+    WheelSettings settings;
     // parse command line arguments
     for (int i = 1; i < argc; i++)
     {
         std::string arg = argv[i];
+        int value;
         if (arg == "-t")
         {
             telemetry = true;
         }
+        else if (arg == "-d")
+        {
+            settings.skipUnchanged = true;
+        }
+        else if (arg == "-x")
+        {
+            // favour polling over everything else the service does
+            settings.pollPriority = ThreadPriority::RealTime;
+            settings.backgroundPriority = ThreadPriority::Low;
+        }
+        else if (arg == "-c" && i + 1 < argc &&
+                 parseCores(argv[i + 1], settings.pollCores))
+        {
+            i++;
+        }
+        else if (arg == "-k" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value))
+        {
+            settings.keepalive = std::chrono::milliseconds(value);
+            i++;
+        }
+        else if (arg == "-f" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value) && Pacer::validRate(value))
+        {
+            settings.pollRateHz = value;
+            i++;
+        }
+        else if (arg == "-a" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value))
+        {
+            settings.idleTimeout = std::chrono::milliseconds(value);
+            i++;
+        }
+        else if (arg == "-e" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value))
+        {
+            settings.pollThreads = value;
+            i++;
+        }
+        else if (arg == "-g")
+        {
+            settings.mergeWheels = true;
+        }
+        else if (arg == "-i" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value) &&
+                 value <= MAX_POOLED_INJECTORS)
+        {
+            settings.pooledInjectors = value;
+            i++;
+        }
+        else if (arg == "-l" && i + 1 < argc)
+        {
+            profileDirectory = argv[++i];
+        }
+        else if (arg == "-m" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value) && value > 0 &&
+                 value <= MAX_PORT)
+        {
+            metricsPort = value;
+            i++;
+        }
+        else if (arg == "-o" && i + 1 < argc)
+        {
+            publishName = argv[++i];
+        }
+        else if (arg == "-p" && i + 1 < argc)
+        {
+            std::string error;
+            if (!applyProfile(argv[++i], settings, error))
+            {
+                std::cerr << error << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "-r" && i + 1 < argc)
+        {
+            recordPath = argv[++i];
+        }
+        else if (arg == "-s")
+        {
+            settings.latencySummary = true;
+        }
+        else if (arg == "-u" && i + 1 < argc &&
+                 parseCount(argv[i + 1], value) && value > 0 &&
+                 value <= MAX_TELEMETRY_RATE_HZ)
+        {
+            settings.telemetryRateHz = value;
+            i++;
+        }
+        else if (arg == "-w" && i + 1 < argc &&
+                 parseWaitMode(argv[i + 1], settings.waitMode))
+        {
+            i++;
+        }
         else
         {
             // print help message
@@ -54,7 +198,52 @@ int main(int argc, char **argv)
                       << std::endl
                       << "Options:" << std::endl
                       << "-h Show this help message and exit" << std::endl
-                      << "-t Print wheel input data to console" << std::endl;
+                      << "-t Print wheel input data to console" << std::endl
+                      << "-d Only inject readings which have changed"
+                      << std::endl
+                      << "-k <ms> Keepalive interval when using -d (0 = none)"
+                      << std::endl
+                      << "-f <hz> Polling rate: 125, 250, 500 or 1000"
+                      << std::endl
+                      << "-w <mode> Wait mode: sleep, spin or hybrid "
+                         "(default sleep)"
+                      << std::endl
+                      << "-x Poll at real time priority, and discover and "
+                         "draw at low priority"
+                      << std::endl
+                      << "-c <cores> Poll only on the listed cores, such as "
+                         "2,3"
+                      << std::endl
+                      << "-a <ms> Poll at 125 Hz after <ms> without input "
+                         "changes (0 = never)"
+                      << std::endl
+                      << "-e <n> Poll all wheels from n shared threads "
+                         "(0 = one thread per wheel)"
+                      << std::endl
+                      << "-g Inject every wheel through one gamepad"
+                      << std::endl
+                      << "-i <n> Keep up to 8 injectors initialised ahead "
+                         "of time (default 0)"
+                      << std::endl
+                      << "-l <dir> Tune each wheel model with its profile "
+                         "from a directory"
+                      << std::endl
+                      << "-m <port> Serve Prometheus metrics on "
+                         "localhost:<port>/metrics"
+                      << std::endl
+                      << "-o <name> Publish wheel state to shared memory "
+                         "called <name>"
+                      << std::endl
+                      << "-p <file> Load button mappings and axis curves "
+                         "from a profile"
+                      << std::endl
+                      << "-r <file> Record every wheel reading to a file"
+                      << std::endl
+                      << "-s Print each wheel's polling latency when it stops"
+                      << std::endl
+                      << "-u <hz> Telemetry refresh rate, up to 120 "
+                         "(default 10)"
+                      << std::endl;
             if (arg == "-h")
             {
                 return EXIT_SUCCESS;
@@ -69,6 +258,7 @@ int main(int argc, char **argv)
     OutputManager &outputManager = OutputManager::getInstance();
     outputManager.log("Initialising...");
 
+#ifdef _WIN32
     try
     {
         init_apartment();
@@ -79,15 +269,108 @@ int main(int argc, char **argv)
         uninit_apartment();
         return EXIT_FAILURE;
     }
+#endif
+
+    // record wheels to a file, opened before any wheel is found
+    SessionRecorder recorder;
+    if (!recordPath.empty())
+    {
+        std::string error;
+        if (!recorder.open(recordPath, error))
+        {
+            outputManager.error(error);
+#ifdef _WIN32
+            uninit_apartment();
+#endif
+            return EXIT_FAILURE;
+        }
+        outputManager.log("Recording to " + recordPath);
+    }
+
+    // map the profiles of each wheel model, compiling them if they changed
+    ProfileCache profiles;
+    if (!profileDirectory.empty())
+    {
+        std::string error;
+        if (!profiles.load(profileDirectory, error))
+        {
+            outputManager.error(error);
+#ifdef _WIN32
+            uninit_apartment();
+#endif
+            return EXIT_FAILURE;
+        }
+        outputManager.log(std::string(profiles.rebuilt() ? "Compiled "
+                                                         : "Loaded ") +
+                          std::to_string(profiles.size()) +
+                          " device profiles");
+    }
+
+    // share wheel state with overlays, opened before any wheel is found
+    StatePublisher publisher;
+    if (!publishName.empty())
+    {
+        std::string error;
+        if (publisher.open(publishName, settings.pollRateHz, error))
+        {
+            outputManager.log("Publishing wheel state to " + publishName);
+        }
+        else
+        {
+            outputManager.error(error);
+        }
+    }
 
-    WheelManager wheelManager;
+#ifdef _WIN32
+    WinrtBackend backend;
+#else
+    EvdevBackend backend(settings.pollPriority, settings.pollCores);
+#endif
+    WheelManager wheelManager(backend, settings,
+                              recorder.recording() ? &recorder : nullptr,
+                              publisher.publishing() ? &publisher : nullptr,
+                              profileDirectory.empty() ? nullptr : &profiles);
+
+    // serve counters for monitoring, stopped before the wheel manager
+    MetricsServer metricsServer([&wheelManager](MetricsWriter &out)
+                                { wheelManager.writeMetrics(out); });
+    if (metricsPort > 0)
+    {
+        std::string error;
+        if (metricsServer.start(static_cast<uint16_t>(metricsPort), error))
+        {
+            outputManager.log("Serving metrics on http://localhost:" +
+                              std::to_string(metricsPort) + "/metrics");
+        }
+        else
+        {
+            outputManager.error(error);
+        }
+    }
+    // both are set before the handlers which stop them are installed
     g_wheelManager = &wheelManager;
+    g_metricsServer = &metricsServer;
 
+#ifdef _WIN32
     // set control handler
     if (!SetConsoleCtrlHandler(controlHandler, TRUE))
     {
         outputManager.error("unable to set control handler");
     }
+#else
+    // stop on ctrl+c or when stopped by a service manager
+    if (pipe2(g_signalPipe, O_CLOEXEC | O_NONBLOCK) != 0)
+    {
+        g_signalPipe[0] = g_signalPipe[1] = -1;
+    }
+    struct sigaction action = {};
+    action.sa_handler = signalHandler;
+    if (sigaction(SIGINT, &action, nullptr) != 0 ||
+        sigaction(SIGTERM, &action, nullptr) != 0)
+    {
+        outputManager.error("unable to set signal handler");
+    }
+#endif
 
     outputManager.log("Done");
     wheelManager.start();
@@ -96,15 +379,26 @@ int main(int argc, char **argv)
         wheelManager.startTelemetry();
     }
 
-    MSG msg;
+#ifdef _WIN32
     HANDLE hConsole = GetStdHandle(STD_INPUT_HANDLE);
     DWORD mode;
-    GetConsoleMode(hConsole, &mode);
+    bool console = GetConsoleMode(hConsole, &mode) != 0;
     SetConsoleMode(hConsole, mode & ~(ENABLE_LINE_INPUT | ENABLE_ECHO_INPUT));
+    // the control handler stops the manager and then raises the signal
+    HANDLE handles[] = {static_cast<HANDLE>(g_shutdownComplete.handle()),
+                        hConsole};
     while (wheelManager.running())
     {
+        // sleep until a key is pressed or the service is stopped
+        DWORD woken =
+            WaitForMultipleObjects(console ? 2 : 1, handles, FALSE, INFINITE);
+        if (woken == WAIT_FAILED)
+        {
+            break;
+        }
         DWORD numEvents;
-        if (GetNumberOfConsoleInputEvents(hConsole, &numEvents) &&
+        if (woken == WAIT_OBJECT_0 + 1 &&
+            GetNumberOfConsoleInputEvents(hConsole, &numEvents) &&
             numEvents > 0)
         {
             INPUT_RECORD inputRecord;
@@ -119,38 +413,193 @@ int main(int argc, char **argv)
                 }
             }
         }
-
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(SLEEP_DURATION_MS));
     }
 
     SetConsoleMode(hConsole, mode);
+#else
+    // read keys as they are pressed when run from a terminal
+    termios terminal;
+    bool interactive = tcgetattr(STDIN_FILENO, &terminal) == 0;
+    if (interactive)
+    {
+        termios keys = terminal;
+        keys.c_lflag &= ~(ICANON | ECHO);
+        tcsetattr(STDIN_FILENO, TCSANOW, &keys);
+    }
+    bool reading = interactive;
+    pollfd inputs[] = {{g_signalPipe[0], POLLIN, 0},
+                       {STDIN_FILENO, POLLIN, 0}};
+    int timeout = g_signalPipe[0] >= 0 ? -1 : SLEEP_DURATION_MS;
+    while (!g_shutdownRequested.load())
+    {
+        // sleep until a key is pressed or a signal arrives
+        if (poll(inputs, reading ? 2 : 1, timeout) <= 0)
+        {
+            continue;
+        }
+        char key;
+        if (reading && inputs[1].revents)
+        {
+            ssize_t count = read(STDIN_FILENO, &key, 1);
+            // stop reading a terminal which has gone away
+            reading = count > 0 || (count < 0 && errno == EINTR);
+            if (count == 1 && (key == 't' || key == 'T'))
+            {
+                wheelManager.toggleTelemetry();
+            }
+        }
+    }
+    // the manager cannot be stopped from within a signal handler
+    outputManager.log("Shutting down...");
+    metricsServer.stop();
+    wheelManager.stop();
+    g_shutdownComplete.raise();
 
-    // wait for shutdown to complete
-    while (!g_shutdownComplete.load())
+    if (interactive)
     {
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(SLEEP_DURATION_MS));
+        tcsetattr(STDIN_FILENO, TCSANOW, &terminal);
     }
+#endif
+
+    // wait for shutdown to complete
+    g_shutdownComplete.wait();
 
+#ifdef _WIN32
+    // the handler runs on a thread of its own, so remove it before the
+    // objects it stops go away
+    SetConsoleCtrlHandler(controlHandler, FALSE);
+#endif
     g_wheelManager = nullptr;
+    g_metricsServer = nullptr;
+    if (recorder.recording())
+    {
+        recorder.close();
+        outputManager.log("Recorded " + std::to_string(recorder.written()) +
+                          " readings, dropped " +
+                          std::to_string(recorder.dropped()));
+        if (recorder.failed())
+        {
+            outputManager.error("Unable to write all readings to " +
+                                recordPath);
+        }
+    }
+#ifdef _WIN32
     uninit_apartment();
+#endif
 
     return EXIT_SUCCESS;
 }
 
+#ifdef _WIN32
 // stops wheel manager on program exit
 BOOL WINAPI controlHandler(DWORD signal)
 {
     if (signal == CTRL_C_EVENT || signal == CTRL_CLOSE_EVENT)
     {
         OutputManager::getInstance().log("Shutting down...");
+        // scrapes read the wheels, so stop serving them first
+        if (g_metricsServer)
+        {
+            g_metricsServer->stop();
+        }
         if (g_wheelManager)
         {
             g_wheelManager->stop();
-            g_shutdownComplete.store(true);
+            g_shutdownComplete.raise();
         }
         return TRUE;
     }
     return FALSE;
 }
+#else
+// asks the main loop to stop the wheel manager on program exit
+void signalHandler(int signal)
+{
+    g_shutdownRequested.store(true);
+    // only async signal safe calls may be made here
+    int savedErrno = errno;
+    char wake = 0;
+    if (g_signalPipe[1] >= 0 && write(g_signalPipe[1], &wake, 1) < 0)
+    {
+        // the pipe is full, so the main loop is already awake
+    }
+    errno = savedErrno;
+}
+#endif
+
+// parses a non-negative integer argument
+bool parseCount(const char *arg, int &value)
+{
+    char *end;
+    long parsed = std::strtol(arg, &end, 10);
+    if (end == arg || *end != '\0' || parsed < 0 || parsed > INT_MAX)
+    {
+        return false;
+    }
+    value = static_cast<int>(parsed);
+    return true;
+}
+
+// parses a pacer wait mode argument
+bool parseWaitMode(const std::string &arg, WaitMode &mode)
+{
+    if (arg == "sleep")
+    {
+        mode = WaitMode::Sleep;
+    }
+    else if (arg == "spin")
+    {
+        mode = WaitMode::Spin;
+    }
+    else if (arg == "hybrid")
+    {
+        mode = WaitMode::Hybrid;
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+// parses a comma separated list of cores
+bool parseCores(const std::string &arg, std::vector<int> &cores)
+{
+    std::vector<int> parsed;
+    size_t start = 0;
+    while (start <= arg.size())
+    {
+        size_t end = arg.find(',', start);
+        if (end == std::string::npos)
+        {
+            end = arg.size();
+        }
+        int core;
+        if (!parseCount(arg.substr(start, end - start).c_str(), core) ||
+            core >= ThreadTuning::numCores())
+        {
+            return false;
+        }
+        parsed.push_back(core);
+        start = end + 1;
+    }
+    cores = parsed;
+    return true;
+}
+
+// loads a profile file into the wheel settings
+bool applyProfile(const std::string &path, WheelSettings &settings,
+                  std::string &error)
+{
+    Profile profile;
+    return Profile::load(path, profile, error) &&
+           settings.buttonMap.configure(profile, error) &&
+           settings.steeringCurve.configure(profile, "steering", error) &&
+           settings.throttleCurve.configure(profile, "throttle", error) &&
+           settings.brakeCurve.configure(profile, "brake", error) &&
+           settings.steeringFilter.configure(profile, "steering", error) &&
+           settings.throttleFilter.configure(profile, "throttle", error) &&
+           settings.brakeFilter.configure(profile, "brake", error) &&
+           settings.forceFeedback.configure(profile, error) &&
+           settings.mergeRules.configure(profile, error);
+}
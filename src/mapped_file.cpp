@@ -0,0 +1,138 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * mapped_file.cpp                                                            *
+ *                                                                            *
+ * Read only memory mapping of a whole file                                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile()
+    : view{nullptr}, viewSize{0}
+#ifdef _WIN32
+      ,
+      file{INVALID_HANDLE_VALUE}, mapping{nullptr}
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+// maps the file at path read only, returns false and sets error on failure
+bool MappedFile::open(const std::string &path, std::string &error)
+{
+    close();
+    error = "Unable to map " + path;
+#ifdef _WIN32
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    LARGE_INTEGER fileSize;
+    if (file == INVALID_HANDLE_VALUE || !GetFileSizeEx(file, &fileSize) ||
+        fileSize.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view)
+    {
+        close();
+        return false;
+    }
+    viewSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // an empty file cannot be mapped
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        ::close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, static_cast<size_t>(info.st_size),
+                        PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED)
+    {
+        return false;
+    }
+    view = mapped;
+    viewSize = static_cast<size_t>(info.st_size);
+#endif
+    error.clear();
+    return true;
+}
+
+// unmaps the file
+void MappedFile::close()
+{
+#ifdef _WIN32
+    if (view)
+    {
+        UnmapViewOfFile(view);
+    }
+    if (mapping)
+    {
+        CloseHandle(mapping);
+    }
+    if (file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file);
+    }
+    file = INVALID_HANDLE_VALUE;
+    mapping = nullptr;
+#else
+    if (view)
+    {
+        munmap(const_cast<void *>(view), viewSize);
+    }
+#endif
+    view = nullptr;
+    viewSize = 0;
+}
+
+// returns the mapped file, or null if none is mapped
+const void *MappedFile::data() const
+{
+    return view;
+}
+
+// returns the size of the mapped file
+size_t MappedFile::size() const
+{
+    return viewSize;
+}
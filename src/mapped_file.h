@@ -0,0 +1,58 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * mapped_file.h                                                              *
+ *                                                                            *
+ * Read only memory mapping of a whole file                                   *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile
+{
+  private:
+    const void *view;
+    size_t viewSize;
+#ifdef _WIN32
+    void *file;
+    void *mapping;
+#endif
+
+  public:
+    MappedFile();
+    ~MappedFile();
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(const MappedFile &) = delete;
+
+    // maps the file at path read only, returns false and sets error on
+    // failure
+    bool open(const std::string &path, std::string &error);
+    // unmaps the file
+    void close();
+    // returns the mapped file, or null if none is mapped
+    const void *data() const;
+    // returns the size of the mapped file
+    size_t size() const;
+};
+
+#endif
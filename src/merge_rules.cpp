@@ -0,0 +1,81 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * merge_rules.cpp                                                            *
+ *                                                                            *
+ * Which wheel each part of a merged gamepad is taken from                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "merge_rules.h"
+
+// parses all or <vendor>:<product>, returns false if the text is neither
+static bool parseSource(const std::string &text, DeviceId &source)
+{
+    if (text == "all")
+    {
+        source = DeviceId{};
+        return true;
+    }
+    return DeviceId::parse(text, source);
+}
+
+// applies merge.* entries from a profile, returns false and sets error if
+// an entry is invalid
+bool MergeRules::configure(const Profile &profile, std::string &error)
+{
+    const std::string prefix = "merge.";
+    for (const auto &entry : profile.entries())
+    {
+        if (entry.first.compare(0, prefix.size(), prefix) != 0)
+        {
+            continue;
+        }
+        std::string key = entry.first.substr(prefix.size());
+        DeviceId source;
+        bool isSource = parseSource(entry.second, source);
+        if (key == "steering" && isSource)
+        {
+            steering = source;
+        }
+        else if (key == "throttle" && isSource)
+        {
+            throttle = source;
+        }
+        else if (key == "brake" && isSource)
+        {
+            brake = source;
+        }
+        else if (key == "buttons" && isSource)
+        {
+            buttons = source;
+        }
+        else
+        {
+            error = "Invalid setting " + entry.first + " = " + entry.second;
+            return false;
+        }
+    }
+    return true;
+}
+
+// returns if a part with rule is taken from a device of model
+bool MergeRules::takes(DeviceId rule, DeviceId model)
+{
+    return rule.key() == 0 || rule.key() == model.key();
+}
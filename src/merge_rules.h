@@ -0,0 +1,53 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * merge_rules.h                                                              *
+ *                                                                            *
+ * Which wheel each part of a merged gamepad is taken from                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef MERGE_RULES_H
+#define MERGE_RULES_H
+
+#include <string>
+
+#include "device_backend.h"
+#include "profile.h"
+
+// the model of the device each part of the merged gamepad is taken from, so
+// a part follows the same hardware however devices are found, or zero ids to
+// combine every device, where the axis furthest from rest wins and a button
+// held on any device is held
+struct MergeRules
+{
+    static constexpr int MAX_SOURCES = 8;
+
+    DeviceId steering{};
+    DeviceId throttle{};
+    DeviceId brake{};
+    DeviceId buttons{};
+
+    // applies merge.* entries from a profile, returns false and sets error
+    // if an entry is invalid
+    bool configure(const Profile &profile, std::string &error);
+    // returns if a part with rule is taken from a device of model
+    static bool takes(DeviceId rule, DeviceId model);
+};
+
+#endif
@@ -0,0 +1,267 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * metrics_server.cpp                                                         *
+ *                                                                            *
+ * Serves metrics to Prometheus on a localhost socket                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "metrics_server.h"
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+typedef SOCKET Socket;
+typedef int SocketLength;
+static const int SEND_FLAGS = 0;
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+typedef int Socket;
+typedef socklen_t SocketLength;
+static const Socket INVALID_SOCKET = -1;
+// a scraper hanging up must not raise SIGPIPE
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+static int closesocket(Socket socket)
+{
+    return close(socket);
+}
+#endif
+
+const std::chrono::milliseconds MetricsServer::ACCEPT_INTERVAL{100};
+const std::chrono::milliseconds MetricsServer::REQUEST_TIMEOUT{1000};
+const size_t MetricsServer::MAX_REQUEST_SIZE = 4096;
+
+// connects to port on the loopback interface and hangs up, waking a thread
+// waiting to accept on it
+static void knock(uint16_t port)
+{
+    Socket socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (socket == INVALID_SOCKET)
+    {
+        return;
+    }
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    connect(socket, reinterpret_cast<sockaddr *>(&address), sizeof(address));
+    closesocket(socket);
+}
+
+// returns if a socket becomes readable within timeout
+static bool waitReadable(Socket socket, std::chrono::milliseconds timeout)
+{
+    fd_set readable;
+    FD_ZERO(&readable);
+    FD_SET(socket, &readable);
+    timeval wait{static_cast<long>(timeout.count() / 1000),
+                 static_cast<long>(timeout.count() % 1000 * 1000)};
+    // the first argument is ignored on Windows
+    return select(static_cast<int>(socket) + 1, &readable, nullptr, nullptr,
+                  &wait) > 0;
+}
+
+// sends all of data, returns false if the client went away
+static bool sendAll(Socket socket, const std::string &data)
+{
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+        int count = send(socket, data.data() + sent,
+                         static_cast<int>(data.size() - sent), SEND_FLAGS);
+        if (count <= 0)
+        {
+            return false;
+        }
+        sent += count;
+    }
+    return true;
+}
+
+MetricsServer::MetricsServer(Collector collector)
+    : collector{std::move(collector)},
+      listener{static_cast<intptr_t>(INVALID_SOCKET)}, boundPort{0},
+      active{false}, scrapeCount{0}
+{
+}
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+// accepts and answers scrapes one at a time
+void MetricsServer::run()
+{
+    Socket socket = static_cast<Socket>(listener);
+    while (active.load())
+    {
+        // stopping connects to wake this wait, the interval only covers that
+        // connection failing
+        if (!waitReadable(socket, ACCEPT_INTERVAL))
+        {
+            continue;
+        }
+        Socket client = accept(socket, nullptr, nullptr);
+        if (client != INVALID_SOCKET && !active.load())
+        {
+            closesocket(client);
+        }
+        else if (client != INVALID_SOCKET)
+        {
+            serve(static_cast<intptr_t>(client));
+            closesocket(client);
+        }
+    }
+}
+
+// answers a single request
+void MetricsServer::serve(intptr_t client)
+{
+    Socket socket = static_cast<Socket>(client);
+    // read the request line and headers, ignoring any body
+    std::string request;
+    char buffer[512];
+    while (request.find("\r\n\r\n") == std::string::npos &&
+           request.size() < MAX_REQUEST_SIZE)
+    {
+        if (!waitReadable(socket, REQUEST_TIMEOUT))
+        {
+            return;
+        }
+        int count = recv(socket, buffer, sizeof(buffer), 0);
+        if (count <= 0)
+        {
+            return;
+        }
+        request.append(buffer, count);
+    }
+
+    std::string status, body, type;
+    if (request.compare(0, 13, "GET /metrics ") == 0)
+    {
+        writer.clear();
+        collector(writer);
+        status = "200 OK";
+        type = "text/plain; version=0.0.4; charset=utf-8";
+        body = writer.text();
+        scrapeCount.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        status = "404 Not Found";
+        type = "text/plain; charset=utf-8";
+        body = "Metrics are served at /metrics\n";
+    }
+    sendAll(socket, "HTTP/1.0 " + status + "\r\nContent-Type: " + type +
+                        "\r\nContent-Length: " +
+                        std::to_string(body.size()) +
+                        "\r\nConnection: close\r\n\r\n" + body);
+}
+
+// listens on port of the loopback interface, or any free port if 0, returns
+// false and sets error on failure
+bool MetricsServer::start(uint16_t port, std::string &error)
+{
+    if (active.load())
+    {
+        return true;
+    }
+#ifdef _WIN32
+    WSADATA data;
+    if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+    {
+        error = "Unable to start Winsock";
+        return false;
+    }
+#endif
+    Socket socket = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+#ifndef _WIN32
+    // allow restarting on the same port while old connections close
+    int reuse = 1;
+    setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+#endif
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    // only this machine may scrape
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(port);
+    SocketLength length = sizeof(address);
+    if (socket == INVALID_SOCKET ||
+        bind(socket, reinterpret_cast<sockaddr *>(&address), length) != 0 ||
+        listen(socket, SOMAXCONN) != 0 ||
+        getsockname(socket, reinterpret_cast<sockaddr *>(&address),
+                    &length) != 0)
+    {
+        error = "Unable to listen for metrics on port " + std::to_string(port);
+        if (socket != INVALID_SOCKET)
+        {
+            closesocket(socket);
+        }
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    listener = static_cast<intptr_t>(socket);
+    boundPort = ntohs(address.sin_port);
+    active.store(true);
+    thread = std::thread(&MetricsServer::run, this);
+    return true;
+}
+
+// stops listening
+void MetricsServer::stop()
+{
+    if (!active.load())
+    {
+        return;
+    }
+    active.store(false);
+    knock(boundPort);
+    if (thread.joinable())
+    {
+        thread.join();
+    }
+    closesocket(static_cast<Socket>(listener));
+    listener = static_cast<intptr_t>(INVALID_SOCKET);
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+// returns the port being listened on
+uint16_t MetricsServer::port() const
+{
+    return boundPort;
+}
+
+// returns the number of scrapes answered
+uint64_t MetricsServer::scrapes() const
+{
+    return scrapeCount.load(std::memory_order_relaxed);
+}
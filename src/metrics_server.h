@@ -0,0 +1,76 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * metrics_server.h                                                           *
+ *                                                                            *
+ * Serves metrics to Prometheus on a localhost socket                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+#include "metrics_writer.h"
+
+class MetricsServer
+{
+  public:
+    // writes the current value of every metric
+    typedef std::function<void(MetricsWriter &out)> Collector;
+
+  private:
+    static const std::chrono::milliseconds ACCEPT_INTERVAL;
+    static const std::chrono::milliseconds REQUEST_TIMEOUT;
+    static const size_t MAX_REQUEST_SIZE;
+
+    Collector collector;
+    // a SOCKET on Windows and a file descriptor elsewhere
+    intptr_t listener;
+    uint16_t boundPort;
+    std::atomic<bool> active;
+    std::atomic<uint64_t> scrapeCount;
+    std::thread thread;
+    MetricsWriter writer;
+
+    // accepts and answers scrapes one at a time
+    void run();
+    // answers a single request
+    void serve(intptr_t client);
+
+  public:
+    MetricsServer(Collector collector);
+    ~MetricsServer();
+    // listens on port of the loopback interface, or any free port if 0,
+    // returns false and sets error on failure
+    bool start(uint16_t port, std::string &error);
+    // stops listening
+    void stop();
+    // returns the port being listened on
+    uint16_t port() const;
+    // returns the number of scrapes answered
+    uint64_t scrapes() const;
+};
+
+#endif
@@ -0,0 +1,85 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * metrics_writer.cpp                                                         *
+ *                                                                            *
+ * Formats metrics in the Prometheus text format                              *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "metrics_writer.h"
+
+#include <cstdio>
+
+// starts a metric, type being "counter" or "gauge"
+void MetricsWriter::family(const std::string &name, const char *type,
+                           const char *help)
+{
+    this->name = name;
+    output += "# HELP " + name + " " + help + "\n";
+    output += "# TYPE " + name + " " + type + "\n";
+}
+
+// writes a value of the current metric
+void MetricsWriter::sample(double value)
+{
+    // counts below 10^15 are printed exactly, without a fraction
+    char formatted[32];
+    std::snprintf(formatted, sizeof(formatted), "%.15g", value);
+    output += name + " " + formatted + "\n";
+}
+
+// writes a value of the current metric with a single label
+void MetricsWriter::sample(const char *label, const std::string &labelValue,
+                           double value)
+{
+    char formatted[32];
+    std::snprintf(formatted, sizeof(formatted), "%.15g", value);
+    output += name + "{" + label + "=\"";
+    for (char c : labelValue)
+    {
+        // escape as the format requires
+        if (c == '\\' || c == '"')
+        {
+            output += '\\';
+            output += c;
+        }
+        else if (c == '\n')
+        {
+            output += "\\n";
+        }
+        else
+        {
+            output += c;
+        }
+    }
+    output += "\"} " + std::string(formatted) + "\n";
+}
+
+// returns everything written
+const std::string &MetricsWriter::text() const
+{
+    return output;
+}
+
+// discards everything written
+void MetricsWriter::clear()
+{
+    output.clear();
+    name.clear();
+}
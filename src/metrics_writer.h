@@ -0,0 +1,50 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * metrics_writer.h                                                           *
+ *                                                                            *
+ * Formats metrics in the Prometheus text format                              *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef METRICS_WRITER_H
+#define METRICS_WRITER_H
+
+#include <string>
+
+class MetricsWriter
+{
+  private:
+    std::string output;
+    std::string name;
+
+  public:
+    // starts a metric, type being "counter" or "gauge"
+    void family(const std::string &name, const char *type, const char *help);
+    // writes a value of the current metric
+    void sample(double value);
+    // writes a value of the current metric with a single label
+    void sample(const char *label, const std::string &labelValue,
+                double value);
+    // returns everything written
+    const std::string &text() const;
+    // discards everything written
+    void clear();
+};
+
+#endif
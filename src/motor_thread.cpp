@@ -0,0 +1,94 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * motor_thread.cpp                                                           *
+ *                                                                            *
+ * Drives a wheel motor from a thread of its own, so the driver calls which   *
+ * set each force never block the thread polling the wheel                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "motor_thread.h"
+
+#include "device_backend.h"
+
+// starts a thread which passes each force set to apply, which may throw
+// DeviceError
+MotorThread::MotorThread(std::function<void(double)> apply)
+    : apply{std::move(apply)}, stopping{false}, failed{false}, errorCode{0}
+{
+    thread = std::thread(&MotorThread::run, this);
+}
+
+// stops the thread, waiting for any force being applied
+MotorThread::~MotorThread()
+{
+    stopping.store(true);
+    wake.raise();
+    thread.join();
+}
+
+// applies each new force until stopped
+void MotorThread::run()
+{
+    // the value the snapshot starts with was never set
+    uint64_t applied = target.version();
+    while (true)
+    {
+        wake.wait();
+        // lower the signal before reading, so a force published after the
+        // read raises it again
+        wake.reset();
+        if (stopping.load())
+        {
+            return;
+        }
+        uint64_t version;
+        double force = target.read(version);
+        if (version == applied)
+        {
+            continue;
+        }
+        applied = version;
+        try
+        {
+            apply(force);
+        }
+        catch (const DeviceError &e)
+        {
+            // keep applying later forces, as a transient failure may pass
+            std::lock_guard<std::mutex> lock(errorMutex);
+            errorMessage = e.what();
+            errorCode = e.code();
+            failed.store(true);
+        }
+    }
+}
+
+// publishes a force for the thread to apply without waiting, throws
+// DeviceError if applying an earlier force failed
+void MotorThread::setForce(double force)
+{
+    if (failed.load() && failed.exchange(false))
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        throw DeviceError(errorMessage, errorCode);
+    }
+    target.write(force);
+    wake.raise();
+}
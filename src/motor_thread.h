@@ -0,0 +1,71 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * motor_thread.h                                                             *
+ *                                                                            *
+ * Drives a wheel motor from a thread of its own, so the driver calls which   *
+ * set each force never block the thread polling the wheel                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef MOTOR_THREAD_H
+#define MOTOR_THREAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "snapshot.h"
+#include "wake_signal.h"
+
+class MotorThread
+{
+  private:
+    std::function<void(double)> apply;
+    // the latest force, a newer one replaces any not yet applied
+    Snapshot<double> target;
+    WakeSignal wake;
+    std::atomic<bool> stopping;
+    // set when applying a force failed and the error is not yet reported
+    std::atomic<bool> failed;
+    std::mutex errorMutex;
+    std::string errorMessage;
+    int32_t errorCode;
+    std::thread thread;
+
+    // applies each new force until stopped
+    void run();
+
+  public:
+    // starts a thread which passes each force set to apply, which may throw
+    // DeviceError
+    explicit MotorThread(std::function<void(double)> apply);
+    // stops the thread, waiting for any force being applied
+    ~MotorThread();
+    MotorThread &operator=(const MotorThread &) = delete;
+    MotorThread(const MotorThread &) = delete;
+
+    // publishes a force for the thread to apply without waiting, throws
+    // DeviceError if applying an earlier force failed
+    void setForce(double force);
+};
+
+#endif
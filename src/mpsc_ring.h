@@ -0,0 +1,137 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * mpsc_ring.h                                                                *
+ *                                                                            *
+ * A fixed capacity multiple producer, single consumer ring buffer            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef MPSC_RING_H
+#define MPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+template <typename T> class MpscRing
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "MpscRing values must be trivially copyable");
+
+  private:
+    // sequence is the ticket a slot is ready for: its index when free, and
+    // its index plus one once filled
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) size_t tail;
+
+    // returns the smallest power of two not less than value
+    static size_t roundUp(size_t value)
+    {
+        size_t size = 1;
+        while (size < value)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+  public:
+    // allocates every slot up front, capacity is rounded up to a power of two
+    explicit MpscRing(size_t capacity)
+        : slots{new Slot[roundUp(capacity)]}, mask{roundUp(capacity) - 1},
+          head{0}, tail{0}
+    {
+        for (size_t i = 0; i <= mask; i++)
+        {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpscRing &operator=(const MpscRing &) = delete;
+    MpscRing(const MpscRing &) = delete;
+
+    // adds a value, returns false without blocking if the ring is full,
+    // safe to call from any number of threads
+    template <typename Fill> bool push(Fill fill)
+    {
+        size_t position = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[position & mask];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t difference = static_cast<intptr_t>(sequence) -
+                                  static_cast<intptr_t>(position);
+            if (difference == 0)
+            {
+                // claim the slot, or retry from wherever head has moved to
+                if (head.compare_exchange_weak(position, position + 1,
+                                               std::memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (difference < 0)
+            {
+                // the consumer has not yet emptied this slot
+                return false;
+            }
+            else
+            {
+                position = head.load(std::memory_order_relaxed);
+            }
+        }
+        // write in place, so large values are not copied twice
+        fill(slot->value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    // removes the oldest value into out, returns false if there is none,
+    // must only be called from the consumer thread
+    bool pop(T &out)
+    {
+        Slot &slot = slots[tail & mask];
+        if (slot.sequence.load(std::memory_order_acquire) != tail + 1)
+        {
+            return false;
+        }
+        out = slot.value;
+        slot.sequence.store(tail + mask + 1, std::memory_order_release);
+        tail++;
+        return true;
+    }
+
+    // returns the number of values the ring can hold
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
+
+#endif
@@ -24,40 +24,43 @@
 
 #include "output_manager.h"
 
-const int OutputManager::OUTPUT_WIDTH = 80;
+#include <cstdio>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+const size_t OutputManager::QUEUE_CAPACITY = 1024;
+const std::chrono::milliseconds OutputManager::DRAIN_INTERVAL{10};
 
 OutputManager::OutputManager()
-    : outputPos{0, 0}, maxPos{0, 0}, hConsole{GetStdHandle(STD_OUTPUT_HANDLE)}
+    : queue{QUEUE_CAPACITY}, muted{false}, droppedCount{0}, reportedDrops{0},
+      woken{false}, pendingFrame{}, request{TelemetryRequest::None}, shownFrame{},
+      telemetryShown{false}, renderer{}, terminal{stdoutIsTerminal()},
+      output{}, active{true}
 {
-    try
-    {
-        outputPos = OutputManager::getCursorPos(hConsole);
-    }
-    catch (...)
+#ifdef _WIN32
+    // telemetry is drawn with ANSI escape sequences
+    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    DWORD mode;
+    if (GetConsoleMode(hConsole, &mode))
     {
-        // leave outputPos as is
+        SetConsoleMode(hConsole, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING);
     }
+#endif
+    output.reserve(QUEUE_CAPACITY * LogRecord::TEXT_SIZE);
+    writer = std::thread(&OutputManager::run, this);
 }
 
 OutputManager::~OutputManager()
 {
-    // return cursor to next line
-    std::lock_guard<std::mutex> lock(outputMutex);
-    outputPos.X = 0;
-    SetConsoleCursorPosition(hConsole, outputPos);
-};
-
-// returns the current cursor position
-COORD OutputManager::getCursorPos(HANDLE hConsole)
-{
-    CONSOLE_SCREEN_BUFFER_INFO csbi;
-    if (GetConsoleScreenBufferInfo(hConsole, &csbi))
+    // write anything still queued before exiting
+    active.store(false);
+    notifyWriter();
+    if (writer.joinable())
     {
-        return csbi.dwCursorPosition;
-    }
-    else
-    {
-        throw;
+        writer.join();
     }
 }
 
@@ -68,65 +71,180 @@ OutputManager &OutputManager::getInstance()
     return instance;
 }
 
-// prints a message to the screen
-void OutputManager::print(std::ostream &stream, std::string message)
+// writes text to stdout in a single call
+void OutputManager::write(const std::string &text)
+{
+    if (text.empty())
+    {
+        return;
+    }
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    std::fflush(stdout);
+}
+
+// returns if stdout is a console rather than a file or pipe
+bool OutputManager::stdoutIsTerminal()
+{
+#ifdef _WIN32
+    return _isatty(_fileno(stdout)) != 0;
+#else
+    return isatty(fileno(stdout)) != 0;
+#endif
+}
+
+// queues a message, counting it as dropped if the queue is full
+void OutputManager::print(const std::string &message, bool error)
+{
+    if (!queue.push([&](LogRecord &record) { record.set(message, error); }))
+    {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    notifyWriter();
+}
+
+// wakes the writer thread to write what was queued
+void OutputManager::notifyWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        woken = true;
+    }
+    wake.notify_one();
+}
+
+// writes queued messages and telemetry until stopped
+void OutputManager::run()
 {
-    std::lock_guard<std::mutex> lock(outputMutex);
-    SetConsoleCursorPosition(hConsole, outputPos);
-    stream << std::left << std::setw(OUTPUT_WIDTH) << message << std::endl;
-    outputPos.Y += 1;
-    // clear output below
-    COORD currentPos = outputPos;
-    while (currentPos.Y < maxPos.Y)
+    while (active.load())
     {
-        std::cout << std::setw(OUTPUT_WIDTH) << "" << std::endl;
-        currentPos.Y++;
+        if (!drain())
+        {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            wake.wait_for(lock, DRAIN_INTERVAL, [this] { return woken; });
+            woken = false;
+        }
     }
+    drain();
+}
+
+// writes everything queued, returns if anything was written
+bool OutputManager::drain()
+{
+    output.clear();
+    LogRecord record;
+    bool logged = false;
+    while (queue.pop(record))
+    {
+        if (!logged)
+        {
+            // print over telemetry, which is drawn again below the messages
+            output += renderer.erase();
+            logged = true;
+        }
+        if (record.error)
+        {
+            // errors go to stderr, after everything before them
+            write(output);
+            output.clear();
+            std::fwrite(record.text, 1, record.length, stderr);
+            std::fputc('\n', stderr);
+            std::fflush(stderr);
+        }
+        else
+        {
+            output.append(record.text, record.length);
+            output += '\n';
+        }
+    }
+    uint64_t drops = droppedCount.load(std::memory_order_relaxed);
+    if (drops != reportedDrops)
+    {
+        if (!logged)
+        {
+            output += renderer.erase();
+            logged = true;
+        }
+        output += std::to_string(drops - reportedDrops) +
+                  " messages dropped, output is overloaded\n";
+        reportedDrops = drops;
+    }
+
+    TelemetryRequest latest;
+    {
+        std::lock_guard<std::mutex> lock(frameMutex);
+        latest = request;
+        if (latest == TelemetryRequest::Frame)
+        {
+            shownFrame.copy(pendingFrame);
+        }
+        request = TelemetryRequest::None;
+    }
+    if (latest == TelemetryRequest::Clear)
+    {
+        output += renderer.erase();
+        telemetryShown = false;
+    }
+    else if (latest == TelemetryRequest::Frame)
+    {
+        telemetryShown = true;
+    }
+    if (telemetryShown && (logged || latest == TelemetryRequest::Frame))
+    {
+        output += renderer.render(shownFrame);
+    }
+    write(output);
+    return logged || latest != TelemetryRequest::None;
 }
 
 // prints a message to the screen
-void OutputManager::log(std::string message)
+void OutputManager::log(const std::string &message)
 {
-    print(std::cout, message);
+    if (!muted.load())
+    {
+        print(message, false);
+    }
 }
 
 // logs an error
-void OutputManager::error(std::string message)
+void OutputManager::error(const std::string &message)
 {
-    print(std::cerr, message);
+    print(message, true);
 }
 
-// prints telemetry data to the screen
-void OutputManager::printTelemetry(std::vector<std::string> lines)
+// suppresses log messages, errors are still printed
+void OutputManager::mute(bool muted)
 {
-    std::lock_guard<std::mutex> lock(outputMutex);
-    // print each line
-    SetConsoleCursorPosition(hConsole, outputPos);
-    for (std::string line : lines)
+    this->muted.store(muted);
+}
+
+// draws a telemetry frame below any messages, rewriting only what changed
+void OutputManager::printTelemetry(const TelemetryFrame &frame)
+{
+    if (!terminal)
     {
-        std::cout << std::left << std::setw(OUTPUT_WIDTH) << line << std::endl;
+        return;
     }
-    // record bottom of output
-    COORD currentPos = getCursorPos(hConsole);
-    if (currentPos.Y > maxPos.Y)
     {
-        maxPos = currentPos;
+        std::lock_guard<std::mutex> lock(frameMutex);
+        pendingFrame.copy(frame);
+        request = TelemetryRequest::Frame;
     }
-    std::cout << std::flush;
+    notifyWriter();
 }
 
 // clears telemetry output from screen
 void OutputManager::clearTelemetry()
 {
-    std::lock_guard<std::mutex> lock(outputMutex);
-    // clear telemetry output
-    SetConsoleCursorPosition(hConsole, outputPos);
-    COORD currentPos = outputPos;
-    while (currentPos.Y < maxPos.Y)
     {
-        std::cout << std::setw(OUTPUT_WIDTH) << "" << std::endl;
-        currentPos.Y++;
+        std::lock_guard<std::mutex> lock(frameMutex);
+        request = TelemetryRequest::Clear;
     }
-    // return cursor to correct position
-    SetConsoleCursorPosition(hConsole, outputPos);
+    notifyWriter();
+}
+
+// returns the number of messages dropped because the queue was full
+uint64_t OutputManager::dropped() const
+{
+    return droppedCount.load(std::memory_order_relaxed);
 }
@@ -25,27 +25,80 @@
 #ifndef OUTPUT_MANAGER_H
 #define OUTPUT_MANAGER_H
 
-#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
 #include <mutex>
-#include <vector>
+#include <string>
+#include <thread>
+
+#include "log_record.h"
+#include "mpsc_ring.h"
+#include "telemetry_frame.h"
+#include "telemetry_renderer.h"
+
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
+// messages are queued and written by a single thread which owns the console,
+// so logging never waits for console output
 class OutputManager
 {
   private:
-    static const int OUTPUT_WIDTH;
+    // what the telemetry thread last asked to be shown
+    enum class TelemetryRequest
+    {
+        None,
+        Frame,
+        Clear
+    };
+
+    static const size_t QUEUE_CAPACITY;
+    static const std::chrono::milliseconds DRAIN_INTERVAL;
     static OutputManager instance;
-    std::mutex outputMutex;
-    COORD outputPos;
-    COORD maxPos;
-    HANDLE hConsole;
-    // returns the current cursor position
-    static COORD getCursorPos(HANDLE hConsole);
+
+    MpscRing<LogRecord> queue;
+    std::atomic<bool> muted;
+    std::atomic<uint64_t> droppedCount;
+    uint64_t reportedDrops;
+    // wakes the writer early, woken is set under the lock so a message
+    // queued while the writer is about to wait is never left for the next
+    // drain interval
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool woken;
+    // guards the frame handed over by the telemetry thread
+    std::mutex frameMutex;
+    TelemetryFrame pendingFrame;
+    TelemetryRequest request;
+    // owned by the writer thread
+    TelemetryFrame shownFrame;
+    bool telemetryShown;
+    TelemetryRenderer renderer;
+    // telemetry is only drawn to a console, as the escape sequences which
+    // draw it would fill a redirected file
+    bool terminal;
+    std::string output;
+    std::atomic<bool> active;
+    std::thread writer;
+
     OutputManager();
     ~OutputManager();
-    // prints a message to the screen
-    void print(std::ostream &stream, std::string message);
+    // queues a message, counting it as dropped if the queue is full
+    void print(const std::string &message, bool error);
+    // wakes the writer thread to write what was queued
+    void notifyWriter();
+    // writes queued messages and telemetry until stopped
+    void run();
+    // writes everything queued, returns if anything was written
+    bool drain();
+    // writes text to stdout in a single call
+    static void write(const std::string &text);
+    // returns if stdout is a console rather than a file or pipe
+    static bool stdoutIsTerminal();
 
   public:
     // returns the singleton instance
@@ -53,13 +106,17 @@ class OutputManager
     OutputManager &operator=(const OutputManager &) = delete;
     OutputManager(const OutputManager &) = delete;
     // prints a message to the screen
-    void log(std::string message);
+    void log(const std::string &message);
     // logs an error
-    void error(std::string message);
-    // prints telemetry data to the screen
-    void printTelemetry(std::vector<std::string> lines);
+    void error(const std::string &message);
+    // suppresses log messages, errors are still printed
+    void mute(bool muted);
+    // draws a telemetry frame below any messages, rewriting only what changed
+    void printTelemetry(const TelemetryFrame &frame);
     // clears telemetry output from screen
     void clearTelemetry();
+    // returns the number of messages dropped because the queue was full
+    uint64_t dropped() const;
 };
 
 #endif
@@ -0,0 +1,181 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pacer.cpp                                                                  *
+ *                                                                            *
+ * Paces a polling loop against absolute deadlines                            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "pacer.h"
+
+const std::chrono::microseconds Pacer::SPIN_SLICE{50};
+
+Pacer::Pacer(Clock &clock, int rateHz, WaitMode mode,
+             std::chrono::microseconds spinWindow)
+    : clock(clock), rateHz{rateHz},
+      period{std::chrono::duration_cast<Clock::time_point::duration>(
+          std::chrono::nanoseconds(1000000000 / rateHz))},
+      mode(mode), spinWindow(spinWindow), deadline{}, started{false},
+      tickCount{0}, missedCount{0}, jitter{}, interrupt{nullptr}
+{
+}
+
+// sleeps until time, or until interrupted
+void Pacer::sleepUntil(Clock::time_point time)
+{
+    if (interrupt)
+    {
+        clock.waitUntil(time, *interrupt);
+    }
+    else
+    {
+        clock.sleepUntil(time);
+    }
+}
+
+// busy waits until time, or until interrupted
+void Pacer::spinUntil(Clock::time_point time)
+{
+    if (!interrupt)
+    {
+        clock.spinUntil(time);
+        return;
+    }
+    // spin in slices so a spinning thread can be stopped promptly
+    while (!interrupt->raised())
+    {
+        Clock::time_point slice = clock.now() + SPIN_SLICE;
+        if (slice >= time)
+        {
+            clock.spinUntil(time);
+            return;
+        }
+        clock.spinUntil(slice);
+    }
+}
+
+// returns if a polling rate is supported
+bool Pacer::validRate(int rateHz)
+{
+    return rateHz == 125 || rateHz == 250 || rateHz == 500 || rateHz == 1000;
+}
+
+// waits until the next deadline, returns the time waiting finished
+Clock::time_point Pacer::wait()
+{
+    Clock::time_point now = clock.now();
+    if (!started)
+    {
+        started = true;
+        deadline = now + period;
+        return now;
+    }
+
+    if (now < deadline)
+    {
+        switch (mode)
+        {
+        case WaitMode::Sleep:
+            sleepUntil(deadline);
+            break;
+        case WaitMode::Spin:
+            spinUntil(deadline);
+            break;
+        case WaitMode::Hybrid:
+            if (deadline - now > spinWindow)
+            {
+                sleepUntil(deadline - spinWindow);
+            }
+            spinUntil(deadline);
+            break;
+        }
+        now = clock.now();
+    }
+
+    // record how late the deadline was met
+    auto lateness = now > deadline ? now - deadline
+                                   : Clock::time_point::duration::zero();
+    jitter.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(lateness)
+            .count()));
+    tickCount.fetch_add(1, std::memory_order_relaxed);
+
+    // advance from the previous deadline rather than now so waiting time and
+    // work time do not accumulate as drift
+    deadline += period;
+    if (now >= deadline)
+    {
+        // skip deadlines which have already passed rather than bursting
+        auto behind = (now - deadline) / period + 1;
+        missedCount.fetch_add(static_cast<uint64_t>(behind),
+                              std::memory_order_relaxed);
+        deadline += behind * period;
+    }
+    return now;
+}
+
+// restarts pacing from the next call to wait
+void Pacer::reset()
+{
+    started = false;
+}
+
+// changes the rate and wait mode from the next deadline on, which is moved
+// to one new period after the previous deadline, must be called from the
+// waiting thread
+void Pacer::setRate(int rateHz, WaitMode mode)
+{
+    auto newPeriod = std::chrono::duration_cast<Clock::time_point::duration>(
+        std::chrono::nanoseconds(1000000000 / rateHz));
+    deadline += newPeriod - period;
+    period = newPeriod;
+    this->mode = mode;
+    this->rateHz.store(rateHz, std::memory_order_relaxed);
+}
+
+// ends sleeps early once signal is raised, so a waiting thread can be stopped
+// without waiting out the period, or never if null
+void Pacer::setInterrupt(const WakeSignal *signal)
+{
+    interrupt = signal;
+}
+
+// returns the polling rate in Hz
+int Pacer::rate() const
+{
+    return rateHz.load(std::memory_order_relaxed);
+}
+
+// returns the number of deadlines met or overrun
+uint64_t Pacer::ticks() const
+{
+    return tickCount.load(std::memory_order_relaxed);
+}
+
+// returns the number of deadlines skipped after overrunning
+uint64_t Pacer::missed() const
+{
+    return missedCount.load(std::memory_order_relaxed);
+}
+
+// returns the lateness of each tick in nanoseconds
+const Histogram &Pacer::getJitter() const
+{
+    return jitter;
+}
@@ -0,0 +1,97 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pacer.h                                                                    *
+ *                                                                            *
+ * Paces a polling loop against absolute deadlines                            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef PACER_H
+#define PACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "clock.h"
+#include "histogram.h"
+#include "wake_signal.h"
+
+// how the pacer waits for each deadline
+enum class WaitMode
+{
+    // sleep until the deadline
+    Sleep,
+    // busy wait until the deadline
+    Spin,
+    // sleep until shortly before the deadline, then busy wait
+    Hybrid
+};
+
+class Pacer
+{
+  private:
+    // longest busy wait between checks of the interrupt
+    static const std::chrono::microseconds SPIN_SLICE;
+
+    Clock &clock;
+    std::atomic<int> rateHz;
+    Clock::time_point::duration period;
+    WaitMode mode;
+    std::chrono::microseconds spinWindow;
+    Clock::time_point deadline;
+    bool started;
+    std::atomic<uint64_t> tickCount;
+    std::atomic<uint64_t> missedCount;
+    Histogram jitter;
+    // ends sleeps early once raised, or null to always sleep until deadlines
+    const WakeSignal *interrupt;
+
+    // sleeps until time, or until interrupted
+    void sleepUntil(Clock::time_point time);
+    // busy waits until time, or until interrupted
+    void spinUntil(Clock::time_point time);
+
+  public:
+    Pacer(Clock &clock, int rateHz, WaitMode mode,
+          std::chrono::microseconds spinWindow);
+    // returns if a polling rate is supported
+    static bool validRate(int rateHz);
+    // waits until the next deadline, returns the time waiting finished
+    Clock::time_point wait();
+    // restarts pacing from the next call to wait
+    void reset();
+    // changes the rate and wait mode from the next deadline on, which is
+    // moved to one new period after the previous deadline, must be called
+    // from the waiting thread
+    void setRate(int rateHz, WaitMode mode);
+    // ends sleeps early once signal is raised, so a waiting thread can be
+    // stopped without waiting out the period, or never if null
+    void setInterrupt(const WakeSignal *signal);
+    // returns the polling rate in Hz
+    int rate() const;
+    // returns the number of deadlines met or overrun
+    uint64_t ticks() const;
+    // returns the number of deadlines skipped after overrunning
+    uint64_t missed() const;
+    // returns the lateness of each tick in nanoseconds
+    const Histogram &getJitter() const;
+};
+
+#endif
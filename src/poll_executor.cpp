@@ -0,0 +1,227 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * poll_executor.cpp                                                          *
+ *                                                                            *
+ * Fixed pool of paced threads which poll a set of targets on each tick       *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "poll_executor.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+PollExecutor::Worker::Worker(Clock &clock, const WheelSettings &settings)
+    : thread{}, targetsMutex{}, targets{},
+      pacer(clock, settings.pollRateHz, settings.waitMode, settings.spinWindow),
+      idling{false}, cpuNs{0}
+{
+}
+
+PollExecutor::PollExecutor(Clock &clock, const WheelSettings &settings,
+                           int numThreads)
+    : workers{}, active{false}, stopping{}, pollRateHz{settings.pollRateHz},
+      waitMode{settings.waitMode},
+      idleRateHz{settings.idleTimeout.count() > 0 &&
+                         settings.idleRateHz > 0 &&
+                         settings.idleRateHz < settings.pollRateHz
+                     ? settings.idleRateHz
+                     : 0},
+      priority{settings.pollPriority}, cores{settings.pollCores}
+{
+    for (int i = 0; i < std::max(numThreads, 1); i++)
+    {
+        workers.push_back(std::make_unique<Worker>(clock, settings));
+        workers.back()->pacer.setInterrupt(&stopping);
+    }
+}
+
+PollExecutor::~PollExecutor()
+{
+    stop();
+}
+
+// polls the targets of one worker on each tick
+void PollExecutor::run(Worker *worker)
+{
+    ThreadTuning tuning;
+    tuning.apply(priority, cores, "poll");
+    uint64_t ticks = 0;
+    while (active.load())
+    {
+        Clock::time_point now = worker->pacer.wait();
+        std::lock_guard<std::mutex> lock(worker->targetsMutex);
+        bool idle = idleRateHz > 0;
+        for (Pollable *target : worker->targets)
+        {
+            target->poll(now);
+            idle = target->idle(now) && idle;
+        }
+        // slow down, sleeping rather than spinning, while every target is
+        // idle, and return to full rate on the tick any target changes
+        if (idle != worker->idling)
+        {
+            worker->idling = idle;
+            worker->pacer.setRate(idle ? idleRateHz : pollRateHz,
+                                  idle ? WaitMode::Sleep : waitMode);
+        }
+        // reading the thread's cpu time is a system call, so do it rarely
+        if (++ticks % worker->pacer.rate() == 0)
+        {
+            worker->cpuNs.store(threadCpuNs(), std::memory_order_relaxed);
+        }
+    }
+    worker->cpuNs.store(threadCpuNs(), std::memory_order_relaxed);
+}
+
+// starts the worker threads
+void PollExecutor::start()
+{
+    // prevent re-running threads if already started
+    if (active.load())
+    {
+        return;
+    }
+    active.store(true);
+    stopping.reset();
+    for (std::unique_ptr<Worker> &worker : workers)
+    {
+        // join threads left running by requestStop
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+        if (worker->idling)
+        {
+            worker->idling = false;
+            worker->pacer.setRate(pollRateHz, waitMode);
+        }
+        worker->pacer.reset();
+        worker->thread = std::thread(&PollExecutor::run, this, worker.get());
+    }
+}
+
+// stops and joins the worker threads
+void PollExecutor::stop()
+{
+    requestStop();
+    for (std::unique_ptr<Worker> &worker : workers)
+    {
+        if (worker->thread.joinable())
+        {
+            worker->thread.join();
+        }
+    }
+}
+
+// asks the worker threads to stop without joining them, so several executors
+// can stop at once before each is joined by stop
+void PollExecutor::requestStop()
+{
+    active.store(false);
+    stopping.raise();
+}
+
+// adds a target to the least loaded worker, returns the pacer of that worker,
+// which lasts as long as the executor
+const Pacer *PollExecutor::add(Pollable *target)
+{
+    Worker *chosen = workers.front().get();
+    size_t fewest = SIZE_MAX;
+    for (std::unique_ptr<Worker> &worker : workers)
+    {
+        std::lock_guard<std::mutex> lock(worker->targetsMutex);
+        if (worker->targets.size() < fewest)
+        {
+            fewest = worker->targets.size();
+            chosen = worker.get();
+        }
+    }
+    std::lock_guard<std::mutex> lock(chosen->targetsMutex);
+    chosen->targets.push_back(target);
+    return &chosen->pacer;
+}
+
+// removes a target, returns once it is no longer being polled
+void PollExecutor::remove(Pollable *target)
+{
+    for (std::unique_ptr<Worker> &worker : workers)
+    {
+        // holding the lock waits out any tick in progress
+        std::lock_guard<std::mutex> lock(worker->targetsMutex);
+        auto found = std::find(worker->targets.begin(), worker->targets.end(),
+                               target);
+        if (found != worker->targets.end())
+        {
+            worker->targets.erase(found);
+            return;
+        }
+    }
+}
+
+// returns the number of worker threads
+size_t PollExecutor::size() const
+{
+    return workers.size();
+}
+
+// returns the cpu time used by a worker thread in seconds, updated about
+// once a second
+double PollExecutor::cpuSeconds(size_t worker) const
+{
+    return workers[worker]->cpuNs.load(std::memory_order_relaxed) / 1e9;
+}
+
+// returns the number of deadlines skipped by every worker
+uint64_t PollExecutor::missed() const
+{
+    uint64_t total = 0;
+    for (const std::unique_ptr<Worker> &worker : workers)
+    {
+        total += worker->pacer.missed();
+    }
+    return total;
+}
+
+// returns the cpu time used by the calling thread in ns
+uint64_t PollExecutor::threadCpuNs()
+{
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user);
+    // FILETIME counts 100 ns intervals
+    auto toNs = [](const FILETIME &time)
+    {
+        return ((static_cast<uint64_t>(time.dwHighDateTime) << 32) |
+                time.dwLowDateTime) *
+               100;
+    };
+    return toNs(kernel) + toNs(user);
+#else
+    timespec time;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000 + time.tv_nsec;
+#endif
+}
@@ -0,0 +1,98 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * poll_executor.h                                                            *
+ *                                                                            *
+ * Fixed pool of paced threads which poll a set of targets on each tick       *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef POLL_EXECUTOR_H
+#define POLL_EXECUTOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "pacer.h"
+#include "pollable.h"
+#include "thread_tuning.h"
+#include "wake_signal.h"
+#include "wheel_settings.h"
+
+class PollExecutor
+{
+  private:
+    struct Worker
+    {
+        std::thread thread;
+        std::mutex targetsMutex;
+        std::vector<Pollable *> targets;
+        Pacer pacer;
+        // polling at the idle rate, only used by the worker's thread
+        bool idling;
+        // cpu time of the thread, sampled about once a second
+        std::atomic<uint64_t> cpuNs;
+        Worker(Clock &clock, const WheelSettings &settings);
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<bool> active;
+    // raised to end the workers' waits when stopping
+    WakeSignal stopping;
+    int pollRateHz;
+    WaitMode waitMode;
+    // the idle rate, or 0 if workers always poll at the full rate
+    int idleRateHz;
+    ThreadPriority priority;
+    std::vector<int> cores;
+
+    // polls the targets of one worker on each tick
+    void run(Worker *worker);
+
+  public:
+    PollExecutor(Clock &clock, const WheelSettings &settings, int numThreads);
+    ~PollExecutor();
+    // starts the worker threads
+    void start();
+    // stops and joins the worker threads
+    void stop();
+    // asks the worker threads to stop without joining them, so several
+    // executors can stop at once before each is joined by stop
+    void requestStop();
+    // adds a target to the least loaded worker, returns the pacer of that
+    // worker, which lasts as long as the executor
+    const Pacer *add(Pollable *target);
+    // removes a target, returns once it is no longer being polled
+    void remove(Pollable *target);
+    // returns the number of worker threads
+    size_t size() const;
+    // returns the cpu time used by a worker thread in seconds, updated about
+    // once a second
+    double cpuSeconds(size_t worker) const;
+    // returns the number of deadlines skipped by every worker
+    uint64_t missed() const;
+    // returns the cpu time used by the calling thread in ns
+    static uint64_t threadCpuNs();
+};
+
+#endif
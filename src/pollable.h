@@ -0,0 +1,44 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * pollable.h                                                                 *
+ *                                                                            *
+ * Interface for work serviced on each tick of a poll executor                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef POLLABLE_H
+#define POLLABLE_H
+
+#include "clock.h"
+
+class Pollable
+{
+  public:
+    virtual ~Pollable() = default;
+    // performs one tick of work, must not block
+    virtual void poll(Clock::time_point now) = 0;
+    // returns if the target can be polled at the idle rate, as its input
+    // has not changed for a while
+    virtual bool idle(Clock::time_point now)
+    {
+        return false;
+    }
+};
+
+#endif
@@ -0,0 +1,101 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * profile.cpp                                                                *
+ *                                                                            *
+ * Key/value settings loaded from a wheel profile file                        *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "profile.h"
+
+#include <fstream>
+#include <sstream>
+
+// removes leading and trailing whitespace
+std::string Profile::trim(const std::string &text)
+{
+    const char *whitespace = " \t\r\n";
+    size_t start = text.find_first_not_of(whitespace);
+    if (start == std::string::npos)
+    {
+        return "";
+    }
+    size_t end = text.find_last_not_of(whitespace);
+    return text.substr(start, end - start + 1);
+}
+
+// reads a profile file, returns false and sets error on failure
+bool Profile::load(const std::string &path, Profile &profile,
+                   std::string &error)
+{
+    std::ifstream file(path);
+    if (!file)
+    {
+        error = "Unable to open profile " + path;
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    if (!parse(contents.str(), profile, error))
+    {
+        error = path + ": " + error;
+        return false;
+    }
+    return true;
+}
+
+// parses profile text, returns false and sets error on failure
+bool Profile::parse(const std::string &text, Profile &profile,
+                    std::string &error)
+{
+    std::istringstream lines(text);
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(lines, line))
+    {
+        lineNumber++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        size_t separator = line.find('=');
+        std::string key = trim(line.substr(0, separator));
+        if (separator == std::string::npos || key.empty())
+        {
+            error = "line " + std::to_string(lineNumber) +
+                    ": expected key = value";
+            return false;
+        }
+        profile.set(key, trim(line.substr(separator + 1)));
+    }
+    return true;
+}
+
+// sets a value, replacing any existing value
+void Profile::set(const std::string &key, const std::string &value)
+{
+    values[key] = value;
+}
+
+// returns all values, ordered by key
+const std::map<std::string, std::string> &Profile::entries() const
+{
+    return values;
+}
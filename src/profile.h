@@ -0,0 +1,55 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * profile.h                                                                  *
+ *                                                                            *
+ * Key/value settings loaded from a wheel profile file                        *
+ *                                                                            *
+ * Profiles are text files of "key = value" lines. Blank lines and lines      *
+ * starting with # are ignored.                                               *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <map>
+#include <string>
+
+class Profile
+{
+  private:
+    std::map<std::string, std::string> values;
+
+    // removes leading and trailing whitespace
+    static std::string trim(const std::string &text);
+
+  public:
+    // reads a profile file, returns false and sets error on failure
+    static bool load(const std::string &path, Profile &profile,
+                     std::string &error);
+    // parses profile text, returns false and sets error on failure
+    static bool parse(const std::string &text, Profile &profile,
+                      std::string &error);
+    // sets a value, replacing any existing value
+    void set(const std::string &key, const std::string &value);
+    // returns all values, ordered by key
+    const std::map<std::string, std::string> &entries() const;
+};
+
+#endif
@@ -0,0 +1,383 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * profile_cache.cpp                                                          *
+ *                                                                            *
+ * Device profiles compiled into a binary cache, keyed by wheel model         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "profile_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+const char *const ProfileCache::CACHE_NAME = "profiles.cache";
+const char *const ProfileCache::PROFILE_EXTENSION = ".profile";
+
+// FNV-1a, over the details of every profile
+static const uint64_t HASH_BASIS = 0xcbf29ce484222325ull;
+static const uint64_t HASH_PRIME = 0x100000001b3ull;
+
+// adds bytes to a hash
+static void hashBytes(uint64_t &hash, const void *data, size_t size)
+{
+    const unsigned char *bytes = static_cast<const unsigned char *>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * HASH_PRIME;
+    }
+}
+
+// returns the size of the keys, padded so the profiles after them are
+// aligned
+static size_t keysSize(uint32_t count)
+{
+    return (count * sizeof(uint32_t) + 7) / 8 * 8;
+}
+
+// the prefix of the keys in each section of a profile
+static const struct
+{
+    const char *prefix;
+    uint32_t section;
+} SECTION_PREFIXES[] = {
+    {"button.", PROFILE_BUTTONS},
+    {"axis.steering.", PROFILE_STEERING_CURVE},
+    {"axis.throttle.", PROFILE_THROTTLE_CURVE},
+    {"axis.brake.", PROFILE_BRAKE_CURVE},
+    {"filter.steering.", PROFILE_STEERING_FILTER},
+    {"filter.throttle.", PROFILE_THROTTLE_FILTER},
+    {"filter.brake.", PROFILE_BRAKE_FILTER},
+    {"ffb.", PROFILE_FORCE_FEEDBACK}};
+
+ProfileCache::ProfileCache()
+    : file{}, keys{nullptr}, profiles{nullptr}, count{0}, compiled{false}
+{
+}
+
+// lists the profiles in directory and hashes their names, sizes and times,
+// returns false and sets error on failure
+bool ProfileCache::listSources(const std::string &directory,
+                               std::vector<std::string> &paths,
+                               uint64_t &sources, std::string &error)
+{
+    namespace fs = std::filesystem;
+    std::error_code code;
+    paths.clear();
+    for (fs::directory_iterator it(directory, code), end; !code && it != end;
+         it.increment(code))
+    {
+        if (it->is_regular_file(code) &&
+            it->path().extension() == PROFILE_EXTENSION)
+        {
+            paths.push_back(it->path().string());
+        }
+    }
+    if (code)
+    {
+        error = "Unable to read profiles in " + directory;
+        return false;
+    }
+    // directories list in no particular order
+    std::sort(paths.begin(), paths.end());
+    sources = HASH_BASIS;
+    uint32_t version = PROFILE_CACHE_VERSION;
+    hashBytes(sources, &version, sizeof(version));
+    for (const std::string &path : paths)
+    {
+        uint64_t size = fs::file_size(path, code);
+        int64_t time = 0;
+        if (!code)
+        {
+            time = fs::last_write_time(path, code).time_since_epoch().count();
+        }
+        if (code)
+        {
+            error = "Unable to read profile " + path;
+            return false;
+        }
+        hashBytes(sources, path.data(), path.size() + 1);
+        hashBytes(sources, &size, sizeof(size));
+        hashBytes(sources, &time, sizeof(time));
+    }
+    return true;
+}
+
+// maps the cache at path, returns false if it is missing, corrupt or
+// compiled from other sources
+bool ProfileCache::map(const std::string &path, uint64_t sources)
+{
+    keys = nullptr;
+    profiles = nullptr;
+    count = 0;
+    std::string error;
+    if (!file.open(path, error) || file.size() < sizeof(ProfileCacheHeader))
+    {
+        file.close();
+        return false;
+    }
+    const char *data = static_cast<const char *>(file.data());
+    const ProfileCacheHeader *header =
+        reinterpret_cast<const ProfileCacheHeader *>(data);
+    if (header->magic != PROFILE_CACHE_MAGIC ||
+        header->version != PROFILE_CACHE_VERSION ||
+        header->headerSize != sizeof(ProfileCacheHeader) ||
+        header->recordSize != sizeof(CachedProfile) ||
+        header->sources != sources ||
+        file.size() != sizeof(ProfileCacheHeader) + keysSize(header->count) +
+                           header->count * sizeof(CachedProfile))
+    {
+        file.close();
+        return false;
+    }
+    count = header->count;
+    keys = reinterpret_cast<const uint32_t *>(data + sizeof(*header));
+    profiles = reinterpret_cast<const CachedProfile *>(
+        data + sizeof(*header) + keysSize(count));
+    return true;
+}
+
+// maps the cache of the profiles in directory, compiling it first if a
+// profile has changed since, returns false and sets error on failure
+bool ProfileCache::load(const std::string &directory, std::string &error)
+{
+    std::vector<std::string> paths;
+    uint64_t sources;
+    if (!listSources(directory, paths, sources, error))
+    {
+        return false;
+    }
+    std::string path =
+        (std::filesystem::path(directory) / CACHE_NAME).string();
+    compiled = false;
+    if (map(path, sources))
+    {
+        return true;
+    }
+    if (!compile(paths, path, sources, error))
+    {
+        return false;
+    }
+    compiled = true;
+    if (!map(path, sources))
+    {
+        error = "Unable to map profile cache " + path;
+        return false;
+    }
+    return true;
+}
+
+// parses the profiles at paths and writes them to a cache at path, returns
+// false and sets error on failure
+bool ProfileCache::compile(const std::vector<std::string> &paths,
+                           const std::string &path, uint64_t sources,
+                           std::string &error)
+{
+    std::vector<CachedProfile> records(paths.size());
+    std::vector<uint32_t> order(paths.size());
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        Profile source;
+        if (!Profile::load(paths[i], source, error))
+        {
+            return false;
+        }
+        if (!record(source, records[i], error))
+        {
+            error = paths[i] + ": " + error;
+            return false;
+        }
+        order[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(order.begin(), order.end(),
+              [&](uint32_t a, uint32_t b)
+              { return records[a].device.key() < records[b].device.key(); });
+    for (size_t i = 1; i < order.size(); i++)
+    {
+        if (records[order[i]].device.key() ==
+            records[order[i - 1]].device.key())
+        {
+            error = paths[order[i - 1]] + " and " + paths[order[i]] +
+                    " are for the same device";
+            return false;
+        }
+    }
+
+    ProfileCacheHeader header{};
+    header.magic = PROFILE_CACHE_MAGIC;
+    header.version = PROFILE_CACHE_VERSION;
+    header.headerSize = sizeof(ProfileCacheHeader);
+    header.recordSize = sizeof(CachedProfile);
+    header.count = static_cast<uint32_t>(records.size());
+    header.sources = sources;
+    std::vector<uint32_t> keys(keysSize(header.count) / sizeof(uint32_t));
+    for (size_t i = 0; i < order.size(); i++)
+    {
+        keys[i] = records[order[i]].device.key();
+    }
+
+    // replace the cache whole, so a failed write leaves no partial cache
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char *>(keys.data()),
+                  keys.size() * sizeof(uint32_t));
+        for (uint32_t index : order)
+        {
+            out.write(reinterpret_cast<const char *>(&records[index]),
+                      sizeof(CachedProfile));
+        }
+        if (!out.flush())
+        {
+            error = "Unable to write profile cache " + temporary;
+            return false;
+        }
+    }
+    std::error_code code;
+    std::filesystem::rename(temporary, path, code);
+    if (code)
+    {
+        std::filesystem::remove(temporary, code);
+        error = "Unable to replace profile cache " + path;
+        return false;
+    }
+    return true;
+}
+
+// sets profile to the settings of a parsed profile, returns false and sets
+// error if a setting is invalid or it names no device
+bool ProfileCache::record(const Profile &source, CachedProfile &profile,
+                          std::string &error)
+{
+    // device = <vendor>:<product>, in hexadecimal
+    auto device = source.entries().find("device");
+    profile = CachedProfile{};
+    if (device == source.entries().end() ||
+        !DeviceId::parse(device->second, profile.device))
+    {
+        error = "Expected device = <vendor>:<product>";
+        return false;
+    }
+
+    // device profiles start from the defaults
+    WheelSettings settings;
+    if (!settings.buttonMap.configure(source, error) ||
+        !settings.steeringCurve.configure(source, "steering", error) ||
+        !settings.throttleCurve.configure(source, "throttle", error) ||
+        !settings.brakeCurve.configure(source, "brake", error) ||
+        !settings.steeringFilter.configure(source, "steering", error) ||
+        !settings.throttleFilter.configure(source, "throttle", error) ||
+        !settings.brakeFilter.configure(source, "brake", error) ||
+        !settings.forceFeedback.configure(source, error))
+    {
+        return false;
+    }
+    if (!settings.steeringCurve.getShape(profile.steeringCurve) ||
+        !settings.throttleCurve.getShape(profile.throttleCurve) ||
+        !settings.brakeCurve.getShape(profile.brakeCurve))
+    {
+        error = "Curves may have at most " +
+                std::to_string(AxisCurve::MAX_SHAPE_POINTS) + " points";
+        return false;
+    }
+    for (const auto &entry : source.entries())
+    {
+        for (const auto &section : SECTION_PREFIXES)
+        {
+            size_t length = std::strlen(section.prefix);
+            if (entry.first.compare(0, length, section.prefix) == 0)
+            {
+                profile.sections |= section.section;
+            }
+        }
+    }
+    settings.buttonMap.getTargets(profile.buttonTargets);
+    profile.steeringFilter = settings.steeringFilter;
+    profile.throttleFilter = settings.throttleFilter;
+    profile.brakeFilter = settings.brakeFilter;
+    profile.forceFeedback = settings.forceFeedback;
+    return true;
+}
+
+// returns the profile of a wheel model, or null if none is cached
+const CachedProfile *ProfileCache::find(DeviceId device) const
+{
+    uint32_t key = device.key();
+    const uint32_t *found = std::lower_bound(keys, keys + count, key);
+    if (key == 0 || found == keys + count || *found != key)
+    {
+        return nullptr;
+    }
+    return &profiles[found - keys];
+}
+
+// replaces the sections of the wheel specific settings which a profile sets
+// with those of the profile
+void ProfileCache::apply(const CachedProfile &profile,
+                         WheelSettings &settings)
+{
+    if (profile.sections & PROFILE_BUTTONS)
+    {
+        settings.buttonMap.setTargets(profile.buttonTargets);
+    }
+    if (profile.sections & PROFILE_STEERING_CURVE)
+    {
+        settings.steeringCurve.setShape(profile.steeringCurve);
+    }
+    if (profile.sections & PROFILE_THROTTLE_CURVE)
+    {
+        settings.throttleCurve.setShape(profile.throttleCurve);
+    }
+    if (profile.sections & PROFILE_BRAKE_CURVE)
+    {
+        settings.brakeCurve.setShape(profile.brakeCurve);
+    }
+    if (profile.sections & PROFILE_STEERING_FILTER)
+    {
+        settings.steeringFilter = profile.steeringFilter;
+    }
+    if (profile.sections & PROFILE_THROTTLE_FILTER)
+    {
+        settings.throttleFilter = profile.throttleFilter;
+    }
+    if (profile.sections & PROFILE_BRAKE_FILTER)
+    {
+        settings.brakeFilter = profile.brakeFilter;
+    }
+    if (profile.sections & PROFILE_FORCE_FEEDBACK)
+    {
+        settings.forceFeedback = profile.forceFeedback;
+    }
+}
+
+// returns the number of profiles cached
+uint32_t ProfileCache::size() const
+{
+    return count;
+}
+
+// returns if the cache was compiled by the last load
+bool ProfileCache::rebuilt() const
+{
+    return compiled;
+}
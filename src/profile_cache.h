@@ -0,0 +1,145 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * profile_cache.h                                                            *
+ *                                                                            *
+ * Device profiles compiled into a binary cache, keyed by wheel model         *
+ *                                                                            *
+ * Each profile in a directory is parsed once into a fixed size record, and   *
+ * the records are written to a cache file sorted by model. The file is       *
+ * memory mapped at startup, so a wheel's profile is found by binary search   *
+ * and applied from its record without parsing any text when it connects.     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef PROFILE_CACHE_H
+#define PROFILE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "axis_curve.h"
+#include "axis_filter.h"
+#include "button_map.h"
+#include "device_backend.h"
+#include "force_feedback.h"
+#include "mapped_file.h"
+#include "wheel_settings.h"
+
+// identifies a file as a profile cache, "XWPC" in little endian
+static constexpr uint32_t PROFILE_CACHE_MAGIC = 0x43505758;
+// incremented whenever the layout below changes
+static constexpr uint32_t PROFILE_CACHE_VERSION = 2;
+
+// sections of a cached profile, each set if the profile has a key in it
+static constexpr uint32_t PROFILE_BUTTONS = 1u << 0;
+static constexpr uint32_t PROFILE_STEERING_CURVE = 1u << 1;
+static constexpr uint32_t PROFILE_THROTTLE_CURVE = 1u << 2;
+static constexpr uint32_t PROFILE_BRAKE_CURVE = 1u << 3;
+static constexpr uint32_t PROFILE_STEERING_FILTER = 1u << 4;
+static constexpr uint32_t PROFILE_THROTTLE_FILTER = 1u << 5;
+static constexpr uint32_t PROFILE_BRAKE_FILTER = 1u << 6;
+static constexpr uint32_t PROFILE_FORCE_FEEDBACK = 1u << 7;
+
+// the settings of one wheel model, compiled from its profile
+struct CachedProfile
+{
+    DeviceId device;
+    // the sections the profile sets, others are left as they were
+    uint32_t sections;
+    uint32_t buttonTargets[ButtonMap::WHEEL_BUTTONS];
+    AxisCurve::Shape steeringCurve;
+    AxisCurve::Shape throttleCurve;
+    AxisCurve::Shape brakeCurve;
+    AxisFilter steeringFilter;
+    AxisFilter throttleFilter;
+    AxisFilter brakeFilter;
+    ForceFeedbackSettings forceFeedback;
+};
+
+static_assert(std::is_trivially_copyable<CachedProfile>::value,
+              "Cached profiles are copied byte for byte");
+
+// followed by the key of each profile, ascending and padded to 8 bytes, and
+// then the profiles in the same order
+struct ProfileCacheHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    // sizes checked before trusting the layout
+    uint32_t headerSize;
+    uint32_t recordSize;
+    uint32_t count;
+    uint32_t reserved;
+    // hash of the names, sizes and times of the profiles compiled, so the
+    // cache is rebuilt when any of them changes
+    uint64_t sources;
+};
+
+class ProfileCache
+{
+  private:
+    MappedFile file;
+    const uint32_t *keys;
+    const CachedProfile *profiles;
+    uint32_t count;
+    // the cache was compiled rather than loaded as it was
+    bool compiled;
+
+    // lists the profiles in directory and hashes their names, sizes and
+    // times, returns false and sets error on failure
+    static bool listSources(const std::string &directory,
+                            std::vector<std::string> &paths,
+                            uint64_t &sources, std::string &error);
+    // maps the cache at path, returns false if it is missing, corrupt or
+    // compiled from other sources
+    bool map(const std::string &path, uint64_t sources);
+
+  public:
+    // the name of the cache file written to the profile directory
+    static const char *const CACHE_NAME;
+    // the extension of profile files
+    static const char *const PROFILE_EXTENSION;
+
+    ProfileCache();
+    // maps the cache of the profiles in directory, compiling it first if a
+    // profile has changed since, returns false and sets error on failure
+    bool load(const std::string &directory, std::string &error);
+    // parses the profiles at paths and writes them to a cache at path,
+    // returns false and sets error on failure
+    static bool compile(const std::vector<std::string> &paths,
+                        const std::string &path, uint64_t sources,
+                        std::string &error);
+    // sets profile to the settings of a parsed profile, returns false and
+    // sets error if a setting is invalid or it names no device
+    static bool record(const Profile &source, CachedProfile &profile,
+                       std::string &error);
+    // returns the profile of a wheel model, or null if none is cached
+    const CachedProfile *find(DeviceId device) const;
+    // replaces the sections of the wheel specific settings which a profile
+    // sets with those of the profile
+    static void apply(const CachedProfile &profile, WheelSettings &settings);
+    // returns the number of profiles cached
+    uint32_t size() const;
+    // returns if the cache was compiled by the last load
+    bool rebuilt() const;
+};
+
+#endif
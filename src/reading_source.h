@@ -0,0 +1,38 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * reading_source.h                                                           *
+ *                                                                            *
+ * Interface for devices which provide wheel readings                         *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef READING_SOURCE_H
+#define READING_SOURCE_H
+
+#include "input_types.h"
+
+class ReadingSource
+{
+  public:
+    virtual ~ReadingSource() = default;
+    // reads the current state of the device, returns false if unavailable
+    virtual bool read(WheelState &state) = 0;
+};
+
+#endif
@@ -0,0 +1,336 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * replay_backend.cpp                                                         *
+ *                                                                            *
+ * Simulated wheels which replay scripted or recorded readings                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "replay_backend.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include "session_record.h"
+
+// reads the device's readings in order
+class ReplayDevice::Source : public ReadingSource
+{
+  private:
+    ReplayDevice &device;
+
+  public:
+    Source(ReplayDevice &device) : device(device)
+    {
+    }
+    // returns the next reading, or false once the readings have finished
+    bool read(WheelState &state) override
+    {
+        return device.next(state);
+    }
+};
+
+// captures injected readings instead of sending them to the system
+class ReplayDevice::Injector : public GamepadInjector
+{
+  private:
+    ReplayDevice &device;
+
+  public:
+    Injector(ReplayDevice &device) : device(device)
+    {
+    }
+    // returns the simulated time the injector needs to initialise
+    std::chrono::milliseconds settleTime() const override
+    {
+        return device.settleTime;
+    }
+    bool initialise() override
+    {
+        return true;
+    }
+    // records an injected reading
+    void inject(const GamepadState &state) override
+    {
+        device.capture(state);
+    }
+    void release() override
+    {
+    }
+};
+
+// captures forces instead of driving a motor
+class ReplayDevice::Motor : public WheelMotor
+{
+  private:
+    ReplayDevice &device;
+
+  public:
+    Motor(ReplayDevice &device) : device(device)
+    {
+    }
+    bool initialise() override
+    {
+        return true;
+    }
+    // records a force
+    void setForce(double force) override
+    {
+        device.captureForce(force);
+    }
+    void release() override
+    {
+    }
+};
+
+ReplayDevice::ReplayDevice(std::vector<WheelState> readings, bool loop,
+                           size_t captureLimit,
+                           std::chrono::milliseconds settleTime)
+    : readings(std::move(readings)), loop{loop}, position{0}, lastRead{},
+      lastReadTime{}, captured{}, captureLimit{captureLimit},
+      settleTime{settleTime}, latency{}, forces{}, forceLatency{},
+      readCount{0}, injectedCount{0}, finished{false}
+{
+    // capture without allocating while polled
+    captured.reserve(captureLimit);
+    forces.reserve(captureLimit);
+}
+
+// returns the next reading, or false once a single pass has finished
+bool ReplayDevice::next(WheelState &state)
+{
+    if (position == readings.size())
+    {
+        if (!loop || readings.empty())
+        {
+            finished.store(true);
+            return false;
+        }
+        position = 0;
+    }
+    state = readings[position++];
+    lastRead = state;
+    lastReadTime = SteadyClock::getInstance().now();
+    readCount.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// records the injected mapping of the last reading
+void ReplayDevice::capture(const GamepadState &state)
+{
+    auto elapsed = SteadyClock::getInstance().now() - lastReadTime;
+    latency.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    if (captured.size() < captureLimit)
+    {
+        captured.push_back(WheelSample{lastRead, state});
+    }
+    injectedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+// records a force computed from the last reading
+void ReplayDevice::captureForce(double force)
+{
+    auto elapsed = SteadyClock::getInstance().now() - lastReadTime;
+    forceLatency.record(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    if (forces.size() < captureLimit)
+    {
+        forces.emplace_back(lastRead.wheel, force);
+    }
+}
+
+// returns if both devices refer to the same connected wheel
+bool ReplayDevice::matches(const WheelDevice &other) const
+{
+    return this == &other;
+}
+
+// opens the wheel for reading
+std::unique_ptr<ReadingSource> ReplayDevice::createSource()
+{
+    return std::make_unique<Source>(*this);
+}
+
+// creates an injector which captures the wheel's output
+std::unique_ptr<GamepadInjector> ReplayDevice::createInjector()
+{
+    return std::make_unique<Injector>(*this);
+}
+
+// creates a motor which captures the forces sent to the wheel
+std::unique_ptr<WheelMotor> ReplayDevice::createMotor()
+{
+    return std::make_unique<Motor>(*this);
+}
+
+// returns the readings injected and the readings they were mapped from,
+// must not be called while the wheel is being polled
+const std::vector<WheelSample> &ReplayDevice::getCaptured() const
+{
+    return captured;
+}
+
+// returns the time from reading to injection, in ns
+const Histogram &ReplayDevice::getLatency() const
+{
+    return latency;
+}
+
+// returns the steering positions forces were computed from and the forces,
+// must not be called while the wheel is being polled
+const std::vector<std::pair<double, double>> &ReplayDevice::getForces() const
+{
+    return forces;
+}
+
+// returns the time from reading to sending a force, in ns
+const Histogram &ReplayDevice::getForceLatency() const
+{
+    return forceLatency;
+}
+
+// returns the number of readings read
+uint64_t ReplayDevice::reads() const
+{
+    return readCount.load(std::memory_order_relaxed);
+}
+
+// returns the number of readings injected
+uint64_t ReplayDevice::injected() const
+{
+    return injectedCount.load(std::memory_order_relaxed);
+}
+
+// returns if every reading has been read and the wheel will not loop
+bool ReplayDevice::done() const
+{
+    return finished.load();
+}
+
+ReplayBackend::ReplayBackend()
+    : devices{}, listener{nullptr}, settleTime{std::chrono::milliseconds(0)}
+{
+}
+
+// connects a wheel replaying readings, see ReplayDevice
+std::shared_ptr<ReplayDevice>
+ReplayBackend::connect(std::vector<WheelState> readings, bool loop,
+                       size_t captureLimit)
+{
+    auto device = std::make_shared<ReplayDevice>(
+        std::move(readings), loop, captureLimit, settleTime.load());
+    {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        devices.push_back(device);
+    }
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    if (listener)
+    {
+        listener->deviceAdded(device);
+    }
+    return device;
+}
+
+// simulates injectors which need time to initialise, like the system's, for
+// wheels connected afterwards
+void ReplayBackend::setSettleTime(std::chrono::milliseconds time)
+{
+    settleTime.store(time);
+}
+
+// disconnects a wheel
+void ReplayBackend::disconnect(const std::shared_ptr<ReplayDevice> &device)
+{
+    {
+        std::lock_guard<std::mutex> lock(devicesMutex);
+        devices.erase(std::remove(devices.begin(), devices.end(), device),
+                      devices.end());
+    }
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    if (listener)
+    {
+        listener->deviceRemoved(device);
+    }
+}
+
+// returns the wheels currently connected
+std::vector<std::shared_ptr<WheelDevice>> ReplayBackend::scan()
+{
+    std::lock_guard<std::mutex> lock(devicesMutex);
+    return std::vector<std::shared_ptr<WheelDevice>>(devices.begin(),
+                                                     devices.end());
+}
+
+// reports wheels as they are connected and disconnected
+bool ReplayBackend::subscribe(DeviceListener *listener)
+{
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    this->listener = listener;
+    return true;
+}
+
+// stops reporting wheels
+void ReplayBackend::unsubscribe()
+{
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listener = nullptr;
+}
+
+// reads the readings of one wheel from a session recording, returns false
+// and sets error on failure
+bool ReplayBackend::load(const std::string &path, uint32_t wheel,
+                         std::vector<WheelState> &readings,
+                         std::string &error)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        error = "Unable to open recording " + path;
+        return false;
+    }
+    SessionHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        !std::equal(std::begin(header.magic), std::end(header.magic),
+                    std::begin(SessionHeader::MAGIC)))
+    {
+        error = path + " is not a recording";
+        return false;
+    }
+    if (header.version != SessionHeader::VERSION ||
+        header.recordSize != sizeof(SessionRecord))
+    {
+        error = path + " was recorded by an incompatible version";
+        return false;
+    }
+    SessionRecord record;
+    while (file.read(reinterpret_cast<char *>(&record), sizeof(record)))
+    {
+        if (record.wheel == wheel)
+        {
+            readings.push_back(record.input);
+        }
+    }
+    if (readings.empty())
+    {
+        error = path + " has no readings from wheel " + std::to_string(wheel);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,137 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * replay_backend.h                                                           *
+ *                                                                            *
+ * Simulated wheels which replay scripted or recorded readings                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef REPLAY_BACKEND_H
+#define REPLAY_BACKEND_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "clock.h"
+#include "device_backend.h"
+#include "histogram.h"
+#include "input_types.h"
+
+class ReplayDevice : public WheelDevice
+{
+  private:
+    class Source;
+    class Injector;
+    class Motor;
+
+    std::vector<WheelState> readings;
+    bool loop;
+    size_t position;
+    // the reading being mapped, set by the source for the injector
+    WheelState lastRead;
+    Clock::time_point lastReadTime;
+    std::vector<WheelSample> captured;
+    size_t captureLimit;
+    std::chrono::milliseconds settleTime;
+    Histogram latency;
+    // the steering position each force was computed from, and the force
+    std::vector<std::pair<double, double>> forces;
+    Histogram forceLatency;
+    std::atomic<uint64_t> readCount;
+    std::atomic<uint64_t> injectedCount;
+    std::atomic<bool> finished;
+
+    // returns the next reading, or false once a single pass has finished
+    bool next(WheelState &state);
+    // records the injected mapping of the last reading
+    void capture(const GamepadState &state);
+    // records a force computed from the last reading
+    void captureForce(double force);
+
+  public:
+    // creates a wheel which reads readings in order, repeating them if loop
+    // is set, keeps up to captureLimit injected readings, and whose injector
+    // needs settleTime to initialise
+    ReplayDevice(std::vector<WheelState> readings, bool loop,
+                 size_t captureLimit, std::chrono::milliseconds settleTime);
+    // returns if both devices refer to the same connected wheel
+    bool matches(const WheelDevice &other) const override;
+    // opens the wheel for reading
+    std::unique_ptr<ReadingSource> createSource() override;
+    // creates an injector which captures the wheel's output
+    std::unique_ptr<GamepadInjector> createInjector() override;
+    // creates a motor which captures the forces sent to the wheel
+    std::unique_ptr<WheelMotor> createMotor() override;
+    // returns the readings injected and the readings they were mapped from,
+    // must not be called while the wheel is being polled
+    const std::vector<WheelSample> &getCaptured() const;
+    // returns the time from reading to injection, in ns
+    const Histogram &getLatency() const;
+    // returns the steering positions forces were computed from and the
+    // forces, must not be called while the wheel is being polled
+    const std::vector<std::pair<double, double>> &getForces() const;
+    // returns the time from reading to sending a force, in ns
+    const Histogram &getForceLatency() const;
+    // returns the number of readings read
+    uint64_t reads() const;
+    // returns the number of readings injected
+    uint64_t injected() const;
+    // returns if every reading has been read and the wheel will not loop
+    bool done() const;
+};
+
+class ReplayBackend : public DeviceBackend
+{
+  private:
+    std::mutex devicesMutex;
+    std::vector<std::shared_ptr<ReplayDevice>> devices;
+    // held while reporting so unsubscribe waits for the listener
+    std::mutex listenerMutex;
+    DeviceListener *listener;
+    std::atomic<std::chrono::milliseconds> settleTime;
+
+  public:
+    ReplayBackend();
+    // connects a wheel replaying readings, see ReplayDevice
+    std::shared_ptr<ReplayDevice> connect(std::vector<WheelState> readings,
+                                          bool loop, size_t captureLimit);
+    // simulates injectors which need time to initialise, like the system's,
+    // for wheels connected afterwards
+    void setSettleTime(std::chrono::milliseconds time);
+    // disconnects a wheel
+    void disconnect(const std::shared_ptr<ReplayDevice> &device);
+    // returns the wheels currently connected
+    std::vector<std::shared_ptr<WheelDevice>> scan() override;
+    // reports wheels as they are connected and disconnected
+    bool subscribe(DeviceListener *listener) override;
+    // stops reporting wheels
+    void unsubscribe() override;
+    // reads the readings of one wheel from a session recording, returns
+    // false and sets error on failure
+    static bool load(const std::string &path, uint32_t wheel,
+                     std::vector<WheelState> &readings, std::string &error);
+};
+
+#endif
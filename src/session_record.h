@@ -0,0 +1,65 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * session_record.h                                                           *
+ *                                                                            *
+ * The file format written by the session recorder                            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SESSION_RECORD_H
+#define SESSION_RECORD_H
+
+#include <cstdint>
+#include <type_traits>
+
+#include "input_types.h"
+
+// written once at the start of a recording
+struct SessionHeader
+{
+    static constexpr char MAGIC[8] = {'X', 'W', 'C', 'S', 'R', 'E', 'C', 0};
+    static constexpr uint32_t VERSION = 1;
+
+    char magic[8];
+    uint32_t version;
+    // size of each record, so readers can reject mismatched layouts
+    uint32_t recordSize;
+    // wall clock time at the start of the recording, in ns since the epoch
+    uint64_t startTime;
+};
+
+// one wheel reading and its mapping, followed by more in a recording
+struct SessionRecord
+{
+    // time of the poll since the start of the recording, in ns
+    uint64_t time;
+    // wheel number, in order of connection
+    uint32_t wheel;
+    // readings polled from the wheel, gaps are dropped records
+    uint32_t sequence;
+    WheelState input;
+    GamepadState output;
+};
+
+static_assert(std::is_trivially_copyable<SessionRecord>::value,
+              "SessionRecord is written to disk as raw bytes");
+static_assert(sizeof(SessionHeader) == 24, "SessionHeader layout changed");
+static_assert(sizeof(SessionRecord) == 144, "SessionRecord layout changed");
+
+#endif
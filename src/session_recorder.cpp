@@ -0,0 +1,248 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * session_recorder.cpp                                                       *
+ *                                                                            *
+ * Records wheel readings to a binary file without blocking polling           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "session_recorder.h"
+
+#include <algorithm>
+
+// about 4 seconds of readings per wheel at 1000 Hz
+const size_t SessionRecorder::CHANNEL_CAPACITY = 4096;
+const size_t SessionRecorder::WRITE_BATCH = 4096;
+const std::chrono::milliseconds SessionRecorder::DRAIN_INTERVAL{100};
+
+RecordChannel::RecordChannel(uint32_t wheel, Clock::time_point origin,
+                             size_t capacity,
+                             std::atomic<uint64_t> &totalDropped)
+    : wheel{wheel}, origin{origin}, ring{capacity}, sequence{0},
+      droppedCount{0}, totalDropped(totalDropped), closed{false}
+{
+}
+
+// queues a sample without blocking, dropping it if the ring is full,
+// must only be called from the thread polling the wheel
+void RecordChannel::record(const WheelSample &sample, Clock::time_point now)
+{
+    SessionRecord record{};
+    record.time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      now - origin)
+                      .count();
+    record.wheel = wheel;
+    record.sequence = sequence.load(std::memory_order_relaxed);
+    record.input = sample.input;
+    record.output = sample.output;
+    sequence.store(record.sequence + 1, std::memory_order_relaxed);
+    if (!ring.push(record))
+    {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        totalDropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// returns the number of samples recorded, including dropped samples
+uint64_t RecordChannel::recorded() const
+{
+    return sequence.load(std::memory_order_relaxed);
+}
+
+// returns the number of samples dropped because the ring was full
+uint64_t RecordChannel::dropped() const
+{
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+SessionRecorder::SessionRecorder()
+    : active{false}, closing{}, batch(WRITE_BATCH), batchSize{0}, nextWheel{0},
+      origin{}, writtenCount{0}, droppedCount{0}, writeFailed{false}
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+// moves queued records to the file until stopped
+void SessionRecorder::run()
+{
+    while (active.load())
+    {
+        drain();
+        flush();
+        closing.waitUntil(std::chrono::steady_clock::now() + DRAIN_INTERVAL);
+    }
+}
+
+// moves every queued record into the batch, returns false if none
+bool SessionRecorder::drain()
+{
+    // copy the channels so wheels can attach while the file is written
+    {
+        std::lock_guard<std::mutex> lock(channelsMutex);
+        draining.assign(channels.begin(), channels.end());
+    }
+    bool drained = false;
+    for (const std::shared_ptr<RecordChannel> &channel : draining)
+    {
+        // a closed channel receives no more records once it is empty
+        bool closed = channel->closed.load(std::memory_order_acquire);
+        size_t count;
+        do
+        {
+            count = channel->ring.pop(&batch[batchSize],
+                                      WRITE_BATCH - batchSize);
+            batchSize += count;
+            drained = drained || count > 0;
+            if (batchSize == WRITE_BATCH)
+            {
+                flush();
+            }
+        } while (count > 0);
+        if (closed)
+        {
+            std::lock_guard<std::mutex> lock(channelsMutex);
+            channels.erase(
+                std::find(channels.begin(), channels.end(), channel));
+        }
+    }
+    draining.clear();
+    return drained;
+}
+
+// writes the batch to the file
+void SessionRecorder::flush()
+{
+    if (batchSize == 0)
+    {
+        return;
+    }
+    file.write(reinterpret_cast<const char *>(batch.data()),
+               batchSize * sizeof(SessionRecord));
+    if (file)
+    {
+        writtenCount.fetch_add(batchSize, std::memory_order_relaxed);
+    }
+    else
+    {
+        writeFailed.store(true);
+    }
+    batchSize = 0;
+}
+
+// creates a recording and starts the writer, returns false and sets error
+// on failure
+bool SessionRecorder::open(const std::string &path, std::string &error)
+{
+    if (active.load())
+    {
+        error = "A recording is already open";
+        return false;
+    }
+    // the batch is already large, so write it straight to the file
+    file.rdbuf()->pubsetbuf(nullptr, 0);
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        error = "Unable to create recording " + path;
+        return false;
+    }
+    SessionHeader header{};
+    std::copy(std::begin(SessionHeader::MAGIC), std::end(SessionHeader::MAGIC),
+              header.magic);
+    header.version = SessionHeader::VERSION;
+    header.recordSize = sizeof(SessionRecord);
+    header.startTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::system_clock::now().time_since_epoch())
+                           .count();
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!file)
+    {
+        error = "Unable to write recording " + path;
+        file.close();
+        return false;
+    }
+    origin = SteadyClock::getInstance().now();
+    writeFailed.store(false);
+    closing.reset();
+    active.store(true);
+    writer = std::thread(&SessionRecorder::run, this);
+    return true;
+}
+
+// writes any queued records and closes the recording
+void SessionRecorder::close()
+{
+    if (!active.load())
+    {
+        return;
+    }
+    active.store(false);
+    closing.raise();
+    if (writer.joinable())
+    {
+        writer.join();
+    }
+    drain();
+    flush();
+    file.close();
+}
+
+// returns if a recording is open
+bool SessionRecorder::recording() const
+{
+    return active.load();
+}
+
+// returns a channel for a newly connected wheel to record to
+std::shared_ptr<RecordChannel> SessionRecorder::attach()
+{
+    std::lock_guard<std::mutex> lock(channelsMutex);
+    auto channel = std::make_shared<RecordChannel>(
+        nextWheel++, origin, CHANNEL_CAPACITY, droppedCount);
+    channels.push_back(channel);
+    return channel;
+}
+
+// closes a channel once its wheel is no longer being polled
+void SessionRecorder::detach(const std::shared_ptr<RecordChannel> &channel)
+{
+    channel->closed.store(true, std::memory_order_release);
+}
+
+// returns the number of records written to the file
+uint64_t SessionRecorder::written() const
+{
+    return writtenCount.load(std::memory_order_relaxed);
+}
+
+// returns the number of records dropped by every channel
+uint64_t SessionRecorder::dropped() const
+{
+    return droppedCount.load(std::memory_order_relaxed);
+}
+
+// returns if writing to the file has failed
+bool SessionRecorder::failed() const
+{
+    return writeFailed.load();
+}
@@ -0,0 +1,121 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * session_recorder.h                                                         *
+ *                                                                            *
+ * Records wheel readings to a binary file without blocking polling           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "clock.h"
+#include "input_types.h"
+#include "session_record.h"
+#include "spsc_ring.h"
+#include "wake_signal.h"
+
+class RecordChannel
+{
+  private:
+    friend class SessionRecorder;
+
+    uint32_t wheel;
+    Clock::time_point origin;
+    SpscRing<SessionRecord> ring;
+    std::atomic<uint32_t> sequence;
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<uint64_t> &totalDropped;
+    std::atomic<bool> closed;
+
+  public:
+    RecordChannel(uint32_t wheel, Clock::time_point origin, size_t capacity,
+                  std::atomic<uint64_t> &totalDropped);
+    // queues a sample without blocking, dropping it if the ring is full,
+    // must only be called from the thread polling the wheel
+    void record(const WheelSample &sample, Clock::time_point now);
+    // returns the number of samples recorded, including dropped samples
+    uint64_t recorded() const;
+    // returns the number of samples dropped because the ring was full
+    uint64_t dropped() const;
+};
+
+class SessionRecorder
+{
+  private:
+    static const size_t CHANNEL_CAPACITY;
+    static const size_t WRITE_BATCH;
+    static const std::chrono::milliseconds DRAIN_INTERVAL;
+
+    std::ofstream file;
+    std::thread writer;
+    std::atomic<bool> active;
+    // raised to wake the writer when closing
+    WakeSignal closing;
+    std::mutex channelsMutex;
+    std::vector<std::shared_ptr<RecordChannel>> channels;
+    std::vector<std::shared_ptr<RecordChannel>> draining;
+    std::vector<SessionRecord> batch;
+    size_t batchSize;
+    uint32_t nextWheel;
+    Clock::time_point origin;
+    std::atomic<uint64_t> writtenCount;
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<bool> writeFailed;
+
+    // moves queued records to the file until stopped
+    void run();
+    // moves every queued record into the batch, returns false if none
+    bool drain();
+    // writes the batch to the file
+    void flush();
+
+  public:
+    SessionRecorder();
+    ~SessionRecorder();
+    // creates a recording and starts the writer, returns false and sets
+    // error on failure
+    bool open(const std::string &path, std::string &error);
+    // writes any queued records and closes the recording
+    void close();
+    // returns if a recording is open
+    bool recording() const;
+    // returns a channel for a newly connected wheel to record to
+    std::shared_ptr<RecordChannel> attach();
+    // closes a channel once its wheel is no longer being polled
+    void detach(const std::shared_ptr<RecordChannel> &channel);
+    // returns the number of records written to the file
+    uint64_t written() const;
+    // returns the number of records dropped by every channel
+    uint64_t dropped() const;
+    // returns if writing to the file has failed
+    bool failed() const;
+};
+
+#endif
@@ -0,0 +1,201 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * shared_memory.cpp                                                          *
+ *                                                                            *
+ * A named region of memory shared between processes                          *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "shared_memory.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifndef _WIN32
+// POSIX names must start with a slash and contain no others
+static std::string posixName(const std::string &name)
+{
+    return "/" + name;
+}
+#endif
+
+SharedMemory::SharedMemory()
+    : name{}, view{nullptr}, viewSize{0}, created{false}
+#ifdef _WIN32
+      ,
+      mapping{nullptr}
+#endif
+{
+}
+
+SharedMemory::~SharedMemory()
+{
+    close();
+}
+
+// creates and maps a zeroed region called name, replacing any left behind by
+// a previous process, returns false and sets error on failure
+bool SharedMemory::create(const std::string &name, size_t size,
+                          std::string &error)
+{
+    close();
+    error = "Unable to create shared memory " + name;
+#ifdef _WIN32
+    // Windows removes a region once every handle to it is closed
+    mapping = CreateFileMappingA(
+        INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+        static_cast<DWORD>(size), name.c_str());
+    if (!mapping)
+    {
+        return false;
+    }
+    view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+    // a reader may still hold a region left by an earlier process
+    std::memset(view, 0, size);
+#else
+    // a crashed process leaves its region behind, readers of which keep
+    // their mapping of it
+    std::string path = posixName(name);
+    shm_unlink(path.c_str());
+    int fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0)
+    {
+        return false;
+    }
+    // a new region is zeroed by ftruncate
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+    {
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        view = nullptr;
+        shm_unlink(path.c_str());
+        return false;
+    }
+#endif
+    this->name = name;
+    viewSize = size;
+    created = true;
+    error.clear();
+    return true;
+}
+
+// maps an existing region called name read only, returns false and sets
+// error on failure
+bool SharedMemory::open(const std::string &name, size_t size,
+                        std::string &error)
+{
+    close();
+    error = "Unable to open shared memory " + name;
+#ifdef _WIN32
+    mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, name.c_str());
+    if (!mapping)
+    {
+        return false;
+    }
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, size);
+    if (!view)
+    {
+        CloseHandle(mapping);
+        mapping = nullptr;
+        return false;
+    }
+#else
+    int fd = shm_open(posixName(name).c_str(), O_RDONLY, 0);
+    if (fd < 0)
+    {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < size)
+    {
+        ::close(fd);
+        error = "Shared memory " + name + " is too small";
+        return false;
+    }
+    view = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (view == MAP_FAILED)
+    {
+        view = nullptr;
+        return false;
+    }
+#endif
+    this->name = name;
+    viewSize = size;
+    created = false;
+    error.clear();
+    return true;
+}
+
+// unmaps the region, removing its name if it was created
+void SharedMemory::close()
+{
+    if (!view)
+    {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+    CloseHandle(mapping);
+    mapping = nullptr;
+#else
+    munmap(view, viewSize);
+    if (created)
+    {
+        shm_unlink(posixName(name).c_str());
+    }
+#endif
+    view = nullptr;
+    viewSize = 0;
+    created = false;
+    name.clear();
+}
+
+// returns the mapped region, or null if none is mapped
+void *SharedMemory::data() const
+{
+    return view;
+}
+
+// returns the size of the mapped region
+size_t SharedMemory::size() const
+{
+    return viewSize;
+}
@@ -0,0 +1,63 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * shared_memory.h                                                            *
+ *                                                                            *
+ * A named region of memory shared between processes                          *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SHARED_MEMORY_H
+#define SHARED_MEMORY_H
+
+#include <cstddef>
+#include <string>
+
+class SharedMemory
+{
+  private:
+    std::string name;
+    void *view;
+    size_t viewSize;
+    // the creator removes the name once it is closed
+    bool created;
+#ifdef _WIN32
+    void *mapping;
+#endif
+
+  public:
+    SharedMemory();
+    ~SharedMemory();
+    SharedMemory &operator=(const SharedMemory &) = delete;
+    SharedMemory(const SharedMemory &) = delete;
+
+    // creates and maps a zeroed region called name, replacing any left
+    // behind by a previous process, returns false and sets error on failure
+    bool create(const std::string &name, size_t size, std::string &error);
+    // maps an existing region called name read only, returns false and sets
+    // error on failure
+    bool open(const std::string &name, size_t size, std::string &error);
+    // unmaps the region, removing its name if it was created
+    void close();
+    // returns the mapped region, or null if none is mapped
+    void *data() const;
+    // returns the size of the mapped region
+    size_t size() const;
+};
+
+#endif
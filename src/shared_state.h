@@ -0,0 +1,75 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * shared_state.h                                                             *
+ *                                                                            *
+ * The versioned layout of wheel state shared with other processes            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SHARED_STATE_H
+#define SHARED_STATE_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "input_types.h"
+#include "snapshot.h"
+
+// identifies a mapped region as wheel state, "XWCS" in little endian
+static constexpr uint32_t SHARED_STATE_MAGIC = 0x53435758;
+// incremented whenever the layout below changes
+static constexpr uint32_t SHARED_STATE_VERSION = 1;
+static constexpr uint32_t SHARED_STATE_SLOTS = 16;
+
+// readers in other processes share these atomics through the mapping
+static_assert(std::atomic<uint32_t>::is_always_lock_free &&
+                  std::atomic<uint64_t>::is_always_lock_free,
+              "Shared state needs address free atomics");
+
+// the state of one wheel, published by the thread polling it
+struct SharedWheelSlot
+{
+    // odd while a wheel is publishing to the slot, incremented when a wheel
+    // takes or leaves it so readers notice a different wheel
+    alignas(64) std::atomic<uint32_t> generation;
+    // the latest reading and its mapping, version() counts readings
+    Snapshot<WheelSample> sample;
+};
+
+struct SharedStateHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    // sizes readers check before trusting the layout
+    uint32_t headerSize;
+    uint32_t slotSize;
+    uint32_t slotCount;
+    // poll rate of the wheels publishing, so readers can pace themselves
+    uint32_t pollRateHz;
+    // cleared when the publisher closes the region
+    std::atomic<uint32_t> open;
+};
+
+struct SharedState
+{
+    alignas(64) SharedStateHeader header;
+    SharedWheelSlot slots[SHARED_STATE_SLOTS];
+};
+
+#endif
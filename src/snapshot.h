@@ -0,0 +1,114 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * snapshot.h                                                                 *
+ *                                                                            *
+ * Single writer, multiple reader seqlock holding the latest copy of a value  *
+ *                                                                            *
+ * The writer never waits. A reader retries if a write overlaps its copy, so  *
+ * it always sees a value exactly as written. The value is stored in atomic   *
+ * words so overlapping reads are not data races.                             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T> class Snapshot
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "Snapshot values must be trivially copyable");
+
+  private:
+    static constexpr size_t WORDS =
+        (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // odd while a write is in progress
+    alignas(64) std::atomic<uint64_t> sequence;
+    std::atomic<uint64_t> words[WORDS];
+
+  public:
+    Snapshot() : sequence{0}
+    {
+        for (std::atomic<uint64_t> &word : words)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+        write(T{});
+    }
+    Snapshot &operator=(const Snapshot &) = delete;
+    Snapshot(const Snapshot &) = delete;
+
+    // publishes a new value, must only be called from one thread at a time
+    void write(const T &value)
+    {
+        uint64_t buffer[WORDS] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+        uint64_t current = sequence.load(std::memory_order_relaxed);
+        sequence.store(current + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; i++)
+        {
+            words[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence.store(current + 2, std::memory_order_release);
+    }
+
+    // returns the most recently published value
+    T read() const
+    {
+        uint64_t version;
+        return read(version);
+    }
+
+    // returns the most recently published value and sets version to the
+    // number of values published up to and including it
+    T read(uint64_t &version) const
+    {
+        uint64_t buffer[WORDS];
+        uint64_t before;
+        uint64_t after;
+        do
+        {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++)
+            {
+                buffer[i] = words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while (before != after || (before & 1));
+        version = before / 2;
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+
+    // returns the number of values published, to detect new values
+    uint64_t version() const
+    {
+        return sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+#endif
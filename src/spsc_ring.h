@@ -0,0 +1,116 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * spsc_ring.h                                                                *
+ *                                                                            *
+ * A fixed capacity single producer, single consumer ring buffer              *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+template <typename T> class SpscRing
+{
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SpscRing values must be trivially copyable");
+
+  private:
+    std::unique_ptr<T[]> slots;
+    size_t mask;
+
+    // each index is written by one side only, so keep them on separate lines
+    alignas(64) std::atomic<size_t> head;
+    size_t cachedTail;
+    alignas(64) std::atomic<size_t> tail;
+    size_t cachedHead;
+
+    // returns the smallest power of two not less than value
+    static size_t roundUp(size_t value)
+    {
+        size_t size = 1;
+        while (size < value)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+  public:
+    // allocates every slot up front, capacity is rounded up to a power of two
+    explicit SpscRing(size_t capacity)
+        : slots{new T[roundUp(capacity)]}, mask{roundUp(capacity) - 1},
+          head{0}, cachedTail{0}, tail{0}, cachedHead{0}
+    {
+    }
+    SpscRing &operator=(const SpscRing &) = delete;
+    SpscRing(const SpscRing &) = delete;
+
+    // adds a value, returns false without blocking if the ring is full,
+    // must only be called from the producer thread
+    bool push(const T &value)
+    {
+        size_t current = head.load(std::memory_order_relaxed);
+        if (current - cachedTail > mask)
+        {
+            cachedTail = tail.load(std::memory_order_acquire);
+            if (current - cachedTail > mask)
+            {
+                return false;
+            }
+        }
+        slots[current & mask] = value;
+        head.store(current + 1, std::memory_order_release);
+        return true;
+    }
+
+    // removes up to max values into out, returns the number removed,
+    // must only be called from the consumer thread
+    size_t pop(T *out, size_t max)
+    {
+        size_t current = tail.load(std::memory_order_relaxed);
+        if (cachedHead == current)
+        {
+            cachedHead = head.load(std::memory_order_acquire);
+        }
+        size_t count = cachedHead - current;
+        if (count > max)
+        {
+            count = max;
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            out[i] = slots[(current + i) & mask];
+        }
+        tail.store(current + count, std::memory_order_release);
+        return count;
+    }
+
+    // returns the number of values the ring can hold
+    size_t capacity() const
+    {
+        return mask + 1;
+    }
+};
+
+#endif
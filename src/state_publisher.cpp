@@ -0,0 +1,109 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_publisher.cpp                                                        *
+ *                                                                            *
+ * Publishes wheel state to other processes through shared memory             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "state_publisher.h"
+
+#include <new>
+
+StatePublisher::StatePublisher() : memory{}, state{nullptr}
+{
+}
+
+StatePublisher::~StatePublisher()
+{
+    close();
+}
+
+// creates the region called name for wheels polled at pollRateHz, returns
+// false and sets error on failure
+bool StatePublisher::open(const std::string &name, int pollRateHz,
+                          std::string &error)
+{
+    close();
+    if (!memory.create(name, sizeof(SharedState), error))
+    {
+        return false;
+    }
+    state = new (memory.data()) SharedState;
+    SharedStateHeader &header = state->header;
+    header.magic = SHARED_STATE_MAGIC;
+    header.version = SHARED_STATE_VERSION;
+    header.headerSize = sizeof(SharedStateHeader);
+    header.slotSize = sizeof(SharedWheelSlot);
+    header.slotCount = SHARED_STATE_SLOTS;
+    header.pollRateHz = static_cast<uint32_t>(pollRateHz);
+    for (SharedWheelSlot &slot : state->slots)
+    {
+        slot.generation.store(0, std::memory_order_relaxed);
+    }
+    // readers trust the header once they see the region open
+    header.open.store(1, std::memory_order_release);
+    return true;
+}
+
+// tells readers the region is closed and removes it, every slot must have
+// been detached
+void StatePublisher::close()
+{
+    if (!state)
+    {
+        return;
+    }
+    state->header.open.store(0, std::memory_order_release);
+    state->~SharedState();
+    state = nullptr;
+    memory.close();
+}
+
+// returns if a region is open
+bool StatePublisher::publishing() const
+{
+    return state != nullptr;
+}
+
+// returns a free slot for a newly started wheel to publish to, or null if
+// every slot is taken
+SharedWheelSlot *StatePublisher::attach()
+{
+    std::lock_guard<std::mutex> lock(slotsMutex);
+    for (SharedWheelSlot &slot : state->slots)
+    {
+        uint32_t generation = slot.generation.load(std::memory_order_relaxed);
+        if (generation % 2 == 0)
+        {
+            // hide the previous wheel's last reading from readers
+            slot.sample.write(WheelSample{});
+            slot.generation.store(generation + 1, std::memory_order_release);
+            return &slot;
+        }
+    }
+    return nullptr;
+}
+
+// frees a slot once its wheel is no longer being polled
+void StatePublisher::detach(SharedWheelSlot *slot)
+{
+    std::lock_guard<std::mutex> lock(slotsMutex);
+    slot->generation.fetch_add(1, std::memory_order_release);
+}
@@ -0,0 +1,63 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_publisher.h                                                          *
+ *                                                                            *
+ * Publishes wheel state to other processes through shared memory             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef STATE_PUBLISHER_H
+#define STATE_PUBLISHER_H
+
+#include <mutex>
+#include <string>
+
+#include "shared_memory.h"
+#include "shared_state.h"
+
+class StatePublisher
+{
+  private:
+    SharedMemory memory;
+    SharedState *state;
+    // guards slot generations against wheels starting and stopping at once
+    std::mutex slotsMutex;
+
+  public:
+    StatePublisher();
+    ~StatePublisher();
+    StatePublisher &operator=(const StatePublisher &) = delete;
+    StatePublisher(const StatePublisher &) = delete;
+
+    // creates the region called name for wheels polled at pollRateHz,
+    // returns false and sets error on failure
+    bool open(const std::string &name, int pollRateHz, std::string &error);
+    // tells readers the region is closed and removes it, every slot must
+    // have been detached
+    void close();
+    // returns if a region is open
+    bool publishing() const;
+    // returns a free slot for a newly started wheel to publish to, or null
+    // if every slot is taken
+    SharedWheelSlot *attach();
+    // frees a slot once its wheel is no longer being polled
+    void detach(SharedWheelSlot *slot);
+};
+
+#endif
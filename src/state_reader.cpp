@@ -0,0 +1,114 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_reader.cpp                                                           *
+ *                                                                            *
+ * Reads wheel state published by the service from another process            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "state_reader.h"
+
+StateReader::StateReader() : memory{}, state{nullptr}
+{
+}
+
+// maps the region published as name, returns false and sets error if it does
+// not exist or has a different layout
+bool StateReader::open(const std::string &name, std::string &error)
+{
+    close();
+    if (!memory.open(name, sizeof(SharedState), error))
+    {
+        return false;
+    }
+    const auto *mapped = static_cast<const SharedState *>(memory.data());
+    const SharedStateHeader &header = mapped->header;
+    // the header is only complete once the region is open
+    if (header.open.load(std::memory_order_acquire) == 0)
+    {
+        error = "Shared memory " + name + " is not open";
+    }
+    else if (header.magic != SHARED_STATE_MAGIC)
+    {
+        error = "Shared memory " + name + " is not wheel state";
+    }
+    else if (header.version != SHARED_STATE_VERSION ||
+             header.headerSize != sizeof(SharedStateHeader) ||
+             header.slotSize != sizeof(SharedWheelSlot) ||
+             header.slotCount != SHARED_STATE_SLOTS)
+    {
+        error = "Shared memory " + name + " has an incompatible layout";
+    }
+    else
+    {
+        state = mapped;
+        return true;
+    }
+    memory.close();
+    return false;
+}
+
+// unmaps the region
+void StateReader::close()
+{
+    state = nullptr;
+    memory.close();
+}
+
+// returns if the publisher still has the region open
+bool StateReader::connected() const
+{
+    return state && state->header.open.load(std::memory_order_acquire) != 0;
+}
+
+// returns the rate at which the publisher polls wheels
+int StateReader::pollRateHz() const
+{
+    return state ? static_cast<int>(state->header.pollRateHz) : 0;
+}
+
+// returns the number of slots wheels may publish to
+size_t StateReader::slots() const
+{
+    return state ? SHARED_STATE_SLOTS : 0;
+}
+
+// reads the latest state of the wheel in slot without blocking the
+// publisher, returns false if no wheel is publishing to it
+bool StateReader::read(size_t slot, PublishedWheel &wheel) const
+{
+    if (!state || slot >= SHARED_STATE_SLOTS)
+    {
+        return false;
+    }
+    const SharedWheelSlot &shared = state->slots[slot];
+    uint32_t generation;
+    do
+    {
+        generation = shared.generation.load(std::memory_order_acquire);
+        if (generation % 2 == 0)
+        {
+            return false;
+        }
+        wheel.sample = shared.sample.read(wheel.version);
+        // retry if a different wheel took the slot while reading
+    } while (shared.generation.load(std::memory_order_acquire) != generation);
+    wheel.generation = generation;
+    return true;
+}
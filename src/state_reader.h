@@ -0,0 +1,73 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * state_reader.h                                                             *
+ *                                                                            *
+ * Reads wheel state published by the service from another process            *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef STATE_READER_H
+#define STATE_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "input_types.h"
+#include "shared_memory.h"
+#include "shared_state.h"
+
+// the state of one wheel as last published
+struct PublishedWheel
+{
+    // changes when a different wheel takes the slot
+    uint32_t generation;
+    // increases by one with each reading the wheel publishes
+    uint64_t version;
+    WheelSample sample;
+};
+
+class StateReader
+{
+  private:
+    SharedMemory memory;
+    const SharedState *state;
+
+  public:
+    StateReader();
+    StateReader &operator=(const StateReader &) = delete;
+    StateReader(const StateReader &) = delete;
+
+    // maps the region published as name, returns false and sets error if it
+    // does not exist or has a different layout
+    bool open(const std::string &name, std::string &error);
+    // unmaps the region
+    void close();
+    // returns if the publisher still has the region open
+    bool connected() const;
+    // returns the rate at which the publisher polls wheels
+    int pollRateHz() const;
+    // returns the number of slots wheels may publish to
+    size_t slots() const;
+    // reads the latest state of the wheel in slot without blocking the
+    // publisher, returns false if no wheel is publishing to it
+    bool read(size_t slot, PublishedWheel &wheel) const;
+};
+
+#endif
@@ -0,0 +1,86 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_frame.cpp                                                        *
+ *                                                                            *
+ * A preallocated grid of characters for telemetry to be drawn into           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "telemetry_frame.h"
+
+#include <cstdio>
+#include <cstring>
+
+TelemetryFrame::TelemetryFrame()
+    : cells{new char[WIDTH * MAX_ROWS]}, used{0}
+{
+    std::memset(cells.get(), ' ', WIDTH * MAX_ROWS);
+}
+
+// removes every line
+void TelemetryFrame::clear()
+{
+    // rows past the end are always blank, so only used rows are cleared
+    std::memset(cells.get(), ' ', WIDTH * used);
+    used = 0;
+}
+
+// appends a printf formatted line, truncated to the frame width and ignored
+// once the frame is full
+void TelemetryFrame::print(const char *format, ...)
+{
+    if (used == MAX_ROWS)
+    {
+        return;
+    }
+    char text[WIDTH + 1];
+    va_list args;
+    va_start(args, format);
+    int length = std::vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    if (length > WIDTH)
+    {
+        length = WIDTH;
+    }
+    if (length > 0)
+    {
+        std::memcpy(cells.get() + used * WIDTH, text, length);
+    }
+    used++;
+}
+
+// replaces the contents of the frame with another frame
+void TelemetryFrame::copy(const TelemetryFrame &other)
+{
+    int rows = used > other.used ? used : other.used;
+    std::memcpy(cells.get(), other.cells.get(), WIDTH * rows);
+    used = other.used;
+}
+
+// returns the WIDTH characters of a row, which are spaces past the end
+const char *TelemetryFrame::line(int row) const
+{
+    return cells.get() + row * WIDTH;
+}
+
+// returns the number of lines printed
+int TelemetryFrame::rows() const
+{
+    return used;
+}
@@ -0,0 +1,62 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_frame.h                                                          *
+ *                                                                            *
+ * A preallocated grid of characters for telemetry to be drawn into           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <cstdarg>
+#include <memory>
+
+class TelemetryFrame
+{
+  public:
+    static constexpr int WIDTH = 80;
+    static constexpr int MAX_ROWS = 128;
+
+  private:
+    std::unique_ptr<char[]> cells;
+    int used;
+
+  public:
+    // allocates every row up front, filled with spaces
+    TelemetryFrame();
+    TelemetryFrame &operator=(const TelemetryFrame &) = delete;
+    TelemetryFrame(const TelemetryFrame &) = delete;
+    // removes every line
+    void clear();
+    // appends a printf formatted line, truncated to the frame width and
+    // ignored once the frame is full
+#if defined(__GNUC__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void print(const char *format, ...);
+    // replaces the contents of the frame with another frame
+    void copy(const TelemetryFrame &other);
+    // returns the WIDTH characters of a row, which are spaces past the end
+    const char *line(int row) const;
+    // returns the number of lines printed
+    int rows() const;
+};
+
+#endif
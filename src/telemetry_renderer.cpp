@@ -0,0 +1,131 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_renderer.cpp                                                     *
+ *                                                                            *
+ * Draws telemetry frames by rewriting only the characters which changed      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "telemetry_renderer.h"
+
+#include <cstdio>
+
+TelemetryRenderer::TelemetryRenderer()
+    : previous{}, drawnRows{0}, cursorRow{0}, cursorColumn{0}, output{}
+{
+    // enough for every cell and a cursor movement on each row
+    output.reserve((TelemetryFrame::WIDTH + 32) * TelemetryFrame::MAX_ROWS);
+}
+
+// appends an escape sequence with a numeric parameter
+void TelemetryRenderer::appendSequence(int value, char command)
+{
+    char sequence[16];
+    int length = std::snprintf(sequence, sizeof(sequence), "\x1b[%d%c", value,
+                               command);
+    output.append(sequence, length);
+}
+
+// appends the sequence moving the cursor to a cell of the frame
+void TelemetryRenderer::moveTo(int row, int column)
+{
+    if (row < cursorRow)
+    {
+        appendSequence(cursorRow - row, 'A');
+    }
+    else if (row > cursorRow)
+    {
+        // new lines rather than cursor down, so the console scrolls when the
+        // frame grows past the bottom of the screen
+        output.append(row - cursorRow, '\n');
+        cursorColumn = 0;
+    }
+    cursorRow = row;
+    if (column != cursorColumn)
+    {
+        output += '\r';
+        if (column > 0)
+        {
+            appendSequence(column, 'C');
+        }
+    }
+    cursorColumn = column;
+}
+
+// returns the text which changes the previous frame on screen into frame,
+// leaving the cursor below it
+const std::string &TelemetryRenderer::render(const TelemetryFrame &frame)
+{
+    output.clear();
+    int rows = frame.rows() > drawnRows ? frame.rows() : drawnRows;
+    for (int row = 0; row < rows; row++)
+    {
+        const char *line = frame.line(row);
+        const char *old = previous.line(row);
+        // rows never drawn are always rewritten, as they hold other output
+        int first = 0;
+        int last = TelemetryFrame::WIDTH - 1;
+        if (row < drawnRows)
+        {
+            while (first < TelemetryFrame::WIDTH && line[first] == old[first])
+            {
+                first++;
+            }
+            if (first == TelemetryFrame::WIDTH)
+            {
+                continue;
+            }
+            while (line[last] == old[last])
+            {
+                last--;
+            }
+        }
+        moveTo(row, first);
+        output.append(line + first, last - first + 1);
+        cursorColumn = last + 1;
+    }
+    moveTo(rows, 0);
+    drawnRows = rows;
+    previous.copy(frame);
+    return output;
+}
+
+// returns the text which erases the frame, after which the next frame is
+// drawn in full from the cursor
+const std::string &TelemetryRenderer::erase()
+{
+    output.clear();
+    if (drawnRows > 0)
+    {
+        moveTo(0, 0);
+        // erase from the cursor to the end of the screen
+        output += "\x1b[J";
+    }
+    drawnRows = 0;
+    cursorRow = 0;
+    cursorColumn = 0;
+    previous.clear();
+    return output;
+}
+
+// returns if a frame is on screen
+bool TelemetryRenderer::drawn() const
+{
+    return drawnRows > 0;
+}
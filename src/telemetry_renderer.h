@@ -0,0 +1,62 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_renderer.h                                                       *
+ *                                                                            *
+ * Draws telemetry frames by rewriting only the characters which changed      *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef TELEMETRY_RENDERER_H
+#define TELEMETRY_RENDERER_H
+
+#include <string>
+
+#include "telemetry_frame.h"
+
+// produces ANSI escape sequences, which the Windows console also accepts
+// once virtual terminal processing is enabled
+class TelemetryRenderer
+{
+  private:
+    TelemetryFrame previous;
+    // lines of the frame on screen, below the line the frame started on
+    int drawnRows;
+    // cursor position relative to the top left of the frame
+    int cursorRow;
+    int cursorColumn;
+    std::string output;
+
+    // appends the sequence moving the cursor to a cell of the frame
+    void moveTo(int row, int column);
+    // appends an escape sequence with a numeric parameter
+    void appendSequence(int value, char command);
+
+  public:
+    TelemetryRenderer();
+    // returns the text which changes the previous frame on screen into
+    // frame, leaving the cursor below it
+    const std::string &render(const TelemetryFrame &frame);
+    // returns the text which erases the frame, after which the next frame
+    // is drawn in full from the cursor
+    const std::string &erase();
+    // returns if a frame is on screen
+    bool drawn() const;
+};
+
+#endif
@@ -0,0 +1,78 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_view.cpp                                                         *
+ *                                                                            *
+ * Formats the telemetry of each wheel into a frame                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "telemetry_view.h"
+
+#include "button_map.h"
+
+// appends the lines describing a wheel to frame, without allocating
+void TelemetryView::addWheel(TelemetryFrame &frame, int number,
+                             const WheelTelemetry &wheel)
+{
+    frame.print("Wheel %d", number);
+    frame.print("Steering: %7.2f%%", wheel.output.leftThumbstickX * 100);
+    frame.print("Throttle: %7.2f%%", wheel.output.rightTrigger * 100);
+    frame.print("Brake: %10.2f%%", wheel.output.leftTrigger * 100);
+    char buttons[TelemetryFrame::WIDTH];
+    ButtonMap::describe(wheel.output.buttons, buttons, sizeof(buttons));
+    frame.print("Buttons: %s", buttons);
+    frame.print("Injected: %llu  Skipped: %llu",
+                static_cast<unsigned long long>(wheel.injected),
+                static_cast<unsigned long long>(wheel.skipped));
+    if (wheel.recording)
+    {
+        frame.print(
+            "Recorded: %llu  Dropped: %llu",
+            static_cast<unsigned long long>(wheel.recording->recorded()),
+            static_cast<unsigned long long>(wheel.recording->dropped()));
+    }
+    const double fractions[] = {0.5, 0.99, 0.999};
+    uint64_t values[3];
+    for (int i = 0; i < InputPipeline::NUM_STAGES; i++)
+    {
+        const Histogram *latency = wheel.latency[i];
+        if (latency)
+        {
+            latency->percentiles(fractions, values, 3);
+            frame.print("%s p50/p99/p99.9/max: %.1f/%.1f/%.1f/%.1f us",
+                        InputPipeline::stageName(
+                            static_cast<InputPipeline::Stage>(i)),
+                        values[0] / 1000.0, values[1] / 1000.0,
+                        values[2] / 1000.0, latency->max() / 1000.0);
+        }
+    }
+    if (wheel.pacer)
+    {
+        const Histogram &jitter = wheel.pacer->getJitter();
+        jitter.percentiles(fractions, values, 2);
+        frame.print("Rate: %d Hz  Missed: %llu  Jitter p50/p99/max: "
+                    "%.1f/%.1f/%.1f us",
+                    wheel.pacer->rate(),
+                    static_cast<unsigned long long>(wheel.pacer->missed()),
+                    values[0] / 1000.0, values[1] / 1000.0,
+                    jitter.max() / 1000.0);
+    }
+    // blank line after each wheel
+    frame.print("%s", "");
+}
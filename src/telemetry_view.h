@@ -0,0 +1,58 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * telemetry_view.h                                                           *
+ *                                                                            *
+ * Formats the telemetry of each wheel into a frame                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef TELEMETRY_VIEW_H
+#define TELEMETRY_VIEW_H
+
+#include <cstdint>
+
+#include "histogram.h"
+#include "input_pipeline.h"
+#include "input_types.h"
+#include "pacer.h"
+#include "session_recorder.h"
+#include "telemetry_frame.h"
+
+// the values shown in telemetry for one wheel
+struct WheelTelemetry
+{
+    GamepadState output;
+    uint64_t injected = 0;
+    uint64_t skipped = 0;
+    // null unless the wheel is recorded
+    const RecordChannel *recording = nullptr;
+    const Histogram *latency[InputPipeline::NUM_STAGES] = {};
+    // null unless the wheel is being polled
+    const Pacer *pacer = nullptr;
+};
+
+class TelemetryView
+{
+  public:
+    // appends the lines describing a wheel to frame, without allocating
+    static void addWheel(TelemetryFrame &frame, int number,
+                         const WheelTelemetry &wheel);
+};
+
+#endif
@@ -0,0 +1,226 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * thread_tuning.cpp                                                          *
+ *                                                                            *
+ * Priority and core affinity of the calling thread, so polling keeps its     *
+ * deadlines while other programs load the cpu                                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "thread_tuning.h"
+
+#include <thread>
+
+#include "output_manager.h"
+
+#ifdef _WIN32
+#include <windows.h>
+
+#include <avrt.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+// the multimedia class scheduler task whose priority polling shares
+static const wchar_t *const MMCSS_TASK = L"Games";
+#else
+// below the kernel's interrupt threads, so the wheel's own usb interrupts
+// are not held up by the thread waiting for them
+static const int REALTIME_PRIORITY = 40;
+// niceness of low priority threads
+static const int LOW_NICENESS = 10;
+
+// returns the description of an error number
+static std::string describe(int error)
+{
+    return std::strerror(error);
+}
+#endif
+
+ThreadTuning::ThreadTuning()
+#ifdef _WIN32
+    : task{nullptr}
+#endif
+{
+}
+
+// restores anything which outlives the thread, must be destroyed on the
+// thread it tuned
+ThreadTuning::~ThreadTuning()
+{
+#ifdef _WIN32
+    if (task)
+    {
+        AvRevertMmThreadCharacteristics(task);
+    }
+#endif
+}
+
+// sets the priority of the calling thread, returns false and sets error on
+// failure
+bool ThreadTuning::setPriority(ThreadPriority priority, std::string &error)
+{
+#ifdef _WIN32
+    if (priority == ThreadPriority::RealTime)
+    {
+        // the multimedia class scheduler raises the thread without
+        // administrator rights, and lowers it again if it would starve others
+        DWORD taskIndex = 0;
+        if (!task)
+        {
+            task = AvSetMmThreadCharacteristicsW(MMCSS_TASK, &taskIndex);
+        }
+        if (task && AvSetMmThreadPriority(task, AVRT_PRIORITY_HIGH))
+        {
+            return true;
+        }
+    }
+    else if (task)
+    {
+        AvRevertMmThreadCharacteristics(task);
+        task = nullptr;
+    }
+    // without the scheduler, raise the thread as far as a normal process can
+    int level = THREAD_PRIORITY_NORMAL;
+    if (priority == ThreadPriority::RealTime)
+    {
+        level = THREAD_PRIORITY_TIME_CRITICAL;
+    }
+    else if (priority == ThreadPriority::Low)
+    {
+        level = THREAD_PRIORITY_BELOW_NORMAL;
+    }
+    if (!SetThreadPriority(GetCurrentThread(), level))
+    {
+        error = "SetThreadPriority failed with error " +
+                std::to_string(GetLastError());
+        return false;
+    }
+    return true;
+#else
+    sched_param param{};
+    if (priority == ThreadPriority::RealTime)
+    {
+        param.sched_priority = REALTIME_PRIORITY;
+        int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (result != 0)
+        {
+            error = "SCHED_FIFO " + describe(result) +
+                    (result == EPERM ? ", it needs CAP_SYS_NICE or an "
+                                       "rtprio limit"
+                                     : "");
+            return false;
+        }
+        return true;
+    }
+    int result = pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+    if (result != 0)
+    {
+        error = "SCHED_OTHER " + describe(result);
+        return false;
+    }
+    // linux gives each thread its own niceness
+    pid_t thread = static_cast<pid_t>(syscall(SYS_gettid));
+    int niceness = priority == ThreadPriority::Low ? LOW_NICENESS : 0;
+    if (setpriority(PRIO_PROCESS, thread, niceness) != 0)
+    {
+        error = "setpriority " + describe(errno);
+        return false;
+    }
+    return true;
+#endif
+}
+
+// runs the calling thread only on cores, returns false and sets error on
+// failure
+bool ThreadTuning::setCores(const std::vector<int> &cores, std::string &error)
+{
+#ifdef _WIN32
+    DWORD_PTR mask = 0;
+    for (int core : cores)
+    {
+        if (core < 0 || core >= static_cast<int>(sizeof(mask) * 8))
+        {
+            error = "Core " + std::to_string(core) + " does not exist";
+            return false;
+        }
+        mask |= static_cast<DWORD_PTR>(1) << core;
+    }
+    if (!SetThreadAffinityMask(GetCurrentThread(), mask))
+    {
+        error = "SetThreadAffinityMask failed with error " +
+                std::to_string(GetLastError());
+        return false;
+    }
+    return true;
+#else
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int core : cores)
+    {
+        if (core < 0 || core >= CPU_SETSIZE)
+        {
+            error = "Core " + std::to_string(core) + " does not exist";
+            return false;
+        }
+        CPU_SET(core, &set);
+    }
+    int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (result != 0)
+    {
+        error = "pthread_setaffinity_np " + describe(result);
+        return false;
+    }
+    return true;
+#endif
+}
+
+// sets the priority of the calling thread and, unless cores is empty, its
+// cores, logging any failure as the thread called name
+void ThreadTuning::apply(ThreadPriority priority, const std::vector<int> &cores,
+                         const std::string &name)
+{
+    OutputManager &outputManager = OutputManager::getInstance();
+    std::string error;
+    // leave the priority the thread was created with unless asked, as
+    // returning from low priority to normal needs privileges on linux
+    if (priority != ThreadPriority::Normal && !setPriority(priority, error))
+    {
+        outputManager.error("Could not set " + name +
+                            " thread priority: " + error);
+    }
+    if (!cores.empty() && !setCores(cores, error))
+    {
+        outputManager.error("Could not pin " + name + " thread: " + error);
+    }
+}
+
+// returns the number of cores threads can be run on
+int ThreadTuning::numCores()
+{
+    unsigned int cores = std::thread::hardware_concurrency();
+    return cores > 0 ? static_cast<int>(cores) : 1;
+}
@@ -0,0 +1,72 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * thread_tuning.h                                                            *
+ *                                                                            *
+ * Priority and core affinity of the calling thread, so polling keeps its     *
+ * deadlines while other programs load the cpu                                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef THREAD_TUNING_H
+#define THREAD_TUNING_H
+
+#include <string>
+#include <vector>
+
+// how the scheduler favours a thread over others
+enum class ThreadPriority
+{
+    // yields to normal threads, for work which can wait
+    Low,
+    Normal,
+    // runs ahead of normal threads, where the system permits it
+    RealTime
+};
+
+class ThreadTuning
+{
+  private:
+#ifdef _WIN32
+    // the multimedia class scheduler task, or null if not registered
+    void *task;
+#endif
+
+  public:
+    ThreadTuning();
+    // restores anything which outlives the thread, must be destroyed on the
+    // thread it tuned
+    ~ThreadTuning();
+    ThreadTuning &operator=(const ThreadTuning &) = delete;
+    ThreadTuning(const ThreadTuning &) = delete;
+
+    // sets the priority of the calling thread, returns false and sets error
+    // on failure
+    bool setPriority(ThreadPriority priority, std::string &error);
+    // runs the calling thread only on cores, returns false and sets error on
+    // failure
+    bool setCores(const std::vector<int> &cores, std::string &error);
+    // sets the priority of the calling thread and, unless cores is empty,
+    // its cores, logging any failure as the thread called name
+    void apply(ThreadPriority priority, const std::vector<int> &cores,
+               const std::string &name);
+    // returns the number of cores threads can be run on
+    static int numCores();
+};
+
+#endif
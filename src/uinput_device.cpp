@@ -0,0 +1,185 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * uinput_device.cpp                                                          *
+ *                                                                            *
+ * A virtual input device created through uinput, which sends its events in   *
+ * frames                                                                     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "uinput_device.h"
+
+#include <cerrno>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+UinputDevice::UinputDevice() : fd{-1}, created{false}, events{}, numEvents{0}
+{
+}
+
+UinputDevice::~UinputDevice()
+{
+    close();
+}
+
+// opens uinput, returns false and sets error if it is unavailable
+bool UinputDevice::open(std::string &error)
+{
+    close();
+    fd = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0)
+    {
+        error = std::string("Unable to open /dev/uinput: ") +
+                std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+// adds a button to the device, before it is created
+bool UinputDevice::enableKey(uint16_t code)
+{
+    return fd >= 0 && !created && ioctl(fd, UI_SET_EVBIT, EV_KEY) == 0 &&
+           ioctl(fd, UI_SET_KEYBIT, code) == 0;
+}
+
+// adds an absolute axis from min to max to the device, before it is created
+bool UinputDevice::enableAbs(uint16_t code, int32_t min, int32_t max)
+{
+    if (fd < 0 || created || ioctl(fd, UI_SET_EVBIT, EV_ABS) != 0)
+    {
+        return false;
+    }
+    uinput_abs_setup setup{};
+    setup.code = code;
+    setup.absinfo.minimum = min;
+    setup.absinfo.maximum = max;
+    return ioctl(fd, UI_ABS_SETUP, &setup) == 0;
+}
+
+// creates the device, returns false and sets error on failure
+bool UinputDevice::create(const std::string &name, uint16_t vendor,
+                          uint16_t product, std::string &error)
+{
+    if (fd < 0)
+    {
+        error = "Unable to create " + name + ": uinput is not open";
+        return false;
+    }
+    uinput_setup setup{};
+    setup.id.bustype = BUS_USB;
+    setup.id.vendor = vendor;
+    setup.id.product = product;
+    std::strncpy(setup.name, name.c_str(), UINPUT_MAX_NAME_SIZE - 1);
+    if (ioctl(fd, UI_DEV_SETUP, &setup) != 0 ||
+        ioctl(fd, UI_DEV_CREATE) != 0)
+    {
+        error = "Unable to create " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    created = true;
+    numEvents = 0;
+    return true;
+}
+
+// returns if the device has been created
+bool UinputDevice::active() const
+{
+    return created;
+}
+
+// adds an event to the current frame
+void UinputDevice::queue(uint16_t type, uint16_t code, int32_t value)
+{
+    // leave room for the report ending the frame
+    if (numEvents >= MAX_EVENTS - 1)
+    {
+        return;
+    }
+    input_event &event = events[numEvents++];
+    event.type = type;
+    event.code = code;
+    event.value = value;
+}
+
+// sends the current frame and ends it, returns false on failure
+bool UinputDevice::sync()
+{
+    if (!created)
+    {
+        numEvents = 0;
+        return false;
+    }
+    queue(EV_SYN, SYN_REPORT, 0);
+    // uinput stamps each event itself, so the whole frame is one write
+    size_t size = numEvents * sizeof(input_event);
+    ssize_t written = write(fd, events, size);
+    numEvents = 0;
+    return written == static_cast<ssize_t>(size);
+}
+
+// returns the evdev node readers open the device through, or an empty
+// string if it has none yet
+std::string UinputDevice::eventPath() const
+{
+    char sysname[64] = {};
+    if (!created ||
+        ioctl(fd, UI_GET_SYSNAME(sizeof(sysname) - 1), sysname) < 0)
+    {
+        return "";
+    }
+    std::string path;
+    std::string sysPath = "/sys/devices/virtual/input/" + std::string(sysname);
+    DIR *dir = opendir(sysPath.c_str());
+    if (!dir)
+    {
+        return "";
+    }
+    while (dirent *entry = readdir(dir))
+    {
+        if (std::strncmp(entry->d_name, "event", 5) == 0)
+        {
+            path = std::string("/dev/input/") + entry->d_name;
+            break;
+        }
+    }
+    closedir(dir);
+    return path;
+}
+
+// destroys the device and closes uinput
+void UinputDevice::close()
+{
+    if (fd < 0)
+    {
+        return;
+    }
+    if (created)
+    {
+        ioctl(fd, UI_DEV_DESTROY);
+        created = false;
+    }
+    ::close(fd);
+    fd = -1;
+    numEvents = 0;
+}
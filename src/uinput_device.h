@@ -0,0 +1,74 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * uinput_device.h                                                            *
+ *                                                                            *
+ * A virtual input device created through uinput, which sends its events in   *
+ * frames                                                                     *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef UINPUT_DEVICE_H
+#define UINPUT_DEVICE_H
+
+#include <cstdint>
+#include <linux/input.h>
+#include <string>
+
+class UinputDevice
+{
+  private:
+    // events held until the end of a frame, enough for every axis and
+    // button of a gamepad or wheel
+    static const int MAX_EVENTS = 64;
+
+    int fd;
+    bool created;
+    input_event events[MAX_EVENTS];
+    int numEvents;
+
+  public:
+    UinputDevice();
+    ~UinputDevice();
+    UinputDevice &operator=(const UinputDevice &) = delete;
+    UinputDevice(const UinputDevice &) = delete;
+
+    // opens uinput, returns false and sets error if it is unavailable
+    bool open(std::string &error);
+    // adds a button to the device, before it is created
+    bool enableKey(uint16_t code);
+    // adds an absolute axis from min to max to the device, before it is
+    // created
+    bool enableAbs(uint16_t code, int32_t min, int32_t max);
+    // creates the device, returns false and sets error on failure
+    bool create(const std::string &name, uint16_t vendor, uint16_t product,
+                std::string &error);
+    // returns if the device has been created
+    bool active() const;
+    // adds an event to the current frame
+    void queue(uint16_t type, uint16_t code, int32_t value);
+    // sends the current frame and ends it, returns false on failure
+    bool sync();
+    // returns the evdev node readers open the device through, or an empty
+    // string if it has none yet
+    std::string eventPath() const;
+    // destroys the device and closes uinput
+    void close();
+};
+
+#endif
@@ -0,0 +1,285 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * virtual_wheel.cpp                                                          *
+ *                                                                            *
+ * A racing wheel created through uinput and a reader of the virtual gamepad, *
+ * so the evdev backend can be tested end to end without hardware             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "virtual_wheel.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <thread>
+#include <unistd.h>
+
+// the wheel is reported with the resolution of common direct drive wheels
+static const int32_t WHEEL_MAX = 65535;
+static const int32_t PEDAL_MAX = 1023;
+static const int NUM_BUTTONS = 16;
+// a vendor id reserved for testing
+static const uint16_t WHEEL_VENDOR = 0x1209;
+static const uint16_t WHEEL_PRODUCT = 0x0001;
+// the gamepad's ranges, written out rather than shared with the injector
+static const double STICK_MAX = 32767.0;
+static const double TRIGGER_MAX = 1023.0;
+static const std::chrono::milliseconds OPEN_RETRY{10};
+
+// gamepad keys and the buttons they report
+static const struct
+{
+    uint16_t code;
+    uint32_t button;
+} GAMEPAD_KEYS[] = {
+    {BTN_A, PadButtons::A},
+    {BTN_B, PadButtons::B},
+    {BTN_X, PadButtons::X},
+    {BTN_Y, PadButtons::Y},
+    {BTN_TL, PadButtons::LeftShoulder},
+    {BTN_TR, PadButtons::RightShoulder},
+    {BTN_SELECT, PadButtons::View},
+    {BTN_START, PadButtons::Menu},
+    {BTN_THUMBL, PadButtons::LeftThumbstick},
+    {BTN_THUMBR, PadButtons::RightThumbstick},
+};
+
+const char *const VirtualWheel::NAME = "Xbox Wheel Compatibility Test Wheel";
+
+// creates the wheel, returns false and sets error on failure
+bool VirtualWheel::create(std::string &error)
+{
+    if (!device.open(error))
+    {
+        return false;
+    }
+    bool described = device.enableAbs(ABS_X, 0, WHEEL_MAX) &&
+                     device.enableAbs(ABS_Y, 0, PEDAL_MAX) &&
+                     device.enableAbs(ABS_Z, 0, PEDAL_MAX) &&
+                     device.enableAbs(ABS_RZ, 0, PEDAL_MAX) &&
+                     device.enableAbs(ABS_HAT0X, -1, 1) &&
+                     device.enableAbs(ABS_HAT0Y, -1, 1);
+    for (int i = 0; i < NUM_BUTTONS; i++)
+    {
+        described = described && device.enableKey(BTN_TRIGGER + i);
+    }
+    if (!described)
+    {
+        error = std::string("Unable to describe the wheel: ") +
+                std::strerror(errno);
+        device.close();
+        return false;
+    }
+    return device.create(NAME, WHEEL_VENDOR, WHEEL_PRODUCT, error);
+}
+
+// sends the axes and buttons of a reading as one frame, returns false on
+// failure, gear buttons are not sent as evdev wheels have none
+bool VirtualWheel::send(const WheelState &state)
+{
+    device.queue(EV_ABS, ABS_X,
+                 static_cast<int32_t>(
+                     std::lround((state.wheel + 1.0) / 2.0 * WHEEL_MAX)));
+    device.queue(EV_ABS, ABS_Z,
+                 static_cast<int32_t>(std::lround(state.throttle * PEDAL_MAX)));
+    device.queue(EV_ABS, ABS_RZ,
+                 static_cast<int32_t>(std::lround(state.brake * PEDAL_MAX)));
+    device.queue(EV_ABS, ABS_Y,
+                 static_cast<int32_t>(std::lround(state.clutch * PEDAL_MAX)));
+    int32_t hatX = (state.buttons & WheelButtons::DPadRight ? 1 : 0) -
+                   (state.buttons & WheelButtons::DPadLeft ? 1 : 0);
+    int32_t hatY = (state.buttons & WheelButtons::DPadDown ? 1 : 0) -
+                   (state.buttons & WheelButtons::DPadUp ? 1 : 0);
+    device.queue(EV_ABS, ABS_HAT0X, hatX);
+    device.queue(EV_ABS, ABS_HAT0Y, hatY);
+    for (int i = 0; i < NUM_BUTTONS; i++)
+    {
+        device.queue(EV_KEY, BTN_TRIGGER + i,
+                     state.buttons & (WheelButtons::Button1 << i) ? 1 : 0);
+    }
+    return device.sync();
+}
+
+// disconnects the wheel
+void VirtualWheel::destroy()
+{
+    device.close();
+}
+
+GamepadReader::GamepadReader() : fd{-1}, removed{false}, pending{}
+{
+}
+
+GamepadReader::~GamepadReader()
+{
+    close();
+}
+
+// opens the evdev device called name, waiting up to timeout for it to
+// appear, returns false if it does not
+bool GamepadReader::open(const std::string &name,
+                         std::chrono::milliseconds timeout)
+{
+    close();
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    do
+    {
+        DIR *dir = opendir("/dev/input");
+        while (dir && fd < 0)
+        {
+            dirent *entry = readdir(dir);
+            if (!entry)
+            {
+                break;
+            }
+            if (std::strncmp(entry->d_name, "event", 5) != 0)
+            {
+                continue;
+            }
+            std::string path = std::string("/dev/input/") + entry->d_name;
+            int candidate = ::open(path.c_str(), O_RDONLY | O_NONBLOCK);
+            char deviceName[256] = {};
+            if (candidate >= 0 &&
+                ioctl(candidate, EVIOCGNAME(sizeof(deviceName) - 1),
+                      deviceName) >= 0 &&
+                name == deviceName)
+            {
+                fd = candidate;
+            }
+            else if (candidate >= 0)
+            {
+                ::close(candidate);
+            }
+        }
+        if (dir)
+        {
+            closedir(dir);
+        }
+        if (fd >= 0)
+        {
+            removed = false;
+            pending = GamepadState{};
+            return true;
+        }
+        std::this_thread::sleep_for(OPEN_RETRY);
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+// waits up to timeout for the next frame, returns false if none arrives
+bool GamepadReader::next(GamepadState &state,
+                         std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (fd >= 0)
+    {
+        input_event event;
+        if (::read(fd, &event, sizeof(event)) != sizeof(event))
+        {
+            bool waiting = errno == EAGAIN;
+            removed = removed || errno == ENODEV;
+            auto remaining =
+                std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now());
+            pollfd input = {fd, POLLIN, 0};
+            if (!waiting || remaining.count() <= 0 ||
+                poll(&input, 1, static_cast<int>(remaining.count()) + 1) <= 0)
+            {
+                return false;
+            }
+            continue;
+        }
+        if (event.type == EV_SYN && event.code == SYN_REPORT)
+        {
+            state = pending;
+            return true;
+        }
+        if (event.type == EV_KEY)
+        {
+            for (const auto &key : GAMEPAD_KEYS)
+            {
+                if (key.code == event.code)
+                {
+                    pending.buttons = event.value
+                                          ? pending.buttons | key.button
+                                          : pending.buttons & ~key.button;
+                }
+            }
+        }
+        else if (event.type == EV_ABS)
+        {
+            switch (event.code)
+            {
+            case ABS_X:
+                pending.leftThumbstickX = event.value / STICK_MAX;
+                break;
+            case ABS_Y:
+                pending.leftThumbstickY = -event.value / STICK_MAX;
+                break;
+            case ABS_RX:
+                pending.rightThumbstickX = event.value / STICK_MAX;
+                break;
+            case ABS_RY:
+                pending.rightThumbstickY = -event.value / STICK_MAX;
+                break;
+            case ABS_Z:
+                pending.leftTrigger = event.value / TRIGGER_MAX;
+                break;
+            case ABS_RZ:
+                pending.rightTrigger = event.value / TRIGGER_MAX;
+                break;
+            case ABS_HAT0X:
+                pending.buttons &=
+                    ~(PadButtons::DPadLeft | PadButtons::DPadRight);
+                pending.buttons |= event.value < 0   ? PadButtons::DPadLeft
+                                   : event.value > 0 ? PadButtons::DPadRight
+                                                     : PadButtons::None;
+                break;
+            case ABS_HAT0Y:
+                pending.buttons &= ~(PadButtons::DPadUp | PadButtons::DPadDown);
+                pending.buttons |= event.value < 0   ? PadButtons::DPadUp
+                                   : event.value > 0 ? PadButtons::DPadDown
+                                                     : PadButtons::None;
+                break;
+            }
+        }
+    }
+    return false;
+}
+
+// returns if the device has been removed since it was opened
+bool GamepadReader::disconnected() const
+{
+    return removed;
+}
+
+// closes the device
+void GamepadReader::close()
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+        fd = -1;
+    }
+}
@@ -0,0 +1,78 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * virtual_wheel.h                                                            *
+ *                                                                            *
+ * A racing wheel created through uinput and a reader of the virtual gamepad, *
+ * so the evdev backend can be tested end to end without hardware             *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef VIRTUAL_WHEEL_H
+#define VIRTUAL_WHEEL_H
+
+#include <chrono>
+#include <string>
+
+#include "input_types.h"
+#include "uinput_device.h"
+
+class VirtualWheel
+{
+  public:
+    static const char *const NAME;
+
+  private:
+    UinputDevice device;
+
+  public:
+    // creates the wheel, returns false and sets error on failure
+    bool create(std::string &error);
+    // sends the axes and buttons of a reading as one frame, returns false on
+    // failure, gear buttons are not sent as evdev wheels have none
+    bool send(const WheelState &state);
+    // disconnects the wheel
+    void destroy();
+};
+
+class GamepadReader
+{
+  private:
+    int fd;
+    bool removed;
+    // the frame being received
+    GamepadState pending;
+
+  public:
+    GamepadReader();
+    ~GamepadReader();
+    GamepadReader &operator=(const GamepadReader &) = delete;
+    GamepadReader(const GamepadReader &) = delete;
+
+    // opens the evdev device called name, waiting up to timeout for it to
+    // appear, returns false if it does not
+    bool open(const std::string &name, std::chrono::milliseconds timeout);
+    // waits up to timeout for the next frame, returns false if none arrives
+    bool next(GamepadState &state, std::chrono::milliseconds timeout);
+    // returns if the device has been removed since it was opened
+    bool disconnected() const;
+    // closes the device
+    void close();
+};
+
+#endif
@@ -0,0 +1,128 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wake_signal.cpp                                                            *
+ *                                                                            *
+ * A flag threads wait on with a deadline, which wakes every waiting thread   *
+ * the moment it is raised                                                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "wake_signal.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+WakeSignal::WakeSignal() : isRaised{false}
+{
+#ifdef _WIN32
+    event = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+#endif
+}
+
+WakeSignal::~WakeSignal()
+{
+#ifdef _WIN32
+    if (event)
+    {
+        CloseHandle(event);
+    }
+#endif
+}
+
+// raises the signal, waking every thread waiting on it
+void WakeSignal::raise()
+{
+#ifdef _WIN32
+    isRaised.store(true);
+    SetEvent(event);
+#else
+    {
+        // hold the lock so a waiter cannot miss the change between checking
+        // the flag and blocking
+        std::lock_guard<std::mutex> lock(mutex);
+        isRaised.store(true);
+    }
+    changed.notify_all();
+#endif
+}
+
+// lowers the signal so it can be waited on again
+void WakeSignal::reset()
+{
+#ifdef _WIN32
+    isRaised.store(false);
+    ResetEvent(event);
+#else
+    std::lock_guard<std::mutex> lock(mutex);
+    isRaised.store(false);
+#endif
+}
+
+// returns if the signal is raised
+bool WakeSignal::raised() const
+{
+    return isRaised.load();
+}
+
+// waits until deadline or until the signal is raised, returns if it was
+// raised
+bool WakeSignal::waitUntil(std::chrono::steady_clock::time_point deadline) const
+{
+    if (isRaised.load())
+    {
+        return true;
+    }
+#ifdef _WIN32
+    auto remaining = deadline - std::chrono::steady_clock::now();
+    if (remaining > std::chrono::steady_clock::duration::zero())
+    {
+        // round up, so the wait never ends before the deadline
+        auto ms = std::chrono::ceil<std::chrono::milliseconds>(remaining);
+        WaitForSingleObject(event, static_cast<DWORD>(ms.count()));
+    }
+    return isRaised.load();
+#else
+    std::unique_lock<std::mutex> lock(mutex);
+    return changed.wait_until(lock, deadline,
+                              [this] { return isRaised.load(); });
+#endif
+}
+
+// waits until the signal is raised
+void WakeSignal::wait() const
+{
+#ifdef _WIN32
+    while (!isRaised.load())
+    {
+        WaitForSingleObject(event, INFINITE);
+    }
+#else
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return isRaised.load(); });
+#endif
+}
+
+#ifdef _WIN32
+// returns the event set while the signal is raised
+void *WakeSignal::handle() const
+{
+    return event;
+}
+#endif
@@ -0,0 +1,71 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wake_signal.h                                                              *
+ *                                                                            *
+ * A flag threads wait on with a deadline, which wakes every waiting thread   *
+ * the moment it is raised                                                    *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef WAKE_SIGNAL_H
+#define WAKE_SIGNAL_H
+
+#include <atomic>
+#include <chrono>
+#ifndef _WIN32
+#include <condition_variable>
+#include <mutex>
+#endif
+
+class WakeSignal
+{
+  private:
+    std::atomic<bool> isRaised;
+#ifdef _WIN32
+    // a manual reset event, so waits can be combined with other handles
+    void *event;
+#else
+    mutable std::mutex mutex;
+    mutable std::condition_variable changed;
+#endif
+
+  public:
+    WakeSignal();
+    ~WakeSignal();
+    WakeSignal &operator=(const WakeSignal &) = delete;
+    WakeSignal(const WakeSignal &) = delete;
+
+    // raises the signal, waking every thread waiting on it
+    void raise();
+    // lowers the signal so it can be waited on again
+    void reset();
+    // returns if the signal is raised
+    bool raised() const;
+    // waits until deadline or until the signal is raised, returns if it was
+    // raised
+    bool waitUntil(std::chrono::steady_clock::time_point deadline) const;
+    // waits until the signal is raised
+    void wait() const;
+#ifdef _WIN32
+    // returns the event set while the signal is raised
+    void *handle() const;
+#endif
+};
+
+#endif
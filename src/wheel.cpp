@@ -24,216 +24,447 @@
 
 #include "wheel.h"
 
-const DWORD Wheel::REFRESH_DELAY_MS = 1;
-const double Wheel::NO_INPUT = 0.0;
-const DWORD Wheel::INJECTOR_INIT_DELAY_MS = 500;
+#include <cstdio>
 
-Wheel::Wheel(RacingWheel racingWheel)
-    : racingWheel(racingWheel), active{false}, injector{nullptr},
-      packetNumber{0}
+const std::chrono::milliseconds Wheel::RETRY_DELAY{500};
+
+Wheel::Wheel(std::shared_ptr<WheelDevice> device,
+             const WheelSettings &settings, PollExecutor *sharedExecutor,
+             InitPipeline *sharedInitPipeline, InjectorPool *injectorPool,
+             GamepadMerger *merger, SessionRecorder *recorder,
+             StatePublisher *publisher, int number)
+    : device{std::move(device)}, number{number}, settings(settings),
+      active{false},
+      pending{false}, lost{false}, injectorPool{injectorPool},
+      merger{merger}, pooled{false},
+      source{this->device->createSource()}, injector{createInjector()},
+      pipeline(*source, *injector, settings), executor{sharedExecutor},
+      ownExecutor{}, pacer{nullptr}, initPipeline{sharedInitPipeline},
+      ownInitPipeline{},
+      retryTime{}, recorder{recorder}, recording{}, publisher{publisher},
+      publishing{nullptr}, motor{}, pollCount{0}, wasIdle{false},
+      wakeupCount{0}, ratePolls{0},
+      rateTime{SteadyClock::getInstance().now()}, errorCounts{}
 {
+    // run wheel, on its own thread unless sharing an executor
+    if (!executor)
+    {
+        ownExecutor = std::make_unique<PollExecutor>(
+            SteadyClock::getInstance(), settings, 1);
+        executor = ownExecutor.get();
+    }
 }
 
 Wheel::~Wheel()
 {
     stop();
+    // keep a working injector initialised for the next wheel
+    if (pooled)
+    {
+        if (lost.load())
+        {
+            injector->release();
+        }
+        else
+        {
+            injectorPool->recycle(std::move(injector));
+        }
+    }
 }
 
-// reads and injects input from wheel
-void Wheel::run()
+// feeds the merger, or takes an initialised injector from the pool, or
+// creates one
+std::unique_ptr<GamepadInjector> Wheel::createInjector()
 {
+    if (merger)
+    {
+        std::unique_ptr<GamepadInjector> injector =
+            merger->attach(device->id());
+        if (injector)
+        {
+            return injector;
+        }
+        OutputManager::getInstance().log(
+            "Every merged source is taken, using a gamepad of its own");
+    }
+    if (injectorPool)
+    {
+        std::unique_ptr<GamepadInjector> injector = injectorPool->acquire();
+        if (injector)
+        {
+            pooled = true;
+            return injector;
+        }
+    }
+    return device->createInjector();
+}
+
+// reads and injects one reading from the wheel
+void Wheel::poll(Clock::time_point now)
+{
+    if (lost.load(std::memory_order_relaxed) || now < retryTime)
+    {
+        return;
+    }
     OutputManager &outputManager = OutputManager::getInstance();
-    outputManager.log("Wheel active");
-    while (active.load())
+    // only this thread writes the count, so avoid a locked increment
+    pollCount.store(pollCount.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    try
     {
-        if (injector && racingWheel)
+        if (!pipeline.tick(now))
         {
-            try
-            {
-                RacingWheelReading reading = racingWheel.GetCurrentReading();
-
-                // map buttons
-                GamepadButtons buttons = GamepadButtons::None;
-                if ((reading.Buttons & RacingWheelButtons::DPadDown) ==
-                    RacingWheelButtons::DPadDown)
-                {
-                    buttons |= GamepadButtons::DPadDown;
-                }
-                if ((reading.Buttons & RacingWheelButtons::DPadUp) ==
-                    RacingWheelButtons::DPadUp)
-                {
-                    buttons |= GamepadButtons::DPadUp;
-                }
-                if ((reading.Buttons & RacingWheelButtons::DPadLeft) ==
-                    RacingWheelButtons::DPadLeft)
-                {
-                    buttons |= GamepadButtons::DPadLeft;
-                }
-                if ((reading.Buttons & RacingWheelButtons::DPadRight) ==
-                    RacingWheelButtons::DPadRight)
-                {
-                    buttons |= GamepadButtons::DPadRight;
-                }
-                if ((reading.Buttons & RacingWheelButtons::NextGear) ==
-                    RacingWheelButtons::NextGear)
-                {
-                    buttons |= GamepadButtons::RightShoulder;
-                }
-                if ((reading.Buttons & RacingWheelButtons::PreviousGear) ==
-                    RacingWheelButtons::PreviousGear)
-                {
-                    buttons |= GamepadButtons::LeftShoulder;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button1) ==
-                    RacingWheelButtons::Button1)
-                {
-                    buttons |= GamepadButtons::Menu;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button2) ==
-                    RacingWheelButtons::Button2)
-                {
-                    buttons |= GamepadButtons::View;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button3) ==
-                    RacingWheelButtons::Button3)
-                {
-                    buttons |= GamepadButtons::A;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button4) ==
-                    RacingWheelButtons::Button4)
-                {
-                    buttons |= GamepadButtons::B;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button5) ==
-                    RacingWheelButtons::Button5)
-                {
-                    buttons |= GamepadButtons::X;
-                }
-                if ((reading.Buttons & RacingWheelButtons::Button6) ==
-                    RacingWheelButtons::Button6)
-                {
-                    buttons |= GamepadButtons::Y;
-                }
-
-                // compile output
-                GamepadReading newOutput;
-                newOutput.Timestamp = packetNumber++;
-                newOutput.Buttons = buttons;
-                newOutput.LeftTrigger = reading.Brake;
-                newOutput.RightTrigger = reading.Throttle;
-                newOutput.LeftThumbstickX = reading.Wheel;
-                newOutput.LeftThumbstickY = NO_INPUT;
-                newOutput.RightThumbstickX = NO_INPUT;
-                newOutput.RightThumbstickY = NO_INPUT;
-
-                // inject output
-                this->output = newOutput;
-                InjectedInputGamepadInfo gamepadInfo(newOutput);
-                injector.InjectGamepadInput(gamepadInfo);
-            }
-            catch (const hresult_error &ex)
-            {
-                outputManager.error("Injection error: " +
-                                    to_string(ex.message()));
-                std::this_thread::sleep_for(
-                    std::chrono::milliseconds(INJECTOR_INIT_DELAY_MS));
-                continue;
-            }
-            catch (const std::exception &e)
-            {
-                outputManager.error(e.what());
-                break;
-            }
-            catch (...)
-            {
-                outputManager.error("Unknown error while injecting input");
-                break;
-            }
+            lost.store(true);
         }
-        else
+    }
+    catch (const DeviceError &e)
+    {
         {
-            break;
+            std::lock_guard<std::mutex> lock(errorsMutex);
+            errorCounts[e.code()]++;
         }
+        outputManager.error(std::string("Injection error: ") + e.what());
+        // back off without blocking other wheels on the same thread
+        retryTime = now + RETRY_DELAY;
+    }
+    catch (const std::exception &e)
+    {
+        outputManager.error(e.what());
+        lost.store(true);
+    }
+    catch (...)
+    {
+        outputManager.error("Unknown error while injecting input");
+        lost.store(true);
+    }
+}
 
-        // sleep until next scan
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(REFRESH_DELAY_MS));
+// returns if the wheel's output has not changed for the idle timeout
+bool Wheel::idle(Clock::time_point now)
+{
+    if (settings.idleTimeout.count() <= 0)
+    {
+        return false;
+    }
+    bool idle = lost.load(std::memory_order_relaxed) ||
+                now - pipeline.lastChange() >= settings.idleTimeout;
+    if (wasIdle && !idle)
+    {
+        wakeupCount.store(wakeupCount.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_relaxed);
     }
+    wasIdle = idle;
+    return idle;
 }
 
-// returns the racingWheel associated with a wheel object
-RacingWheel Wheel::getRacingWheel()
+// returns the device associated with a wheel object
+const WheelDevice &Wheel::getDevice()
 {
-    return this->racingWheel;
+    return *device;
+}
+
+// returns the number labelling the wheel in metrics
+int Wheel::getNumber() const
+{
+    return number;
 }
 
 // returns the most recent output of a wheel object
-GamepadReading Wheel::getOutput()
+GamepadState Wheel::getOutput()
+{
+    return pipeline.getOutput();
+}
+
+// returns the number of readings injected
+uint64_t Wheel::injected()
+{
+    return pipeline.injected();
+}
+
+// returns the number of unchanged readings which were not injected
+uint64_t Wheel::skipped()
 {
-    return this->output;
+    return pipeline.skipped();
 }
 
-// starts thread scanning for wheels
+// returns the number of times the wheel's output changed after idling
+uint64_t Wheel::wakeups()
+{
+    return wakeupCount.load(std::memory_order_relaxed);
+}
+
+// returns the pacer timing the wheel's poll loop, or null if stopped
+const Pacer *Wheel::getPacer()
+{
+    return pacer.load();
+}
+
+// returns the values shown in telemetry, without allocating
+WheelTelemetry Wheel::getTelemetry()
+{
+    WheelTelemetry telemetry;
+    telemetry.output = pipeline.getOutput();
+    telemetry.injected = pipeline.injected();
+    telemetry.skipped = pipeline.skipped();
+    telemetry.recording = recording.get();
+    for (int i = 0; i < InputPipeline::NUM_STAGES; i++)
+    {
+        telemetry.latency[i] =
+            &pipeline.getLatency(static_cast<InputPipeline::Stage>(i));
+    }
+    telemetry.pacer = getPacer();
+    return telemetry;
+}
+
+// initialises the wheel in the background and then begins polling it
 void Wheel::start()
 {
     OutputManager &outputManager = OutputManager::getInstance();
     // prevent re-running thread if already started
-    if (active.load())
+    if (active.load() || pending.load())
     {
         return;
     }
     outputManager.log("Wheel connected");
+    if (pooled)
+    {
+        pending.store(true);
+        initialised(InitPipeline::Result{true, "", {}});
+        return;
+    }
 
-    // initialise wheel
+    // initialise wheel, on its own thread unless sharing a pipeline
     outputManager.log("Initialising wheel...");
+    if (!initPipeline)
+    {
+        ownInitPipeline =
+            std::make_unique<InitPipeline>(1, settings.initTimeout);
+        initPipeline = ownInitPipeline.get();
+    }
+    if (ownInitPipeline)
+    {
+        ownInitPipeline->start();
+    }
+    pending.store(true);
+    initPipeline->submit(*injector, [this](const InitPipeline::Result &result)
+                         { initialised(result); });
+}
+
+// begins polling the wheel once its injector is initialised
+void Wheel::initialised(const InitPipeline::Result &result)
+{
+    OutputManager &outputManager = OutputManager::getInstance();
+    if (!result.initialised)
+    {
+        // the wheel manager retries on its next scan
+        outputManager.error(result.error);
+        pending.store(false);
+        return;
+    }
+    // record every reading polled from the wheel
+    if (recorder && recorder->recording())
+    {
+        recording = recorder->attach();
+        pipeline.setRecorder(recording.get());
+    }
+    // share every reading with other processes, unless every slot is taken
+    if (publisher && publisher->publishing())
+    {
+        publishing = publisher->attach();
+        if (publishing)
+        {
+            pipeline.setPublisher(&publishing->sample);
+        }
+    }
+    if (settings.forceFeedback.enabled())
+    {
+        startMotor();
+    }
+    active.store(true);
+    pending.store(false);
+    pacer.store(executor->add(this));
+    if (ownExecutor)
+    {
+        ownExecutor->start();
+    }
+    if (pooled)
+    {
+        outputManager.log("Wheel active, using a pooled injector");
+        return;
+    }
+    auto ms = [&](InitPipeline::Stage stage)
+    {
+        return result.stageNs[static_cast<int>(stage)] / 1e6;
+    };
+    char message[128];
+    std::snprintf(message, sizeof(message),
+                  "Wheel active, initialised in %.1f ms (create %.1f, "
+                  "settle %.1f, initialise %.1f)",
+                  ms(InitPipeline::Stage::Total),
+                  ms(InitPipeline::Stage::Create),
+                  ms(InitPipeline::Stage::Settle),
+                  ms(InitPipeline::Stage::Initialise));
+    outputManager.log(message);
+}
+
+// prepares the wheel's motor for force feedback, if it has one
+void Wheel::startMotor()
+{
+    OutputManager &outputManager = OutputManager::getInstance();
     try
     {
-        injector = InputInjector::TryCreate();
-        if (!injector)
+        motor = device->createMotor();
+        if (motor && motor->initialise())
         {
-            outputManager.error("Failed to create injector");
-            stop();
+            pipeline.setMotor(motor.get());
+            outputManager.log("Force feedback active");
             return;
         }
-        // give injector time to stabilise
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(INJECTOR_INIT_DELAY_MS));
-        injector.InitializeGamepadInjection();
+        outputManager.log("Wheel has no force feedback motor");
     }
-    catch (const hresult_error &ex)
+    catch (const DeviceError &e)
     {
-        outputManager.error("Failed to initialise injector: " +
-                            to_string(ex.message()));
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(INJECTOR_INIT_DELAY_MS));
-        return;
+        outputManager.error(std::string("Force feedback error: ") + e.what());
+    }
+    // poll the wheel without force feedback
+    if (motor)
+    {
+        motor->release();
+        motor.reset();
     }
-    // run wheel
-    active.store(true);
-    thread = std::thread(&Wheel::run, this);
 }
 
-// sets flag to stop thread
+// stops polling the wheel
 void Wheel::stop()
 {
+    // abandon initialisation, waiting out any stage in progress
+    if (initPipeline)
+    {
+        initPipeline->cancel(*injector);
+    }
+    if (ownInitPipeline)
+    {
+        ownInitPipeline->stop();
+    }
+    if (pending.exchange(false) && !pooled)
+    {
+        injector->release();
+    }
     bool expected = true;
     if (active.compare_exchange_strong(expected, false))
     {
         OutputManager::getInstance().log("Wheel disconnected");
-        if (thread.joinable())
+        executor->remove(this);
+        pacer.store(nullptr);
+        if (ownExecutor)
         {
-            thread.join();
+            ownExecutor->stop();
         }
-        if (injector)
+        if (recording)
+        {
+            pipeline.setRecorder(nullptr);
+            recorder->detach(recording);
+        }
+        if (publishing)
+        {
+            pipeline.setPublisher(nullptr);
+            publisher->detach(publishing);
+            publishing = nullptr;
+        }
+        if (motor)
+        {
+            pipeline.setMotor(nullptr);
+            motor->release();
+            motor.reset();
+        }
+        // pooled injectors stay initialised until the wheel is destroyed
+        if (!pooled)
         {
-            injector.UninitializeGamepadInjection();
+            injector->release();
         }
-        injector = nullptr;
+        if (settings.latencySummary)
+        {
+            printLatency();
+        }
+    }
+}
+
+// prints the time taken by each stage of polling
+void Wheel::printLatency()
+{
+    OutputManager &outputManager = OutputManager::getInstance();
+    outputManager.log("Latency p50/p99/p99.9/max:");
+    for (int i = 0; i < InputPipeline::NUM_STAGES; i++)
+    {
+        auto stage = static_cast<InputPipeline::Stage>(i);
+        const Histogram &latency = pipeline.getLatency(stage);
+        outputManager.log(std::string("  ") + InputPipeline::stageName(stage) +
+                          ": " + latency.describe() + " (" +
+                          std::to_string(latency.count()) + " samples)");
+    }
+    if (settings.idleTimeout.count() > 0)
+    {
+        // a change while idle is read at most one idle period late
+        char message[96];
+        std::snprintf(message, sizeof(message),
+                      "  Idle: %llu wakeups, each read up to %.1f ms late",
+                      static_cast<unsigned long long>(wakeups()),
+                      1000.0 / settings.idleRateHz);
+        outputManager.log(message);
     }
 }
 
-// returns if the wheel manager is running
+// asks the wheel's own thread to stop without waiting for it, so several
+// wheels can stop at once before each is stopped by stop
+void Wheel::requestStop()
+{
+    if (ownExecutor)
+    {
+        ownExecutor->requestStop();
+    }
+}
+
+// returns if the wheel is being polled
 bool Wheel::running()
 {
-    return active.load();
+    return active.load() && !lost.load();
+}
+
+// returns if the wheel is waiting for its injector to initialise
+bool Wheel::initialising()
+{
+    return pending.load();
+}
+
+// returns the number of failed injections by error code
+std::map<int32_t, uint64_t> Wheel::getErrors()
+{
+    std::lock_guard<std::mutex> lock(errorsMutex);
+    return errorCounts;
+}
+
+// returns the number of deadlines the wheel's own thread skipped, or 0 if it
+// shares a thread
+uint64_t Wheel::overruns()
+{
+    return ownExecutor ? ownExecutor->missed() : 0;
+}
+
+// returns the cpu time used by the wheel's own thread in seconds, or -1 if it
+// shares a thread
+double Wheel::threadCpuSeconds()
+{
+    return ownExecutor ? ownExecutor->cpuSeconds(0) : -1;
+}
+
+// returns polls per second since the previous call, must only be called from
+// one thread
+double Wheel::measurePollRate(Clock::time_point now)
+{
+    uint64_t polls = pollCount.load(std::memory_order_relaxed);
+    double seconds = std::chrono::duration<double>(now - rateTime).count();
+    double rate = seconds > 0 ? (polls - ratePolls) / seconds : 0;
+    ratePolls = polls;
+    rateTime = now;
+    return rate;
 }
@@ -26,48 +26,135 @@
 #define WHEEL_H
 
 #include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <thread>
-#include <windows.h>
-#include <winrt/Windows.Gaming.Input.h>
-#include <winrt/Windows.UI.Input.Preview.Injection.h>
 
+#include "clock.h"
+#include "device_backend.h"
+#include "gamepad_merger.h"
+#include "init_pipeline.h"
+#include "injector_pool.h"
+#include "input_pipeline.h"
 #include "output_manager.h"
+#include "pacer.h"
+#include "poll_executor.h"
+#include "pollable.h"
+#include "session_recorder.h"
+#include "state_publisher.h"
+#include "telemetry_view.h"
+#include "wheel_motor.h"
+#include "wheel_settings.h"
 
-using namespace winrt;
-using namespace Windows::Gaming::Input;
-using namespace Windows::UI::Input::Preview::Injection;
-
-class Wheel
+class Wheel : public Pollable
 {
   private:
-    static const DWORD REFRESH_DELAY_MS;
-    static const double NO_INPUT;
-    static const DWORD INJECTOR_INIT_DELAY_MS;
+    static const std::chrono::milliseconds RETRY_DELAY;
 
-    RacingWheel racingWheel;
+    std::shared_ptr<WheelDevice> device;
+    // labels the wheel in metrics, never reused while running
+    const int number;
+    WheelSettings settings;
     std::atomic<bool> active;
-    std::thread thread;
-    InputInjector injector;
-    uint64_t packetNumber;
-    GamepadReading output;
+    std::atomic<bool> pending;
+    std::atomic<bool> lost;
+    InjectorPool *injectorPool;
+    GamepadMerger *merger;
+    // the injector was initialised by the pool and is returned to it
+    bool pooled;
+    std::unique_ptr<ReadingSource> source;
+    std::unique_ptr<GamepadInjector> injector;
+    InputPipeline pipeline;
+    PollExecutor *executor;
+    std::unique_ptr<PollExecutor> ownExecutor;
+    // the pacer of the worker polling the wheel, kept so readers never wait
+    // on the worker's tick
+    std::atomic<const Pacer *> pacer;
+    InitPipeline *initPipeline;
+    std::unique_ptr<InitPipeline> ownInitPipeline;
+    Clock::time_point retryTime;
+    SessionRecorder *recorder;
+    std::shared_ptr<RecordChannel> recording;
+    StatePublisher *publisher;
+    SharedWheelSlot *publishing;
+    std::unique_ptr<WheelMotor> motor;
+    std::atomic<uint64_t> pollCount;
+    // the wheel was idle at the previous poll, only used by the poll thread
+    bool wasIdle;
+    std::atomic<uint64_t> wakeupCount;
+    // polls counted when the poll rate was last measured
+    uint64_t ratePolls;
+    Clock::time_point rateTime;
+    // guards errorCounts, which are only updated when injection fails
+    std::mutex errorsMutex;
+    std::map<int32_t, uint64_t> errorCounts;
 
-    // reads and injects input from wheel
-    void run();
+    // feeds the merger, or takes an initialised injector from the pool, or
+    // creates one
+    std::unique_ptr<GamepadInjector> createInjector();
+    // begins polling the wheel once its injector is initialised
+    void initialised(const InitPipeline::Result &result);
+    // prepares the wheel's motor for force feedback, if it has one
+    void startMotor();
+    // prints the time taken by each stage of polling
+    void printLatency();
 
   public:
-    Wheel(RacingWheel racingWheel);
+    // creates a wheel polled by sharedExecutor and initialised by
+    // sharedInitPipeline, or by threads of its own if null, which feeds
+    // merger or takes an injector from injectorPool, is recorded by recorder
+    // and is published by publisher unless null, labelled by number
+    Wheel(std::shared_ptr<WheelDevice> device, const WheelSettings &settings,
+          PollExecutor *sharedExecutor, InitPipeline *sharedInitPipeline,
+          InjectorPool *injectorPool, GamepadMerger *merger,
+          SessionRecorder *recorder, StatePublisher *publisher,
+          int number = 0);
     ~Wheel();
-    // returns the racingWheel associated with a wheel object
-    RacingWheel getRacingWheel();
+    // reads and injects one reading from the wheel
+    void poll(Clock::time_point now) override;
+    // returns if the wheel's output has not changed for the idle timeout
+    bool idle(Clock::time_point now) override;
+    // returns the device associated with a wheel object
+    const WheelDevice &getDevice();
+    // returns the number labelling the wheel in metrics
+    int getNumber() const;
     // returns the most recent output of a wheel object
-    GamepadReading getOutput();
-    // starts thread scanning for wheels
+    GamepadState getOutput();
+    // returns the number of readings injected
+    uint64_t injected();
+    // returns the number of unchanged readings which were not injected
+    uint64_t skipped();
+    // returns the number of times the wheel's output changed after idling
+    uint64_t wakeups();
+    // returns the pacer timing the wheel's poll loop, or null if stopped
+    const Pacer *getPacer();
+    // returns the values shown in telemetry, without allocating
+    WheelTelemetry getTelemetry();
+    // initialises the wheel in the background and then begins polling it
     void start();
-    // sets flag to stop thread
+    // stops polling the wheel
     void stop();
-    // returns if the wheel manager is running
+    // asks the wheel's own thread to stop without waiting for it, so several
+    // wheels can stop at once before each is stopped by stop
+    void requestStop();
+    // returns if the wheel is being polled
     bool running();
+    // returns if the wheel is waiting for its injector to initialise
+    bool initialising();
+    // returns the number of failed injections by error code
+    std::map<int32_t, uint64_t> getErrors();
+    // returns the number of deadlines the wheel's own thread skipped, or 0
+    // if it shares a thread
+    uint64_t overruns();
+    // returns the cpu time used by the wheel's own thread in seconds, or -1
+    // if it shares a thread
+    double threadCpuSeconds();
+    // returns polls per second since the previous call, must only be called
+    // from one thread
+    double measurePollRate(Clock::time_point now);
 };
 
 #endif
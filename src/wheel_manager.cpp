@@ -24,13 +24,49 @@
 
 #include "wheel_manager.h"
 
-const DWORD WheelManager::REFRESH_DELAY_MS = 1000;
-const DWORD WheelManager::TELEMETRY_DELAY_MS = 100;
-const int WheelManager::MAX_WHEELS = 8;
+#include <algorithm>
+#include <cstdio>
+
 const int WheelManager::WHEEL_NOT_FOUND = -1;
+// connections are reported as they happen, so scanning only catches events
+// the backend missed
+const std::chrono::milliseconds WheelManager::RECONCILE_INTERVAL{10000};
 
-WheelManager::WheelManager() : active{false}, wheels{}, telemetryActive{false}
+WheelManager::WheelManager(DeviceBackend &backend,
+                           const WheelSettings &settings,
+                           SessionRecorder *recorder,
+                           StatePublisher *publisher,
+                           const ProfileCache *profiles)
+    : backend(backend), settings(settings), active{false}, events{},
+      wheels{}, nextWheelNumber{1}, retiredInjected{0}, retiredSkipped{0},
+      retiredOverruns{0}, retiredWakeups{0}, retiredErrors{}, executor{},
+      initPipeline{}, injectorPool{}, merger{}, recorder{recorder},
+      publisher{publisher}, profiles{profiles}, telemetryActive{false},
+      telemetryStopping{}
 {
+    // poll every wheel from a shared pool rather than a thread per wheel
+    if (settings.pollThreads > 0)
+    {
+        executor = std::make_unique<PollExecutor>(
+            SteadyClock::getInstance(), settings, settings.pollThreads);
+    }
+    // initialise wheels in parallel without holding up the scanner
+    if (settings.initThreads > 0)
+    {
+        initPipeline = std::make_unique<InitPipeline>(settings.initThreads,
+                                                      settings.initTimeout);
+    }
+    // injectors are warmed by the shared pipeline
+    if (settings.pooledInjectors > 0 && initPipeline)
+    {
+        injectorPool = std::make_unique<InjectorPool>(
+            backend, *initPipeline, settings.pooledInjectors);
+    }
+    // inject every wheel through one gamepad
+    if (settings.mergeWheels)
+    {
+        merger = std::make_unique<GamepadMerger>(backend, settings);
+    }
 }
 
 WheelManager::~WheelManager()
@@ -39,177 +75,211 @@ WheelManager::~WheelManager()
     stop();
 }
 
-// scans for racing wheels
+// handles connections and scans for racing wheels
 void WheelManager::run()
 {
+    ThreadTuning tuning;
+    tuning.apply(settings.backgroundPriority, {}, "discovery");
+    // wheels fall back to gamepads of their own if merging is unavailable
+    std::string error;
+    if (merger && !merger->start(error))
+    {
+        OutputManager::getInstance().error(error);
+    }
+    // fall back to scanning if the backend cannot report connections
+    bool subscribed = backend.subscribe(this);
+    std::chrono::steady_clock::duration reconcileInterval =
+        subscribed ? RECONCILE_INTERVAL : settings.scanInterval;
+    auto nextReconcile = std::chrono::steady_clock::now();
+    std::vector<DeviceEvent> pending;
     while (active.load())
     {
-        // get wheels
-        auto racingWheels = RacingWheel::RacingWheels();
-        // compare to each recorded wheels
-        int wheelMap[MAX_WHEELS] = {
-            WHEEL_NOT_FOUND, WHEEL_NOT_FOUND, WHEEL_NOT_FOUND, WHEEL_NOT_FOUND,
-            WHEEL_NOT_FOUND, WHEEL_NOT_FOUND, WHEEL_NOT_FOUND, WHEEL_NOT_FOUND};
-        int numWheels = wheels.size();
-        for (int i = 0; i < racingWheels.Size(); i++)
+        auto now = std::chrono::steady_clock::now();
+        if (now >= nextReconcile)
+        {
+            reconcile(backend.scan());
+            nextReconcile = now + reconcileInterval;
+        }
+        // handle connections reported since the last pass
         {
-            bool wheelFound = false;
-            for (int j = 0; j < numWheels; j++)
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            pending.swap(events);
+        }
+        for (auto &event : pending)
+        {
+            if (event.added)
             {
-                if (wheels[j]->getRacingWheel() == racingWheels.GetAt(i))
-                {
-                    wheelFound = true;
-                    wheelMap[j] = i;
-                    break;
-                }
+                addWheel(event.device);
             }
-            // handle new wheels
-            if (!wheelFound)
+            else
             {
-                wheels.push_back(
-                    std::make_unique<Wheel>(racingWheels.GetAt(i)));
-                wheels.back()->start();
+                removeWheel(findWheel(*event.device));
             }
         }
-        // handle disconnected wheels
-        for (int i = numWheels - 1; i >= 0; i--)
+        pending.clear();
+        // a lost wheel which is still connected is only found again by a scan
+        if (removeStopped())
         {
-            if (wheelMap[i] == WHEEL_NOT_FOUND || !wheels[i]->running())
-            {
-                wheels[i]->stop();
-                wheels.erase(wheels.begin() + i);
-            }
+            nextReconcile =
+                std::min(nextReconcile, now + settings.scanInterval);
         }
-        // sleep until next scan
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(REFRESH_DELAY_MS));
+        // sleep until next event, lost wheel check or scan
+        std::unique_lock<std::mutex> lock(eventsMutex);
+        eventsReady.wait_until(
+            lock, std::min(nextReconcile, now + settings.scanInterval),
+            [this] { return !events.empty() || !active.load(); });
     }
+    backend.unsubscribe();
+}
+
+// returns the index of the wheel using device, or WHEEL_NOT_FOUND
+int WheelManager::findWheel(const WheelDevice &device)
+{
+    for (int i = 0; i < wheels.size(); i++)
+    {
+        if (wheels[i]->getDevice().matches(device))
+        {
+            return i;
+        }
+    }
+    return WHEEL_NOT_FOUND;
+}
+
+// starts a wheel for device unless one is already running
+void WheelManager::addWheel(std::shared_ptr<WheelDevice> device)
+{
+    if (findWheel(*device) != WHEEL_NOT_FOUND)
+    {
+        return;
+    }
+    // tune the wheel with its model's profile, if one is cached
+    DeviceId id = device->id();
+    const CachedProfile *profile = profiles ? profiles->find(id) : nullptr;
+    std::unique_ptr<WheelSettings> tuned;
+    if (profile)
+    {
+        tuned = std::make_unique<WheelSettings>(settings);
+        ProfileCache::apply(*profile, *tuned);
+        char message[64];
+        std::snprintf(message, sizeof(message),
+                      "Using the profile for device %04x:%04x", id.vendor,
+                      id.product);
+        OutputManager::getInstance().log(message);
+    }
+    auto wheel = std::make_unique<Wheel>(std::move(device),
+                                         tuned ? *tuned : settings,
+                                         executor.get(), initPipeline.get(),
+                                         injectorPool.get(), merger.get(),
+                                         recorder, publisher,
+                                         nextWheelNumber++);
+    wheel->start();
+    std::lock_guard<std::mutex> lock(wheelsMutex);
+    wheels.push_back(std::move(wheel));
+}
+
+// stops a wheel and forgets it
+void WheelManager::removeWheel(int index)
+{
+    if (index == WHEEL_NOT_FOUND)
+    {
+        return;
+    }
+    // stop outside the lock so telemetry is not held up
+    std::unique_ptr<Wheel> &wheel = wheels[index];
+    wheel->stop();
+    std::unique_ptr<Wheel> removed;
+    {
+        std::lock_guard<std::mutex> lock(wheelsMutex);
+        retiredInjected += wheel->injected();
+        retiredSkipped += wheel->skipped();
+        retiredOverruns += wheel->overruns();
+        retiredWakeups += wheel->wakeups();
+        for (auto &error : wheel->getErrors())
+        {
+            retiredErrors[error.first] += error.second;
+        }
+        removed = std::move(wheel);
+        wheels.erase(wheels.begin() + index);
+    }
+}
+
+// starts wheels for new devices and stops wheels whose device is gone, called
+// by the scanner, so must only be called otherwise while stopped
+void WheelManager::reconcile(
+    const std::vector<std::shared_ptr<WheelDevice>> &devices)
+{
+    int numWheels = wheels.size();
+    std::vector<bool> connected(numWheels, false);
+    for (auto &device : devices)
+    {
+        int index = findWheel(*device);
+        if (index == WHEEL_NOT_FOUND)
+        {
+            addWheel(device);
+        }
+        else if (index < numWheels)
+        {
+            connected[index] = true;
+        }
+    }
+    // handle disconnected wheels
+    for (int i = numWheels - 1; i >= 0; i--)
+    {
+        if (!connected[i])
+        {
+            removeWheel(i);
+        }
+    }
+}
+
+// removes wheels which have stopped or failed to initialise, returns if any
+// were removed
+bool WheelManager::removeStopped()
+{
+    bool removed = false;
+    for (int i = wheels.size() - 1; i >= 0; i--)
+    {
+        if (!wheels[i]->running() && !wheels[i]->initialising())
+        {
+            removeWheel(i);
+            removed = true;
+        }
+    }
+    return removed;
 }
 
 // prints wheel input to console
 void WheelManager::telemetry()
 {
     OutputManager &outputManager = OutputManager::getInstance();
-    std::stringstream ss;
+    ThreadTuning tuning;
+    tuning.apply(settings.backgroundPriority, {}, "telemetry");
+    auto period =
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(1.0 / settings.telemetryRateHz));
+    auto nextFrame = std::chrono::steady_clock::now();
     while (telemetryActive.load())
     {
-        std::vector<std::string> output;
+        telemetryFrame.clear();
         // add newline before telemetry
-        output.push_back("");
+        telemetryFrame.print("%s", "");
+        // hold wheels in place while reading them
+        std::unique_lock<std::mutex> lock(wheelsMutex);
         // print telemetry for each wheel
         for (int i = 0; i < wheels.size(); i++)
         {
-            if (!wheels[i])
-            {
-                continue;
-            }
-            if (wheels[i]->running())
+            if (wheels[i] && wheels[i]->running())
             {
-                ss << "Wheel " << i + 1;
-                output.push_back(ss.str());
-                ss.str("");
-                GamepadReading reading = wheels[i]->getOutput();
-                ss << "Steering: " << std::fixed << std::setw(7)
-                   << std::showpoint << std::setprecision(2)
-                   << reading.LeftThumbstickX * 100 << "%";
-                output.push_back(ss.str());
-                ss.str("");
-                ss << "Throttle: " << std::fixed << std::setw(7)
-                   << std::showpoint << std::setprecision(2)
-                   << reading.RightTrigger * 100 << "%";
-                output.push_back(ss.str());
-                ss.str("");
-                ss << "Brake: " << std::fixed << std::setw(10) << std::showpoint
-                   << std::setprecision(2) << reading.LeftTrigger * 100 << "%";
-                output.push_back(ss.str());
-                ss.str("");
-                ss << "Buttons: " <<
-                    // lambda to parse buttons
-                    (
-                        [](GamepadButtons buttons)
-                        {
-                            std::string buttonsStr;
-                            // add each button to string
-                            if ((buttons & GamepadButtons::DPadUp) ==
-                                GamepadButtons::DPadUp)
-                            {
-                                buttonsStr += "DPadUp, ";
-                            }
-                            if ((buttons & GamepadButtons::DPadDown) ==
-                                GamepadButtons::DPadDown)
-                            {
-                                buttonsStr += "DPadDown, ";
-                            }
-                            if ((buttons & GamepadButtons::DPadLeft) ==
-                                GamepadButtons::DPadLeft)
-                            {
-                                buttonsStr += "DPadLeft, ";
-                            }
-                            if ((buttons & GamepadButtons::DPadRight) ==
-                                GamepadButtons::DPadRight)
-                            {
-                                buttonsStr += "DPadRight, ";
-                            }
-                            if ((buttons & GamepadButtons::LeftShoulder) ==
-                                GamepadButtons::LeftShoulder)
-                            {
-                                buttonsStr += "LB, ";
-                            }
-                            if ((buttons & GamepadButtons::RightShoulder) ==
-                                GamepadButtons::RightShoulder)
-                            {
-                                buttonsStr += "RB, ";
-                            }
-                            if ((buttons & GamepadButtons::Menu) ==
-                                GamepadButtons::Menu)
-                            {
-                                buttonsStr += "Menu, ";
-                            }
-                            if ((buttons & GamepadButtons::View) ==
-                                GamepadButtons::View)
-                            {
-                                buttonsStr += "View, ";
-                            }
-                            if ((buttons & GamepadButtons::A) ==
-                                GamepadButtons::A)
-                            {
-                                buttonsStr += "A, ";
-                            }
-                            if ((buttons & GamepadButtons::B) ==
-                                GamepadButtons::B)
-                            {
-                                buttonsStr += "B, ";
-                            }
-                            if ((buttons & GamepadButtons::X) ==
-                                GamepadButtons::X)
-                            {
-                                buttonsStr += "X, ";
-                            }
-                            if ((buttons & GamepadButtons::Y) ==
-                                GamepadButtons::Y)
-                            {
-                                buttonsStr += "Y, ";
-                            }
-
-                            // remove last comma
-                            if (!buttonsStr.empty())
-                            {
-                                buttonsStr.pop_back();
-                                buttonsStr.pop_back();
-                            }
-                            return buttonsStr;
-                        })(reading.Buttons);
-                output.push_back(ss.str());
-                ss.str("");
-                // add new line after each wheel
-                output.push_back("");
+                TelemetryView::addWheel(telemetryFrame, i + 1,
+                                        wheels[i]->getTelemetry());
             }
         }
-        outputManager.printTelemetry(output);
+        lock.unlock();
+        outputManager.printTelemetry(telemetryFrame);
 
-        // sleep until next reading
-        std::this_thread::sleep_for(
-            std::chrono::milliseconds(TELEMETRY_DELAY_MS));
+        // sleep until next frame, or until stopped
+        nextFrame += period;
+        telemetryStopping.waitUntil(nextFrame);
     }
     outputManager.clearTelemetry();
 }
@@ -224,6 +294,18 @@ void WheelManager::start()
     }
 
     active.store(true);
+    if (executor)
+    {
+        executor->start();
+    }
+    if (initPipeline)
+    {
+        initPipeline->start();
+    }
+    if (injectorPool)
+    {
+        injectorPool->start();
+    }
     OutputManager::getInstance().log("Scanning for wheels...");
     thread = std::thread(&WheelManager::run, this);
 }
@@ -234,19 +316,64 @@ void WheelManager::stop()
     stopTelemetry();
     if (active.load())
     {
-        active.store(false);
-        for (int i = 0; i < wheels.size(); i++)
         {
-            if (wheels[i]->running())
-            {
-                wheels[i]->stop();
-            }
+            // wake the scanner without racing its check of active
+            std::lock_guard<std::mutex> lock(eventsMutex);
+            active.store(false);
         }
+        eventsReady.notify_all();
+        // join the scanner first so it cannot modify wheels during shutdown
         if (thread.joinable())
         {
             thread.join();
         }
-        wheels.clear();
+        // take the wheels out of reach of metrics and telemetry before
+        // stopping them
+        std::vector<std::unique_ptr<Wheel>> stopping;
+        {
+            std::lock_guard<std::mutex> lock(wheelsMutex);
+            stopping.swap(wheels);
+        }
+        // wake every polling thread before joining any, so the wheels stop
+        // together rather than one period after another
+        for (std::unique_ptr<Wheel> &wheel : stopping)
+        {
+            wheel->requestStop();
+        }
+        if (executor)
+        {
+            executor->requestStop();
+        }
+        for (std::unique_ptr<Wheel> &wheel : stopping)
+        {
+            if (wheel->running())
+            {
+                wheel->stop();
+            }
+        }
+        // destroying a wheel abandons its initialisation
+        stopping.clear();
+        events.clear();
+        if (injectorPool)
+        {
+            injectorPool->stop();
+            OutputManager::getInstance().log(
+                "Injector pool: " + std::to_string(injectorPool->hits()) +
+                " hits, " + std::to_string(injectorPool->misses()) +
+                " misses");
+        }
+        if (merger)
+        {
+            merger->stop();
+        }
+        if (executor)
+        {
+            executor->stop();
+        }
+        if (initPipeline)
+        {
+            initPipeline->stop();
+        }
     }
 }
 
@@ -264,6 +391,7 @@ void WheelManager::startTelemetry()
         return;
     }
     telemetryActive.store(true);
+    telemetryStopping.reset();
     telemetryThread = std::thread(&WheelManager::telemetry, this);
 }
 
@@ -271,6 +399,7 @@ void WheelManager::startTelemetry()
 void WheelManager::stopTelemetry()
 {
     telemetryActive.store(false);
+    telemetryStopping.raise();
     if (telemetryThread.joinable())
     {
         telemetryThread.join();
@@ -282,3 +411,121 @@ void WheelManager::toggleTelemetry()
 {
     telemetryActive.load() ? stopTelemetry() : startTelemetry();
 }
+
+// returns the pool of initialised injectors, or null if not pooling
+const InjectorPool *WheelManager::getInjectorPool() const
+{
+    return injectorPool.get();
+}
+
+// returns the merger wheels are injected through, or null if not merging
+const GamepadMerger *WheelManager::getMerger() const
+{
+    return merger.get();
+}
+
+// queues a wheel to be started, called by the backend
+void WheelManager::deviceAdded(std::shared_ptr<WheelDevice> device)
+{
+    // starting a wheel can block, so leave it to the scanner thread
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.push_back(DeviceEvent{std::move(device), true});
+    }
+    eventsReady.notify_one();
+}
+
+// queues a wheel to be stopped, called by the backend
+void WheelManager::deviceRemoved(std::shared_ptr<WheelDevice> device)
+{
+    {
+        std::lock_guard<std::mutex> lock(eventsMutex);
+        events.push_back(DeviceEvent{std::move(device), false});
+    }
+    eventsReady.notify_one();
+}
+
+// writes the service's counters and gauges, must only be called from one
+// thread
+void WheelManager::writeMetrics(MetricsWriter &out)
+{
+    Clock::time_point now = SteadyClock::getInstance().now();
+    std::lock_guard<std::mutex> lock(wheelsMutex);
+    uint64_t injected = retiredInjected;
+    uint64_t skipped = retiredSkipped;
+    uint64_t overruns = retiredOverruns + (executor ? executor->missed() : 0);
+    uint64_t wakeups = retiredWakeups;
+    std::map<int32_t, uint64_t> errors = retiredErrors;
+    int connected = 0;
+    for (std::unique_ptr<Wheel> &wheel : wheels)
+    {
+        injected += wheel->injected();
+        skipped += wheel->skipped();
+        overruns += wheel->overruns();
+        wakeups += wheel->wakeups();
+        for (auto &error : wheel->getErrors())
+        {
+            errors[error.first] += error.second;
+        }
+        connected += wheel->running();
+    }
+
+    out.family("xwcs_wheels_connected", "gauge", "Wheels being polled");
+    out.sample(connected);
+    out.family("xwcs_injections_total", "counter", "Readings injected");
+    out.sample(injected);
+    out.family("xwcs_injections_skipped_total", "counter",
+               "Unchanged readings which were not injected");
+    out.sample(skipped);
+    if (merger)
+    {
+        out.family("xwcs_merged_sources", "gauge",
+                   "Wheels feeding the merged gamepad");
+        out.sample(merger->sources());
+        out.family("xwcs_merged_injections_total", "counter",
+                   "Merged readings injected");
+        out.sample(merger->injected());
+    }
+    out.family("xwcs_injection_errors_total", "counter",
+               "Failed injections by HRESULT");
+    for (auto &error : errors)
+    {
+        char code[16];
+        std::snprintf(code, sizeof(code), "0x%08X",
+                      static_cast<uint32_t>(error.first));
+        out.sample("hresult", code, error.second);
+    }
+    out.family("xwcs_loop_overruns_total", "counter",
+               "Poll deadlines skipped after overrunning");
+    out.sample(overruns);
+    out.family("xwcs_idle_wakeups_total", "counter",
+               "Input changes which returned an idle wheel to full rate");
+    out.sample(wakeups);
+    out.family("xwcs_wheel_poll_rate_hz", "gauge",
+               "Polls per second of each wheel since the last scrape");
+    for (int i = 0; i < wheels.size(); i++)
+    {
+        if (wheels[i]->running())
+        {
+            out.sample("wheel", std::to_string(wheels[i]->getNumber()),
+                       wheels[i]->measurePollRate(now));
+        }
+    }
+    out.family("xwcs_thread_cpu_seconds_total", "counter",
+               "Cpu time used by each polling thread");
+    for (size_t i = 0; executor && i < executor->size(); i++)
+    {
+        out.sample("thread", "poll_" + std::to_string(i + 1),
+                   executor->cpuSeconds(i));
+    }
+    for (int i = 0; i < wheels.size(); i++)
+    {
+        double seconds = wheels[i]->threadCpuSeconds();
+        if (wheels[i]->running() && seconds >= 0)
+        {
+            out.sample("thread",
+                       "wheel_" + std::to_string(wheels[i]->getNumber()),
+                       seconds);
+        }
+    }
+}
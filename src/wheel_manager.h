@@ -26,45 +26,107 @@
 #define WHEEL_MANAGER_H
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <iostream>
-#include <sstream>
+#include <map>
+#include <mutex>
 #include <thread>
-#include <windows.h>
-#include <winrt/Windows.Foundation.Collections.h>
-#include <winrt/Windows.Gaming.Input.h>
+#include <vector>
 
+#include "button_map.h"
+#include "device_backend.h"
+#include "gamepad_merger.h"
+#include "init_pipeline.h"
+#include "injector_pool.h"
+#include "metrics_writer.h"
 #include "output_manager.h"
+#include "poll_executor.h"
+#include "profile_cache.h"
+#include "session_recorder.h"
+#include "state_publisher.h"
+#include "telemetry_frame.h"
+#include "telemetry_view.h"
+#include "thread_tuning.h"
+#include "wake_signal.h"
 #include "wheel.h"
+#include "wheel_settings.h"
 
-using namespace winrt;
-using namespace Windows::Gaming::Input;
-
-class WheelManager
+class WheelManager : public DeviceListener
 {
   private:
-    static const DWORD REFRESH_DELAY_MS;
-    static const DWORD TELEMETRY_DELAY_MS;
-    static const int MAX_WHEELS;
     static const int WHEEL_NOT_FOUND;
+    static const std::chrono::milliseconds RECONCILE_INTERVAL;
+
+    // a connection reported by the backend
+    struct DeviceEvent
+    {
+        std::shared_ptr<WheelDevice> device;
+        bool added;
+    };
 
+    DeviceBackend &backend;
+    WheelSettings settings;
     std::atomic<bool> active;
+    // guards events, which are queued from the backend's threads
+    std::mutex eventsMutex;
+    std::condition_variable eventsReady;
+    std::vector<DeviceEvent> events;
+    // guards wheels against the scanner while other threads read them
+    std::mutex wheelsMutex;
     std::vector<std::unique_ptr<Wheel>> wheels;
+    // numbers the next wheel added, so metrics labels outlive removals
+    int nextWheelNumber;
+    // totals of removed wheels, so counters never go backwards
+    uint64_t retiredInjected;
+    uint64_t retiredSkipped;
+    uint64_t retiredOverruns;
+    uint64_t retiredWakeups;
+    std::map<int32_t, uint64_t> retiredErrors;
+    std::unique_ptr<PollExecutor> executor;
+    std::unique_ptr<InitPipeline> initPipeline;
+    std::unique_ptr<InjectorPool> injectorPool;
+    std::unique_ptr<GamepadMerger> merger;
+    SessionRecorder *recorder;
+    StatePublisher *publisher;
+    const ProfileCache *profiles;
     std::thread thread;
     std::thread telemetryThread;
     std::atomic<bool> telemetryActive;
+    // raised to wake the telemetry thread when stopping it
+    WakeSignal telemetryStopping;
+    TelemetryFrame telemetryFrame;
 
-    // scans for racing wheels
+    // handles connections and scans for racing wheels
     void run();
+    // returns the index of the wheel using device, or WHEEL_NOT_FOUND
+    int findWheel(const WheelDevice &device);
+    // starts a wheel for device unless one is already running
+    void addWheel(std::shared_ptr<WheelDevice> device);
+    // stops a wheel and forgets it
+    void removeWheel(int index);
+    // removes wheels which have stopped or failed to initialise, returns if
+    // any were removed
+    bool removeStopped();
     // prints wheel input to console
     void telemetry();
 
   public:
-    WheelManager();
+    // creates a manager of the wheels found by backend, which are recorded by
+    // recorder, published by publisher and tuned by their model's profile in
+    // profiles unless null
+    WheelManager(DeviceBackend &backend, const WheelSettings &settings,
+                 SessionRecorder *recorder, StatePublisher *publisher,
+                 const ProfileCache *profiles = nullptr);
     ~WheelManager();
     // starts thread scanning for wheels
     void start();
     // sets flag to stop thread
     void stop();
+    // starts wheels for new devices and stops wheels whose device is gone,
+    // called by the scanner, so must only be called otherwise while stopped
+    void reconcile(const std::vector<std::shared_ptr<WheelDevice>> &devices);
     // returns if the wheel manager is running
     bool running();
     // starts telemetry thread
@@ -73,6 +135,17 @@ class WheelManager
     void stopTelemetry();
     // toggles telemetry thread on/off
     void toggleTelemetry();
+    // returns the pool of initialised injectors, or null if not pooling
+    const InjectorPool *getInjectorPool() const;
+    // returns the merger wheels are injected through, or null if not merging
+    const GamepadMerger *getMerger() const;
+    // writes the service's counters and gauges, must only be called from one
+    // thread
+    void writeMetrics(MetricsWriter &out);
+    // queues a wheel to be started, called by the backend
+    void deviceAdded(std::shared_ptr<WheelDevice> device) override;
+    // queues a wheel to be stopped, called by the backend
+    void deviceRemoved(std::shared_ptr<WheelDevice> device) override;
 };
 
 #endif
@@ -0,0 +1,41 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wheel_motor.h                                                              *
+ *                                                                            *
+ * Interface to the force feedback motor of a wheel                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef WHEEL_MOTOR_H
+#define WHEEL_MOTOR_H
+
+class WheelMotor
+{
+  public:
+    virtual ~WheelMotor() = default;
+    // prepares the motor, returns false if it cannot be driven
+    virtual bool initialise() = 0;
+    // sets the force on the wheel, from -1 turning it fully left to 1
+    // turning it fully right
+    virtual void setForce(double force) = 0;
+    // removes any force and releases the motor
+    virtual void release() = 0;
+};
+
+#endif
@@ -0,0 +1,99 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * wheel_settings.h                                                           *
+ *                                                                            *
+ * Options controlling how wheel input is processed                           *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef WHEEL_SETTINGS_H
+#define WHEEL_SETTINGS_H
+
+#include <chrono>
+#include <vector>
+
+#include "axis_curve.h"
+#include "axis_filter.h"
+#include "button_map.h"
+#include "force_feedback.h"
+#include "merge_rules.h"
+#include "pacer.h"
+#include "thread_tuning.h"
+
+struct WheelSettings
+{
+    // only inject readings which differ from the last injected reading
+    bool skipUnchanged = false;
+    // longest time between injections while skipping unchanged readings
+    std::chrono::milliseconds keepalive{100};
+    // polling rate in Hz, one of 125, 250, 500 or 1000
+    int pollRateHz = 1000;
+    // how the poll loop waits for each deadline, busy waiting is opt in as it
+    // costs cpu time
+    WaitMode waitMode = WaitMode::Sleep;
+    // time before each deadline spent busy waiting in hybrid mode
+    std::chrono::microseconds spinWindow{200};
+    // time without a change in input before a wheel is polled at the idle
+    // rate, or 0 to always poll at the full rate
+    std::chrono::milliseconds idleTimeout{0};
+    // polling rate in Hz once every wheel on a thread is idle, which bounds
+    // the latency added to the first change after idling
+    int idleRateHz = 125;
+    // priority of threads polling wheels
+    ThreadPriority pollPriority = ThreadPriority::Normal;
+    // cores threads polling wheels run on, or empty for any core
+    std::vector<int> pollCores;
+    // priority of the discovery and telemetry threads
+    ThreadPriority backgroundPriority = ThreadPriority::Normal;
+    // time between scans for connected and disconnected wheels
+    std::chrono::milliseconds scanInterval{1000};
+    // threads shared by all wheels, or 0 for one thread per wheel
+    int pollThreads = 0;
+    // threads initialising injectors, or 0 for one thread per wheel
+    int initThreads = 4;
+    // longest a single stage of initialising an injector may take before it
+    // fails, checked once the stage returns, so stopping may wait longer
+    std::chrono::milliseconds initTimeout{2000};
+    // injectors kept initialised ahead of time for new wheels
+    int pooledInjectors = 0;
+    // time the read, map and inject stages of a sample of ticks
+    bool timeStages = true;
+    // print the stage timings of each wheel when it stops
+    bool latencySummary = false;
+    // telemetry frames drawn per second
+    int telemetryRateHz = 10;
+    // mapping of wheel buttons to gamepad buttons
+    ButtonMap buttonMap;
+    // smoothing of each axis before its response curve
+    AxisFilter steeringFilter;
+    AxisFilter throttleFilter;
+    AxisFilter brakeFilter;
+    // response curves of each axis
+    AxisCurve steeringCurve{AxisCurve::Range::Bipolar};
+    AxisCurve throttleCurve{AxisCurve::Range::Unipolar};
+    AxisCurve brakeCurve{AxisCurve::Range::Unipolar};
+    // effects driven through the wheel's motor
+    ForceFeedbackSettings forceFeedback;
+    // inject every wheel through one shared gamepad
+    bool mergeWheels = false;
+    // which wheel each part of the shared gamepad is taken from
+    MergeRules mergeRules;
+};
+
+#endif
@@ -0,0 +1,381 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * winrt_backend.cpp                                                          *
+ *                                                                            *
+ * Windows.Gaming.Input wheel source and InputInjector gamepad                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#include "winrt_backend.h"
+
+// portable button flags are passed straight through to WinRT
+static_assert(static_cast<uint32_t>(RacingWheelButtons::Button16) ==
+                  WheelButtons::Button16,
+              "WheelButtons must match RacingWheelButtons");
+static_assert(static_cast<uint32_t>(GamepadButtons::RightThumbstick) ==
+                  PadButtons::RightThumbstick,
+              "PadButtons must match GamepadButtons");
+
+// give injector time to stabilise before initialising
+const std::chrono::milliseconds WinrtGamepadInjector::INJECTOR_SETTLE_TIME{
+    500};
+
+RacingWheelSource::RacingWheelSource(RacingWheel racingWheel)
+    : racingWheel(racingWheel)
+{
+}
+
+// reads the current state of the wheel, returns false if unavailable
+bool RacingWheelSource::read(WheelState &state)
+{
+    if (!racingWheel)
+    {
+        return false;
+    }
+    RacingWheelReading reading;
+    try
+    {
+        reading = racingWheel.GetCurrentReading();
+    }
+    catch (const hresult_error &ex)
+    {
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+    state.timestamp = reading.Timestamp;
+    state.buttons = static_cast<uint32_t>(reading.Buttons);
+    state.wheel = reading.Wheel;
+    state.throttle = reading.Throttle;
+    state.brake = reading.Brake;
+    state.clutch = reading.Clutch;
+    state.handbrake = reading.Handbrake;
+    state.patternShifterGear = reading.PatternShifterGear;
+    return true;
+}
+
+WinrtGamepadInjector::WinrtGamepadInjector() : injector{nullptr}
+{
+}
+
+WinrtGamepadInjector::~WinrtGamepadInjector()
+{
+    release();
+}
+
+// creates the injector, returns false if injection is unavailable
+bool WinrtGamepadInjector::create()
+{
+    try
+    {
+        injector = InputInjector::TryCreate();
+    }
+    catch (const hresult_error &ex)
+    {
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+    return static_cast<bool>(injector);
+}
+
+// returns the time the injector needs before gamepad injection
+std::chrono::milliseconds WinrtGamepadInjector::settleTime() const
+{
+    return INJECTOR_SETTLE_TIME;
+}
+
+// initialises gamepad injection
+bool WinrtGamepadInjector::initialise()
+{
+    if (!injector)
+    {
+        return false;
+    }
+    try
+    {
+        injector.InitializeGamepadInjection();
+    }
+    catch (const hresult_error &ex)
+    {
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+    return true;
+}
+
+// injects a gamepad reading
+void WinrtGamepadInjector::inject(const GamepadState &state)
+{
+    if (!injector)
+    {
+        return;
+    }
+    GamepadReading reading;
+    reading.Timestamp = state.timestamp;
+    reading.Buttons = static_cast<GamepadButtons>(state.buttons);
+    reading.LeftTrigger = state.leftTrigger;
+    reading.RightTrigger = state.rightTrigger;
+    reading.LeftThumbstickX = state.leftThumbstickX;
+    reading.LeftThumbstickY = state.leftThumbstickY;
+    reading.RightThumbstickX = state.rightThumbstickX;
+    reading.RightThumbstickY = state.rightThumbstickY;
+    try
+    {
+        InjectedInputGamepadInfo gamepadInfo(reading);
+        injector.InjectGamepadInput(gamepadInfo);
+    }
+    catch (const hresult_error &ex)
+    {
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+}
+
+// uninitialises gamepad injection
+void WinrtGamepadInjector::release()
+{
+    if (injector)
+    {
+        injector.UninitializeGamepadInjection();
+    }
+    injector = nullptr;
+}
+
+// long enough to outlast any gap between polls, short enough that the
+// wheel goes slack soon after the service stops
+const std::chrono::milliseconds RacingWheelMotor::FORCE_DURATION{500};
+
+RacingWheelMotor::RacingWheelMotor(RacingWheel racingWheel)
+    : racingWheel(racingWheel), motor{nullptr}, effect{}, thread{}
+{
+}
+
+RacingWheelMotor::~RacingWheelMotor()
+{
+    release();
+}
+
+// loads a constant force effect onto the wheel's motor, returns false if the
+// wheel has no motor
+bool RacingWheelMotor::initialise()
+{
+    using namespace Windows::Gaming::Input::ForceFeedback;
+    try
+    {
+        motor = racingWheel.WheelMotor();
+        if (!motor)
+        {
+            return false;
+        }
+        effect.SetParameters(Windows::Foundation::Numerics::float3{0, 0, 0},
+                             FORCE_DURATION);
+        if (motor.LoadEffectAsync(effect).get() !=
+            ForceFeedbackLoadEffectResult::Succeeded)
+        {
+            motor = nullptr;
+            return false;
+        }
+        effect.Start();
+    }
+    catch (const hresult_error &ex)
+    {
+        motor = nullptr;
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+    thread = std::make_unique<MotorThread>([this](double force)
+                                           { apply(force); });
+    return true;
+}
+
+// sets the strength of the constant force, on the motor thread
+void RacingWheelMotor::apply(double force)
+{
+    try
+    {
+        // the effect's x axis turns the wheel, restarting it renews the
+        // duration
+        effect.SetParameters(
+            Windows::Foundation::Numerics::float3{static_cast<float>(force),
+                                                  0, 0},
+            FORCE_DURATION);
+        effect.Start();
+    }
+    catch (const hresult_error &ex)
+    {
+        throw DeviceError(to_string(ex.message()), ex.code());
+    }
+}
+
+// passes the strength of the constant force to the motor thread
+void RacingWheelMotor::setForce(double force)
+{
+    if (thread)
+    {
+        thread->setForce(force);
+    }
+}
+
+// stops and unloads the effect
+void RacingWheelMotor::release()
+{
+    // the motor thread must not restart the effect while it is unloaded
+    thread.reset();
+    if (!motor)
+    {
+        return;
+    }
+    try
+    {
+        effect.Stop();
+        motor.TryUnloadEffectAsync(effect).get();
+    }
+    catch (const hresult_error &)
+    {
+        // the wheel may already have been disconnected
+    }
+    motor = nullptr;
+}
+
+RacingWheelDevice::RacingWheelDevice(RacingWheel racingWheel)
+    : racingWheel(racingWheel)
+{
+}
+
+// returns if both devices refer to the same connected wheel
+bool RacingWheelDevice::matches(const WheelDevice &other) const
+{
+    auto device = dynamic_cast<const RacingWheelDevice *>(&other);
+    return device && device->racingWheel == racingWheel;
+}
+
+// returns the vendor and product of the wheel's hardware
+DeviceId RacingWheelDevice::id() const
+{
+    RawGameController controller =
+        RawGameController::FromGameController(racingWheel);
+    if (!controller)
+    {
+        return DeviceId{};
+    }
+    return DeviceId{controller.HardwareVendorId(),
+                    controller.HardwareProductId()};
+}
+
+// opens the wheel for reading
+std::unique_ptr<ReadingSource> RacingWheelDevice::createSource()
+{
+    return std::make_unique<RacingWheelSource>(racingWheel);
+}
+
+// creates the injector the wheel's readings are sent to
+std::unique_ptr<GamepadInjector> RacingWheelDevice::createInjector()
+{
+    return std::make_unique<WinrtGamepadInjector>();
+}
+
+// creates the wheel's force feedback motor
+std::unique_ptr<WheelMotor> RacingWheelDevice::createMotor()
+{
+    return std::make_unique<RacingWheelMotor>(racingWheel);
+}
+
+// returns the racing wheels currently connected
+std::vector<std::shared_ptr<WheelDevice>> WinrtBackend::scan()
+{
+    std::vector<std::shared_ptr<WheelDevice>> devices;
+    auto racingWheels = RacingWheel::RacingWheels();
+    for (uint32_t i = 0; i < racingWheels.Size(); i++)
+    {
+        devices.push_back(
+            std::make_shared<RacingWheelDevice>(racingWheels.GetAt(i)));
+    }
+    return devices;
+}
+
+WinrtBackend::WinrtBackend()
+    : listener{nullptr}, addedToken{}, removedToken{}
+{
+}
+
+WinrtBackend::~WinrtBackend()
+{
+    unsubscribe();
+}
+
+// creates an injector, which any racing wheel can use
+std::unique_ptr<GamepadInjector> WinrtBackend::createInjector()
+{
+    return std::make_unique<WinrtGamepadInjector>();
+}
+
+// reports racing wheels as they are connected and disconnected
+bool WinrtBackend::subscribe(DeviceListener *listener)
+{
+    unsubscribe();
+    {
+        std::lock_guard<std::mutex> lock(listenerMutex);
+        this->listener = listener;
+    }
+    // events are raised on the thread pool, so only hand the wheel over
+    try
+    {
+        addedToken = RacingWheel::RacingWheelAdded(
+            [this](Windows::Foundation::IInspectable const &,
+                   RacingWheel const &racingWheel)
+            {
+                std::lock_guard<std::mutex> lock(listenerMutex);
+                if (this->listener)
+                {
+                    this->listener->deviceAdded(
+                        std::make_shared<RacingWheelDevice>(racingWheel));
+                }
+            });
+        removedToken = RacingWheel::RacingWheelRemoved(
+            [this](Windows::Foundation::IInspectable const &,
+                   RacingWheel const &racingWheel)
+            {
+                std::lock_guard<std::mutex> lock(listenerMutex);
+                if (this->listener)
+                {
+                    this->listener->deviceRemoved(
+                        std::make_shared<RacingWheelDevice>(racingWheel));
+                }
+            });
+    }
+    catch (const hresult_error &)
+    {
+        // fall back to scanning
+        unsubscribe();
+        return false;
+    }
+    return true;
+}
+
+// stops reporting racing wheels
+void WinrtBackend::unsubscribe()
+{
+    if (addedToken.value)
+    {
+        RacingWheel::RacingWheelAdded(addedToken);
+        addedToken = {};
+    }
+    if (removedToken.value)
+    {
+        RacingWheel::RacingWheelRemoved(removedToken);
+        removedToken = {};
+    }
+    // wait for any event already being handled
+    std::lock_guard<std::mutex> lock(listenerMutex);
+    listener = nullptr;
+}
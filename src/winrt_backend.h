@@ -0,0 +1,150 @@
+// Xbox Wheel Compatibility Service
+// Copyright (C) 2025 Joshua Linehan
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+
+/******************************************************************************
+ * winrt_backend.h                                                            *
+ *                                                                            *
+ * Windows.Gaming.Input wheel source and InputInjector gamepad                *
+ *                                                                            *
+ * Author: Joshua Linehan                                                     *
+ ******************************************************************************/
+
+#ifndef WINRT_BACKEND_H
+#define WINRT_BACKEND_H
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <windows.h>
+#include <winrt/Windows.Foundation.Collections.h>
+#include <winrt/Windows.Foundation.Numerics.h>
+#include <winrt/Windows.Gaming.Input.ForceFeedback.h>
+#include <winrt/Windows.Gaming.Input.h>
+#include <winrt/Windows.UI.Input.Preview.Injection.h>
+
+#include "device_backend.h"
+#include "gamepad_injector.h"
+#include "motor_thread.h"
+#include "reading_source.h"
+#include "wheel_motor.h"
+
+using namespace winrt;
+using namespace Windows::Gaming::Input;
+using namespace Windows::UI::Input::Preview::Injection;
+
+class RacingWheelSource : public ReadingSource
+{
+  private:
+    RacingWheel racingWheel;
+
+  public:
+    RacingWheelSource(RacingWheel racingWheel);
+    // reads the current state of the wheel, returns false if unavailable
+    bool read(WheelState &state) override;
+};
+
+class WinrtGamepadInjector : public GamepadInjector
+{
+  private:
+    static const std::chrono::milliseconds INJECTOR_SETTLE_TIME;
+
+    InputInjector injector;
+
+  public:
+    WinrtGamepadInjector();
+    ~WinrtGamepadInjector();
+    // creates the injector, returns false if injection is unavailable
+    bool create() override;
+    // returns the time the injector needs before gamepad injection
+    std::chrono::milliseconds settleTime() const override;
+    // initialises gamepad injection
+    bool initialise() override;
+    // injects a gamepad reading
+    void inject(const GamepadState &state) override;
+    // uninitialises gamepad injection
+    void release() override;
+};
+
+class RacingWheelMotor : public WheelMotor
+{
+  private:
+    // how long each force lasts if the wheel stops being polled
+    static const std::chrono::milliseconds FORCE_DURATION;
+
+    RacingWheel racingWheel;
+    Windows::Gaming::Input::ForceFeedback::ForceFeedbackMotor motor;
+    Windows::Gaming::Input::ForceFeedback::ConstantForceEffect effect;
+    // sets each force, as restarting the effect is a blocking driver call
+    std::unique_ptr<MotorThread> thread;
+
+    // sets the strength of the constant force, on the motor thread
+    void apply(double force);
+
+  public:
+    RacingWheelMotor(RacingWheel racingWheel);
+    ~RacingWheelMotor();
+    // loads a constant force effect onto the wheel's motor, returns false
+    // if the wheel has no motor
+    bool initialise() override;
+    // passes the strength of the constant force to the motor thread
+    void setForce(double force) override;
+    // stops and unloads the effect
+    void release() override;
+};
+
+class RacingWheelDevice : public WheelDevice
+{
+  private:
+    RacingWheel racingWheel;
+
+  public:
+    RacingWheelDevice(RacingWheel racingWheel);
+    // returns if both devices refer to the same connected wheel
+    bool matches(const WheelDevice &other) const override;
+    // returns the vendor and product of the wheel's hardware
+    DeviceId id() const override;
+    // opens the wheel for reading
+    std::unique_ptr<ReadingSource> createSource() override;
+    // creates the injector the wheel's readings are sent to
+    std::unique_ptr<GamepadInjector> createInjector() override;
+    // creates the wheel's force feedback motor
+    std::unique_ptr<WheelMotor> createMotor() override;
+};
+
+class WinrtBackend : public DeviceBackend
+{
+  private:
+    // guards listener against events raised while unsubscribing
+    std::mutex listenerMutex;
+    DeviceListener *listener;
+    event_token addedToken;
+    event_token removedToken;
+
+  public:
+    WinrtBackend();
+    ~WinrtBackend();
+    // returns the racing wheels currently connected
+    std::vector<std::shared_ptr<WheelDevice>> scan() override;
+    // creates an injector, which any racing wheel can use
+    std::unique_ptr<GamepadInjector> createInjector() override;
+    // reports racing wheels as they are connected and disconnected
+    bool subscribe(DeviceListener *listener) override;
+    // stops reporting racing wheels
+    void unsubscribe() override;
+};
+
+#endif